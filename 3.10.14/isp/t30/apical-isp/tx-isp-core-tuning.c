@@ -1,5 +1,6 @@
 #include <linux/videodev2.h>
 #include <linux/delay.h>
+#include <linux/poll.h>
 #include "apical_command_api.h"
 #include <apical-isp/apical_isp_config.h>
 #include <apical-isp/apical_math.h>
@@ -992,527 +993,436 @@ static inline int apical_isp_day_or_night_g_ctrl(image_tuning_vdrv_t *tuning, st
 }
 
 
-static int apical_isp_day_or_night_s_ctrl_internal(image_tuning_vdrv_t *tuning)
+/* the calibrations that differ between the day and night bin sections */
+#define DN_CALIB(name) { CALIBRATION_##name, _CALIBRATION_##name }
+static const struct {
+	unsigned int id;
+	unsigned int index;
+} apical_isp_dn_calibrations[] = {
+	/* dynamic calibration */
+	DN_CALIB(NP_LUT_MEAN),
+	DN_CALIB(EVTOLUX_PROBABILITY_ENABLE),
+	DN_CALIB(AE_EXPOSURE_AVG_COEF),
+	DN_CALIB(IRIDIX_AVG_COEF),
+	DN_CALIB(AF_MIN_TABLE),
+	DN_CALIB(AF_MAX_TABLE),
+	DN_CALIB(AF_WINDOW_RESIZE_TABLE),
+	DN_CALIB(EXP_RATIO_TABLE),
+	DN_CALIB(CCM_ONE_GAIN_THRESHOLD),
+	DN_CALIB(FLASH_RG),
+	DN_CALIB(FLASH_BG),
+	DN_CALIB(IRIDIX_STRENGTH_MAXIMUM_LINEAR),
+	DN_CALIB(IRIDIX_STRENGTH_MAXIMUM_WDR),
+	DN_CALIB(IRIDIX_BLACK_PRC),
+	DN_CALIB(IRIDIX_GAIN_MAX),
+	DN_CALIB(IRIDIX_MIN_MAX_STR),
+	DN_CALIB(IRIDIX_EV_LIM_FULL_STR),
+	DN_CALIB(IRIDIX_EV_LIM_NO_STR_LINEAR),
+	DN_CALIB(IRIDIX_EV_LIM_NO_STR_FS_HDR),
+	DN_CALIB(AE_CORRECTION_LINEAR),
+	DN_CALIB(AE_CORRECTION_FS_HDR),
+	DN_CALIB(AE_EXPOSURE_CORRECTION),
+	DN_CALIB(SINTER_STRENGTH_LINEAR),
+	DN_CALIB(SINTER_STRENGTH_FS_HDR),
+	DN_CALIB(SINTER_STRENGTH1_LINEAR),
+	DN_CALIB(SINTER_STRENGTH1_FS_HDR),
+	DN_CALIB(SINTER_THRESH1_LINEAR),
+	DN_CALIB(SINTER_THRESH1_FS_HDR),
+	DN_CALIB(SINTER_THRESH4_LINEAR),
+	DN_CALIB(SINTER_THRESH4_FS_HDR),
+	DN_CALIB(SHARP_ALT_D_LINEAR),
+	DN_CALIB(SHARP_ALT_D_FS_HDR),
+	DN_CALIB(SHARP_ALT_UD_LINEAR),
+	DN_CALIB(SHARP_ALT_UD_FS_HDR),
+	DN_CALIB(SHARPEN_FR_LINEAR),
+	DN_CALIB(SHARPEN_FR_WDR),
+	DN_CALIB(SHARPEN_DS1_LINEAR),
+	DN_CALIB(SHARPEN_DS1_WDR),
+	DN_CALIB(DEMOSAIC_NP_OFFSET_LINEAR),
+	DN_CALIB(DEMOSAIC_NP_OFFSET_FS_HDR),
+	DN_CALIB(MESH_SHADING_STRENGTH),
+	DN_CALIB(SATURATION_STRENGTH_LINEAR),
+	DN_CALIB(TEMPER_STRENGTH),
+	DN_CALIB(STITCHING_ERROR_THRESH),
+	DN_CALIB(DP_SLOPE_LINEAR),
+	DN_CALIB(DP_SLOPE_FS_HDR),
+	DN_CALIB(DP_THRESHOLD_LINEAR),
+	DN_CALIB(DP_THRESHOLD_FS_HDR),
+	DN_CALIB(AE_BALANCED_LINEAR),
+	DN_CALIB(AE_BALANCED_WDR),
+	DN_CALIB(IRIDIX_STRENGTH_TABLE),
+	DN_CALIB(RGB2YUV_CONVERSION),
+	/* static parameter */
+	DN_CALIB(EVTOLUX_EV_LUT_LINEAR),
+	DN_CALIB(EVTOLUX_EV_LUT_FS_HDR),
+	DN_CALIB(EVTOLUX_LUX_LUT),
+	DN_CALIB(SHADING_LS_A_R_LINEAR),
+	DN_CALIB(SHADING_LS_A_G_LINEAR),
+	DN_CALIB(SHADING_LS_A_B_LINEAR),
+	DN_CALIB(SHADING_LS_TL84_R_LINEAR),
+	DN_CALIB(SHADING_LS_TL84_G_LINEAR),
+	DN_CALIB(SHADING_LS_TL84_B_LINEAR),
+	DN_CALIB(SHADING_LS_D65_R_LINEAR),
+	DN_CALIB(SHADING_LS_D65_G_LINEAR),
+	DN_CALIB(SHADING_LS_D65_B_LINEAR),
+	DN_CALIB(SHADING_LS_A_R_WDR),
+	DN_CALIB(SHADING_LS_A_G_WDR),
+	DN_CALIB(SHADING_LS_A_B_WDR),
+	DN_CALIB(SHADING_LS_TL84_R_WDR),
+	DN_CALIB(SHADING_LS_TL84_G_WDR),
+	DN_CALIB(SHADING_LS_TL84_B_WDR),
+	DN_CALIB(SHADING_LS_D65_R_WDR),
+	DN_CALIB(SHADING_LS_D65_G_WDR),
+	DN_CALIB(SHADING_LS_D65_B_WDR),
+	DN_CALIB(NOISE_PROFILE_LINEAR),
+	DN_CALIB(DEMOSAIC_LINEAR),
+	DN_CALIB(NOISE_PROFILE_FS_HDR),
+	DN_CALIB(DEMOSAIC_FS_HDR),
+	DN_CALIB(GAMMA_FE_0_FS_HDR),
+	DN_CALIB(GAMMA_FE_1_FS_HDR),
+	DN_CALIB(BLACK_LEVEL_R_LINEAR),
+	DN_CALIB(BLACK_LEVEL_GR_LINEAR),
+	DN_CALIB(BLACK_LEVEL_GB_LINEAR),
+	DN_CALIB(BLACK_LEVEL_B_LINEAR),
+	DN_CALIB(BLACK_LEVEL_R_FS_HDR),
+	DN_CALIB(BLACK_LEVEL_GR_FS_HDR),
+	DN_CALIB(BLACK_LEVEL_GB_FS_HDR),
+	DN_CALIB(BLACK_LEVEL_B_FS_HDR),
+	DN_CALIB(GAMMA_LINEAR),
+	DN_CALIB(GAMMA_FS_HDR),
+	DN_CALIB(IRIDIX_RGB2REC709),
+	DN_CALIB(IRIDIX_REC709TORGB),
+	DN_CALIB(IRIDIX_ASYMMETRY),
+	DN_CALIB(DEFECT_PIXELS),
+};
+#undef DN_CALIB
+
+static inline uint16_t apical_isp_dn_lut_second(LookupTable *lut)
+{
+	return *((uint16_t *)(lut->ptr) + 1);
+}
+
+static inline uint16_t apical_isp_dn_lut_last(LookupTable *lut)
+{
+	return *((uint16_t *)(lut->ptr) + lut->rows * lut->cols - 1);
+}
+
+/*
+ * Resolve everything a switch to @mode needs from the bin file, so that
+ * the switch itself is a plain walk over the image from interrupt context.
+ */
+static int apical_isp_day_or_night_prepare_image(image_tuning_vdrv_t *tuning, int mode)
 {
 	struct tx_isp_subdev *sd = tuning->parent;
 	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
 	TXispPrivParamManage *param = core->param;
-	struct image_tuning_ctrls *ctrls = &(tuning->ctrls);
+	struct isp_core_dn_image *image = &tuning->dn.image[mode];
+	LookupTable **table = NULL;
+	LookupTable *lut = NULL;
+	int i;
+
+	BUILD_BUG_ON(ARRAY_SIZE(apical_isp_dn_calibrations) > ISP_CORE_DN_CALIB_MAX);
+	image->ready = 0;
+	if (!param || !param->isp_param[mode].calibrations || !param->customer)
+		return -ENOENT;
+	table = param->isp_param[mode].calibrations;
+
+	for (i = 0; i < ARRAY_SIZE(apical_isp_dn_calibrations); i++) {
+		lut = table[apical_isp_dn_calibrations[i].index];
+		if (!lut || !lut->ptr) {
+			ISP_ERROR("The calibration %d of %s mode is missing!\n",
+				  apical_isp_dn_calibrations[i].index, mode ? "night" : "day");
+			return -ENOENT;
+		}
+		image->calib[i].id = apical_isp_dn_calibrations[i].id;
+		image->calib[i].ptr = lut->ptr;
+		image->calib[i].size = lut->rows * lut->cols * lut->width;
+	}
+	image->calib_num = i;
+	image->customer = &param->customer[mode];
+
+	if (mode == TX_ISP_PRIV_PARAM_DAY_MODE) {
+		image->clip_min_uv = 0;
+		image->clip_max_uv = 1023;
+	} else {
+		image->clip_min_uv = 512;
+		image->clip_max_uv = 512;
+	}
+
+	image->sinter_min[0] = apical_isp_dn_lut_second(table[_CALIBRATION_SINTER_STRENGTH_LINEAR]);
+	image->sinter_max[0] = apical_isp_dn_lut_last(table[_CALIBRATION_SINTER_STRENGTH_LINEAR]);
+	image->sharp_d_max[0] = apical_isp_dn_lut_second(table[_CALIBRATION_SHARP_ALT_D_LINEAR]);
+	image->sharp_d_min[0] = apical_isp_dn_lut_last(table[_CALIBRATION_SHARP_ALT_D_LINEAR]);
+	image->sharp_ud_max[0] = apical_isp_dn_lut_second(table[_CALIBRATION_SHARP_ALT_UD_LINEAR]);
+	image->sharp_ud_min[0] = apical_isp_dn_lut_last(table[_CALIBRATION_SHARP_ALT_UD_LINEAR]);
+	image->iridix_max[0] = *(uint8_t *)(table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->ptr);
+
+	image->sinter_min[1] = apical_isp_dn_lut_second(table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]);
+	image->sinter_max[1] = apical_isp_dn_lut_last(table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]);
+	image->sharp_d_max[1] = apical_isp_dn_lut_second(table[_CALIBRATION_SHARP_ALT_D_FS_HDR]);
+	image->sharp_d_min[1] = apical_isp_dn_lut_last(table[_CALIBRATION_SHARP_ALT_D_FS_HDR]);
+	image->sharp_ud_max[1] = apical_isp_dn_lut_second(table[_CALIBRATION_SHARP_ALT_UD_FS_HDR]);
+	image->sharp_ud_min[1] = apical_isp_dn_lut_last(table[_CALIBRATION_SHARP_ALT_UD_FS_HDR]);
+	image->iridix_max[1] = *(uint8_t *)(table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->ptr);
+
+	image->temper_min = apical_isp_dn_lut_second(table[_CALIBRATION_TEMPER_STRENGTH]);
+	image->temper_max = apical_isp_dn_lut_last(table[_CALIBRATION_TEMPER_STRENGTH]);
+	image->iridix_min = *(uint8_t *)(table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->ptr);
+
+	image->ready = 1;
+	return ISP_SUCCESS;
+}
+
+static int apical_isp_day_or_night_prepare(image_tuning_vdrv_t *tuning)
+{
+	unsigned long flags = 0;
 	int ret = ISP_SUCCESS;
-	LookupTable** table = NULL;
+	int mode;
+
+	spin_lock_irqsave(&tuning->slock, flags);
+	for (mode = TX_ISP_PRIV_PARAM_DAY_MODE; mode < TX_ISP_PRIV_PARAM_BUTT_MODE; mode++) {
+		if (apical_isp_day_or_night_prepare_image(tuning, mode))
+			ret = -ENOENT;
+	}
+	spin_unlock_irqrestore(&tuning->slock, flags);
+
+	if (ret)
+		ISP_WRANING("The day/night images are incomplete, the switch will be refused!\n");
+	return ret;
+}
+
+/* called with the switch flag about to be raised, the ISR applies it */
+static void apical_isp_day_or_night_request(image_tuning_vdrv_t *tuning)
+{
+	struct tx_isp_subdev *sd = tuning->parent;
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
+
+	tuning->dn.req_frame = core->frame_sequeue;
+	tuning->dn.req_time = private_sched_clock();
+	core->isp_daynight_switch = 1;
+}
+
+static int apical_isp_day_or_night_s_ctrl_internal(image_tuning_vdrv_t *tuning)
+{
+	struct tx_isp_subdev *sd = tuning->parent;
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
+	struct image_tuning_ctrls *ctrls = &(tuning->ctrls);
+	struct isp_core_dn_switch *dn_switch = &tuning->dn;
+	struct isp_core_dn_image *image = NULL;
 	TXispPrivCustomerParamer *customer = NULL;
+	unsigned long long start = private_sched_clock();
+	unsigned long long now = 0;
 	unsigned int tmp_top = 0;
 	apical_api_control_t api;
 	unsigned int reason = 0;
 	unsigned int status = 0;
+	int ret = ISP_SUCCESS;
+	int wdr = 0;
+	int i;
 
 	ISP_CORE_MODE_DN_E dn = ctrls->daynight;
-	if(!param){
+	image = &dn_switch->image[dn == ISP_CORE_RUNING_MODE_DAY_MODE ?
+				  TX_ISP_PRIV_PARAM_DAY_MODE : TX_ISP_PRIV_PARAM_NIGHT_MODE];
+	spin_lock(&tuning->slock);
+	if(!image->ready){
+		spin_unlock(&tuning->slock);
 		ISP_ERROR("Can't get the parameters of isp tuning!\n");
 		return -ENOENT;
 	}
-	{
-		tmp_top = APICAL_READ_32(0x40);
-		if(dn == ISP_CORE_RUNING_MODE_DAY_MODE){
-#if TX_ISP_EXIST_FR_CHANNEL
-			apical_isp_fr_cs_conv_clip_min_uv_write(0);
-			apical_isp_fr_cs_conv_clip_max_uv_write(1023);
-#endif
-			apical_isp_ds1_cs_conv_clip_min_uv_write(0);
-			apical_isp_ds1_cs_conv_clip_max_uv_write(1023);
-#if TX_ISP_EXIST_DS2_CHANNEL
-			apical_isp_ds2_cs_conv_clip_min_uv_write(0);
-			apical_isp_ds2_cs_conv_clip_max_uv_write(1023);
-#endif
-			table = param->isp_param[TX_ISP_PRIV_PARAM_DAY_MODE].calibrations;
-			customer = &param->customer[TX_ISP_PRIV_PARAM_DAY_MODE];
-			/* tmp_top |= param->customer[TX_ISP_PRIV_PARAM_NIGHT_MODE].top; */
-		}else{
+	customer = image->customer;
+
 #if TX_ISP_EXIST_FR_CHANNEL
-			apical_isp_fr_cs_conv_clip_min_uv_write(512);
-			apical_isp_fr_cs_conv_clip_max_uv_write(512);
+	apical_isp_fr_cs_conv_clip_min_uv_write(image->clip_min_uv);
+	apical_isp_fr_cs_conv_clip_max_uv_write(image->clip_max_uv);
 #endif
-			apical_isp_ds1_cs_conv_clip_min_uv_write(512);
-			apical_isp_ds1_cs_conv_clip_max_uv_write(512);
+	apical_isp_ds1_cs_conv_clip_min_uv_write(image->clip_min_uv);
+	apical_isp_ds1_cs_conv_clip_max_uv_write(image->clip_max_uv);
 #if TX_ISP_EXIST_DS2_CHANNEL
-			apical_isp_ds2_cs_conv_clip_min_uv_write(512);
-			apical_isp_ds2_cs_conv_clip_max_uv_write(512);
+	apical_isp_ds2_cs_conv_clip_min_uv_write(image->clip_min_uv);
+	apical_isp_ds2_cs_conv_clip_max_uv_write(image->clip_max_uv);
 #endif
-			table = param->isp_param[TX_ISP_PRIV_PARAM_NIGHT_MODE].calibrations;
-			customer = &param->customer[TX_ISP_PRIV_PARAM_NIGHT_MODE];
-			/* tmp_top |= param->customer[TX_ISP_PRIV_PARAM_DAY_MODE].top; */
-		}
-		if(table && customer){
-			tmp_top = (tmp_top | 0x0c02da6c) & (~(customer->top));
-			if(TX_ISP_EXIST_FR_CHANNEL == 0)
-				tmp_top |= 0x00fc0000;
-			/* dynamic calibration */
-			apical_api_calibration(CALIBRATION_NP_LUT_MEAN,COMMAND_SET, table[_CALIBRATION_NP_LUT_MEAN]->ptr,
-					       table[_CALIBRATION_NP_LUT_MEAN]->rows * table[_CALIBRATION_NP_LUT_MEAN]->cols
-					       * table[_CALIBRATION_NP_LUT_MEAN]->width, &ret);
-			apical_api_calibration(CALIBRATION_EVTOLUX_PROBABILITY_ENABLE,COMMAND_SET, table[ _CALIBRATION_EVTOLUX_PROBABILITY_ENABLE]->ptr,
-					       table[ _CALIBRATION_EVTOLUX_PROBABILITY_ENABLE]->rows * table[ _CALIBRATION_EVTOLUX_PROBABILITY_ENABLE]->cols
-					       * table[_CALIBRATION_EVTOLUX_PROBABILITY_ENABLE]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_EXPOSURE_AVG_COEF,COMMAND_SET, table[ _CALIBRATION_AE_EXPOSURE_AVG_COEF]->ptr,
-					       table[ _CALIBRATION_AE_EXPOSURE_AVG_COEF]->rows * table[ _CALIBRATION_AE_EXPOSURE_AVG_COEF]->cols
-					       * table[ _CALIBRATION_AE_EXPOSURE_AVG_COEF]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_AVG_COEF,COMMAND_SET, table[_CALIBRATION_IRIDIX_AVG_COEF]->ptr,
-					       table[_CALIBRATION_IRIDIX_AVG_COEF]->rows * table[_CALIBRATION_IRIDIX_AVG_COEF]->cols
-					       * table[_CALIBRATION_IRIDIX_AVG_COEF]->width, &ret);
-			apical_api_calibration(CALIBRATION_AF_MIN_TABLE,COMMAND_SET, table[_CALIBRATION_AF_MIN_TABLE]->ptr,
-					       table[_CALIBRATION_AF_MIN_TABLE]->rows * table[_CALIBRATION_AF_MIN_TABLE]->cols
-					       * table[_CALIBRATION_AF_MIN_TABLE]->width, &ret);
-			apical_api_calibration(CALIBRATION_AF_MAX_TABLE,COMMAND_SET, table[_CALIBRATION_AF_MAX_TABLE]->ptr,
-					       table[_CALIBRATION_AF_MAX_TABLE]->rows * table[_CALIBRATION_AF_MAX_TABLE]->cols
-					       * table[_CALIBRATION_AF_MAX_TABLE]->width, &ret);
-			apical_api_calibration(CALIBRATION_AF_WINDOW_RESIZE_TABLE,COMMAND_SET, table[_CALIBRATION_AF_WINDOW_RESIZE_TABLE]->ptr,
-					       table[_CALIBRATION_AF_WINDOW_RESIZE_TABLE]->rows * table[_CALIBRATION_AF_WINDOW_RESIZE_TABLE]->cols
-					       * table[_CALIBRATION_AF_WINDOW_RESIZE_TABLE]->width, &ret);
-			apical_api_calibration(CALIBRATION_EXP_RATIO_TABLE,COMMAND_SET, table[_CALIBRATION_EXP_RATIO_TABLE]->ptr,
-					       table[_CALIBRATION_EXP_RATIO_TABLE]->rows * table[_CALIBRATION_EXP_RATIO_TABLE]->cols
-					       * table[_CALIBRATION_EXP_RATIO_TABLE]->width, &ret);
-			apical_api_calibration(CALIBRATION_CCM_ONE_GAIN_THRESHOLD,COMMAND_SET, table[_CALIBRATION_CCM_ONE_GAIN_THRESHOLD]->ptr,
-					       table[_CALIBRATION_CCM_ONE_GAIN_THRESHOLD]->rows * table[_CALIBRATION_CCM_ONE_GAIN_THRESHOLD]->cols
-					       * table[_CALIBRATION_CCM_ONE_GAIN_THRESHOLD]->width, &ret);
-			apical_api_calibration(CALIBRATION_FLASH_RG,COMMAND_SET, table[_CALIBRATION_FLASH_RG]->ptr,
-					       table[_CALIBRATION_FLASH_RG]->rows * table[_CALIBRATION_FLASH_RG]->cols
-					       * table[_CALIBRATION_FLASH_RG]->width, &ret);
-			apical_api_calibration(CALIBRATION_FLASH_BG,COMMAND_SET, table[_CALIBRATION_FLASH_BG]->ptr,
-					       table[_CALIBRATION_FLASH_BG]->rows * table[_CALIBRATION_FLASH_BG]->cols
-					       * table[_CALIBRATION_FLASH_BG]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR,COMMAND_SET, table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->ptr,
-					       table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->rows * table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->cols
-					       * table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR,COMMAND_SET, table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->ptr,
-					       table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->rows * table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->cols
-					       * table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_BLACK_PRC,COMMAND_SET, table[_CALIBRATION_IRIDIX_BLACK_PRC]->ptr,
-					       table[_CALIBRATION_IRIDIX_BLACK_PRC]->rows * table[_CALIBRATION_IRIDIX_BLACK_PRC]->cols
-					       * table[_CALIBRATION_IRIDIX_BLACK_PRC]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_GAIN_MAX,COMMAND_SET, table[_CALIBRATION_IRIDIX_GAIN_MAX]->ptr,
-					       table[_CALIBRATION_IRIDIX_GAIN_MAX]->rows * table[_CALIBRATION_IRIDIX_GAIN_MAX]->cols
-					       * table[_CALIBRATION_IRIDIX_GAIN_MAX]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_MIN_MAX_STR,COMMAND_SET, table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->ptr,
-					       table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->rows * table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->cols
-					       * table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_EV_LIM_FULL_STR,COMMAND_SET, table[_CALIBRATION_IRIDIX_EV_LIM_FULL_STR]->ptr,
-					       table[_CALIBRATION_IRIDIX_EV_LIM_FULL_STR]->rows * table[_CALIBRATION_IRIDIX_EV_LIM_FULL_STR]->cols
-					       * table[_CALIBRATION_IRIDIX_EV_LIM_FULL_STR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_EV_LIM_NO_STR_LINEAR,COMMAND_SET, table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_LINEAR]->ptr,
-					       table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_LINEAR]->rows * table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_LINEAR]->cols
-					       * table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_EV_LIM_NO_STR_FS_HDR,COMMAND_SET, table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_FS_HDR]->ptr,
-					       table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_FS_HDR]->rows * table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_FS_HDR]->cols
-					       * table[_CALIBRATION_IRIDIX_EV_LIM_NO_STR_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_CORRECTION_LINEAR,COMMAND_SET, table[_CALIBRATION_AE_CORRECTION_LINEAR]->ptr,
-					       table[_CALIBRATION_AE_CORRECTION_LINEAR]->rows * table[_CALIBRATION_AE_CORRECTION_LINEAR]->cols
-					       * table[_CALIBRATION_AE_CORRECTION_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_CORRECTION_FS_HDR,COMMAND_SET, table[_CALIBRATION_AE_CORRECTION_FS_HDR]->ptr,
-					       table[_CALIBRATION_AE_CORRECTION_FS_HDR]->rows * table[_CALIBRATION_AE_CORRECTION_FS_HDR]->cols
-					       * table[_CALIBRATION_AE_CORRECTION_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_EXPOSURE_CORRECTION,COMMAND_SET, table[_CALIBRATION_AE_EXPOSURE_CORRECTION]->ptr,
-					       table[_CALIBRATION_AE_EXPOSURE_CORRECTION]->rows * table[_CALIBRATION_AE_EXPOSURE_CORRECTION]->cols
-					       * table[_CALIBRATION_AE_EXPOSURE_CORRECTION]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_STRENGTH_LINEAR,COMMAND_SET, table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->ptr,
-					       table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->rows * table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->cols
-					       * table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->width, &ret);
-
-			apical_api_calibration(CALIBRATION_SINTER_STRENGTH_FS_HDR,COMMAND_SET, table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]->ptr,
-					       table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]->rows * table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]->cols
-					       * table[_CALIBRATION_SINTER_STRENGTH_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_STRENGTH1_LINEAR,COMMAND_SET, table[_CALIBRATION_SINTER_STRENGTH1_LINEAR]->ptr,
-					       table[_CALIBRATION_SINTER_STRENGTH1_LINEAR]->rows * table[_CALIBRATION_SINTER_STRENGTH1_LINEAR]->cols
-					       * table[_CALIBRATION_SINTER_STRENGTH1_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_STRENGTH1_FS_HDR,COMMAND_SET, table[_CALIBRATION_SINTER_STRENGTH1_FS_HDR]->ptr,
-					       table[_CALIBRATION_SINTER_STRENGTH1_FS_HDR]->rows * table[_CALIBRATION_SINTER_STRENGTH1_FS_HDR]->cols
-					       * table[_CALIBRATION_SINTER_STRENGTH1_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_THRESH1_LINEAR,COMMAND_SET, table[_CALIBRATION_SINTER_THRESH1_LINEAR]->ptr,
-					       table[_CALIBRATION_SINTER_THRESH1_LINEAR]->rows * table[_CALIBRATION_SINTER_THRESH1_LINEAR]->cols
-					       * table[_CALIBRATION_SINTER_THRESH1_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_THRESH1_FS_HDR,COMMAND_SET, table[ _CALIBRATION_SINTER_THRESH1_FS_HDR]->ptr,
-					       table[ _CALIBRATION_SINTER_THRESH1_FS_HDR]->rows * table[ _CALIBRATION_SINTER_THRESH1_FS_HDR]->cols
-					       * table[ _CALIBRATION_SINTER_THRESH1_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_THRESH4_LINEAR,COMMAND_SET, table[ _CALIBRATION_SINTER_THRESH4_LINEAR]->ptr,
-					       table[ _CALIBRATION_SINTER_THRESH4_LINEAR]->rows * table[ _CALIBRATION_SINTER_THRESH4_LINEAR]->cols
-					       * table[ _CALIBRATION_SINTER_THRESH4_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SINTER_THRESH4_FS_HDR,COMMAND_SET, table[ _CALIBRATION_SINTER_THRESH4_FS_HDR]->ptr,
-					       table[_CALIBRATION_SINTER_THRESH4_FS_HDR]->rows * table[ _CALIBRATION_SINTER_THRESH4_FS_HDR]->cols
-					       * table[_CALIBRATION_SINTER_THRESH4_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARP_ALT_D_LINEAR,COMMAND_SET, table[ _CALIBRATION_SHARP_ALT_D_LINEAR]->ptr,
-					       table[_CALIBRATION_SHARP_ALT_D_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_D_LINEAR]->cols
-					       * table[_CALIBRATION_SHARP_ALT_D_LINEAR]->width, &ret);
-
-			apical_api_calibration(CALIBRATION_SHARP_ALT_D_FS_HDR,COMMAND_SET, table[_CALIBRATION_SHARP_ALT_D_FS_HDR]->ptr,
-					       table[_CALIBRATION_SHARP_ALT_D_FS_HDR]->rows * table[_CALIBRATION_SHARP_ALT_D_FS_HDR]->cols
-					       * table[_CALIBRATION_SHARP_ALT_D_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARP_ALT_UD_LINEAR,COMMAND_SET, table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->ptr,
-					       table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->cols
-					       * table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->width, &ret);
-
-			apical_api_calibration(CALIBRATION_SHARP_ALT_UD_FS_HDR,COMMAND_SET, table[ _CALIBRATION_SHARP_ALT_UD_FS_HDR]->ptr,
-					       table[_CALIBRATION_SHARP_ALT_UD_FS_HDR]->rows * table[_CALIBRATION_SHARP_ALT_UD_FS_HDR]->cols
-					       * table[_CALIBRATION_SHARP_ALT_UD_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARPEN_FR_LINEAR,COMMAND_SET, table[ _CALIBRATION_SHARPEN_FR_LINEAR]->ptr,
-					       table[_CALIBRATION_SHARPEN_FR_LINEAR]->rows * table[_CALIBRATION_SHARPEN_FR_LINEAR]->cols
-					       * table[_CALIBRATION_SHARPEN_FR_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARPEN_FR_WDR,COMMAND_SET, table[_CALIBRATION_SHARPEN_FR_WDR]->ptr,
-					       table[ _CALIBRATION_SHARPEN_FR_WDR]->rows * table[ _CALIBRATION_SHARPEN_FR_WDR]->cols
-					       * table[ _CALIBRATION_SHARPEN_FR_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARPEN_DS1_LINEAR,COMMAND_SET, table[_CALIBRATION_SHARPEN_DS1_LINEAR]->ptr,
-					       table[_CALIBRATION_SHARPEN_DS1_LINEAR]->rows * table[_CALIBRATION_SHARPEN_DS1_LINEAR]->cols
-					       * table[_CALIBRATION_SHARPEN_DS1_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHARPEN_DS1_WDR,COMMAND_SET, table[_CALIBRATION_SHARPEN_DS1_WDR]->ptr,
-					       table[_CALIBRATION_SHARPEN_DS1_WDR]->rows * table[_CALIBRATION_SHARPEN_DS1_WDR]->cols
-					       * table[_CALIBRATION_SHARPEN_DS1_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DEMOSAIC_NP_OFFSET_LINEAR,COMMAND_SET, table[_CALIBRATION_DEMOSAIC_NP_OFFSET_LINEAR]->ptr,
-					       table[_CALIBRATION_DEMOSAIC_NP_OFFSET_LINEAR]->rows * table[_CALIBRATION_DEMOSAIC_NP_OFFSET_LINEAR]->cols
-					       * table[_CALIBRATION_DEMOSAIC_NP_OFFSET_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DEMOSAIC_NP_OFFSET_FS_HDR,COMMAND_SET, table[_CALIBRATION_DEMOSAIC_NP_OFFSET_FS_HDR]->ptr,
-					       table[_CALIBRATION_DEMOSAIC_NP_OFFSET_FS_HDR]->rows * table[_CALIBRATION_DEMOSAIC_NP_OFFSET_FS_HDR]->cols
-					       * table[_CALIBRATION_DEMOSAIC_NP_OFFSET_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_MESH_SHADING_STRENGTH,COMMAND_SET, table[_CALIBRATION_MESH_SHADING_STRENGTH]->ptr,
-					       table[_CALIBRATION_MESH_SHADING_STRENGTH]->rows * table[_CALIBRATION_MESH_SHADING_STRENGTH]->cols
-					       * table[_CALIBRATION_MESH_SHADING_STRENGTH]->width, &ret);
-			apical_api_calibration(CALIBRATION_SATURATION_STRENGTH_LINEAR,COMMAND_SET, table[_CALIBRATION_SATURATION_STRENGTH_LINEAR]->ptr,
-					       table[_CALIBRATION_SATURATION_STRENGTH_LINEAR]->rows * table[_CALIBRATION_SATURATION_STRENGTH_LINEAR]->cols
-					       * table[_CALIBRATION_SATURATION_STRENGTH_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_TEMPER_STRENGTH,COMMAND_SET, table[_CALIBRATION_TEMPER_STRENGTH]->ptr,
-					       table[_CALIBRATION_TEMPER_STRENGTH]->rows * table[_CALIBRATION_TEMPER_STRENGTH]->cols
-					       * table[_CALIBRATION_TEMPER_STRENGTH]->width, &ret);
-
-			apical_api_calibration(CALIBRATION_STITCHING_ERROR_THRESH,COMMAND_SET, table[_CALIBRATION_STITCHING_ERROR_THRESH]->ptr,
-					       table[_CALIBRATION_STITCHING_ERROR_THRESH]->rows * table[_CALIBRATION_STITCHING_ERROR_THRESH]->cols
-					       * table[_CALIBRATION_STITCHING_ERROR_THRESH]->width, &ret);
-			apical_api_calibration(CALIBRATION_DP_SLOPE_LINEAR,COMMAND_SET, table[_CALIBRATION_DP_SLOPE_LINEAR]->ptr,
-					       table[_CALIBRATION_DP_SLOPE_LINEAR]->rows * table[_CALIBRATION_DP_SLOPE_LINEAR]->cols
-					       * table[_CALIBRATION_DP_SLOPE_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DP_SLOPE_FS_HDR,COMMAND_SET, table[_CALIBRATION_DP_SLOPE_FS_HDR]->ptr,
-					       table[_CALIBRATION_DP_SLOPE_FS_HDR]->rows * table[_CALIBRATION_DP_SLOPE_FS_HDR]->cols
-					       * table[_CALIBRATION_DP_SLOPE_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DP_THRESHOLD_LINEAR,COMMAND_SET, table[_CALIBRATION_DP_THRESHOLD_LINEAR]->ptr,
-					       table[_CALIBRATION_DP_THRESHOLD_LINEAR]->rows * table[_CALIBRATION_DP_THRESHOLD_LINEAR]->cols
-					       * table[_CALIBRATION_DP_THRESHOLD_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DP_THRESHOLD_FS_HDR,COMMAND_SET, table[_CALIBRATION_DP_THRESHOLD_FS_HDR]->ptr,
-					       table[_CALIBRATION_DP_THRESHOLD_FS_HDR]->rows * table[_CALIBRATION_DP_THRESHOLD_FS_HDR]->cols
-					       * table[_CALIBRATION_DP_THRESHOLD_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_BALANCED_LINEAR,COMMAND_SET, table[_CALIBRATION_AE_BALANCED_LINEAR]->ptr,
-					       table[_CALIBRATION_AE_BALANCED_LINEAR]->rows * table[_CALIBRATION_AE_BALANCED_LINEAR]->cols
-					       * table[_CALIBRATION_AE_BALANCED_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_AE_BALANCED_WDR,COMMAND_SET, table[_CALIBRATION_AE_BALANCED_WDR]->ptr,
-					       table[_CALIBRATION_AE_BALANCED_WDR]->rows * table[_CALIBRATION_AE_BALANCED_WDR]->cols
-					       * table[_CALIBRATION_AE_BALANCED_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_STRENGTH_TABLE,COMMAND_SET, table[_CALIBRATION_IRIDIX_STRENGTH_TABLE]->ptr,
-					       table[_CALIBRATION_IRIDIX_STRENGTH_TABLE]->rows * table[_CALIBRATION_IRIDIX_STRENGTH_TABLE]->cols
-					       * table[_CALIBRATION_IRIDIX_STRENGTH_TABLE]->width, &ret);
-
-			apical_api_calibration(CALIBRATION_RGB2YUV_CONVERSION,COMMAND_SET, table[_CALIBRATION_RGB2YUV_CONVERSION]->ptr,
-					       table[_CALIBRATION_RGB2YUV_CONVERSION]->rows * table[_CALIBRATION_RGB2YUV_CONVERSION]->cols
-					       * table[_CALIBRATION_RGB2YUV_CONVERSION]->width, &ret);
-
-			/* static parameter */
-			apical_api_calibration(CALIBRATION_EVTOLUX_EV_LUT_LINEAR, COMMAND_SET, table[_CALIBRATION_EVTOLUX_EV_LUT_LINEAR]->ptr,
-					       table[_CALIBRATION_EVTOLUX_EV_LUT_LINEAR]->rows * table[_CALIBRATION_EVTOLUX_EV_LUT_LINEAR]->cols
-					       * table[_CALIBRATION_EVTOLUX_EV_LUT_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_EVTOLUX_EV_LUT_FS_HDR, COMMAND_SET, table[_CALIBRATION_EVTOLUX_EV_LUT_FS_HDR]->ptr,
-					       table[_CALIBRATION_EVTOLUX_EV_LUT_FS_HDR]->rows * table[_CALIBRATION_EVTOLUX_EV_LUT_FS_HDR]->cols
-					       * table[_CALIBRATION_EVTOLUX_EV_LUT_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_EVTOLUX_LUX_LUT, COMMAND_SET, table[_CALIBRATION_EVTOLUX_LUX_LUT]->ptr,
-					       table[_CALIBRATION_EVTOLUX_LUX_LUT]->rows * table[_CALIBRATION_EVTOLUX_LUX_LUT]->cols
-					       * table[_CALIBRATION_EVTOLUX_LUX_LUT]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_R_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_R_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_R_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_A_R_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_R_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_G_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_G_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_G_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_A_G_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_G_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_B_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_B_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_B_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_A_B_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_B_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_R_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_R_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_R_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_TL84_R_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_R_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_G_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_G_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_G_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_TL84_G_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_G_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_B_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_B_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_B_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_TL84_B_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_B_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_R_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_R_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_R_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_D65_R_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_R_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_G_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_G_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_G_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_D65_G_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_G_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_B_LINEAR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_B_LINEAR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_B_LINEAR]->rows * table[_CALIBRATION_SHADING_LS_D65_B_LINEAR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_B_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_R_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_R_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_R_WDR]->rows * table[_CALIBRATION_SHADING_LS_A_R_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_R_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_G_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_G_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_G_WDR]->rows * table[_CALIBRATION_SHADING_LS_A_G_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_G_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_A_B_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_A_B_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_A_B_WDR]->rows * table[_CALIBRATION_SHADING_LS_A_B_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_A_B_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_R_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_R_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_R_WDR]->rows * table[_CALIBRATION_SHADING_LS_TL84_R_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_R_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_G_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_G_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_G_WDR]->rows * table[_CALIBRATION_SHADING_LS_TL84_G_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_G_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_TL84_B_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_TL84_B_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_TL84_B_WDR]->rows * table[_CALIBRATION_SHADING_LS_TL84_B_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_TL84_B_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_R_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_R_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_R_WDR]->rows * table[_CALIBRATION_SHADING_LS_D65_R_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_R_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_G_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_G_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_G_WDR]->rows * table[_CALIBRATION_SHADING_LS_D65_G_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_G_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_SHADING_LS_D65_B_WDR, COMMAND_SET, table[_CALIBRATION_SHADING_LS_D65_B_WDR]->ptr,
-					       table[_CALIBRATION_SHADING_LS_D65_B_WDR]->rows * table[_CALIBRATION_SHADING_LS_D65_B_WDR]->cols
-					       * table[_CALIBRATION_SHADING_LS_D65_B_WDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_NOISE_PROFILE_LINEAR, COMMAND_SET, table[_CALIBRATION_NOISE_PROFILE_LINEAR]->ptr,
-					       table[_CALIBRATION_NOISE_PROFILE_LINEAR]->rows * table[_CALIBRATION_NOISE_PROFILE_LINEAR]->cols
-					       * table[_CALIBRATION_NOISE_PROFILE_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DEMOSAIC_LINEAR, COMMAND_SET, table[_CALIBRATION_DEMOSAIC_LINEAR]->ptr,
-					       table[_CALIBRATION_DEMOSAIC_LINEAR]->rows * table[_CALIBRATION_DEMOSAIC_LINEAR]->cols
-					       * table[_CALIBRATION_DEMOSAIC_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_NOISE_PROFILE_FS_HDR, COMMAND_SET, table[_CALIBRATION_NOISE_PROFILE_FS_HDR]->ptr,
-					       table[_CALIBRATION_NOISE_PROFILE_FS_HDR]->rows * table[_CALIBRATION_NOISE_PROFILE_FS_HDR]->cols
-					       * table[_CALIBRATION_NOISE_PROFILE_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_DEMOSAIC_FS_HDR, COMMAND_SET, table[_CALIBRATION_DEMOSAIC_FS_HDR]->ptr,
-					       table[_CALIBRATION_DEMOSAIC_FS_HDR]->rows * table[_CALIBRATION_DEMOSAIC_FS_HDR]->cols
-					       * table[_CALIBRATION_DEMOSAIC_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_GAMMA_FE_0_FS_HDR, COMMAND_SET, table[_CALIBRATION_GAMMA_FE_0_FS_HDR]->ptr,
-					       table[_CALIBRATION_GAMMA_FE_0_FS_HDR]->rows * table[_CALIBRATION_GAMMA_FE_0_FS_HDR]->cols
-					       * table[_CALIBRATION_GAMMA_FE_0_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_GAMMA_FE_1_FS_HDR, COMMAND_SET, table[_CALIBRATION_GAMMA_FE_1_FS_HDR]->ptr,
-					       table[_CALIBRATION_GAMMA_FE_1_FS_HDR]->rows * table[_CALIBRATION_GAMMA_FE_1_FS_HDR]->cols
-					       * table[_CALIBRATION_GAMMA_FE_1_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_R_LINEAR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_R_LINEAR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_R_LINEAR]->rows * table[_CALIBRATION_BLACK_LEVEL_R_LINEAR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_R_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_GR_LINEAR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_GR_LINEAR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_GR_LINEAR]->rows * table[_CALIBRATION_BLACK_LEVEL_GR_LINEAR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_GR_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_GB_LINEAR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_GB_LINEAR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_GB_LINEAR]->rows * table[_CALIBRATION_BLACK_LEVEL_GB_LINEAR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_GB_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_B_LINEAR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_B_LINEAR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_B_LINEAR]->rows * table[_CALIBRATION_BLACK_LEVEL_B_LINEAR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_B_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_R_FS_HDR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_R_FS_HDR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_R_FS_HDR]->rows * table[_CALIBRATION_BLACK_LEVEL_R_FS_HDR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_R_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_GR_FS_HDR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_GR_FS_HDR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_GR_FS_HDR]->rows * table[_CALIBRATION_BLACK_LEVEL_GR_FS_HDR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_GR_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_GB_FS_HDR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_GB_FS_HDR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_GB_FS_HDR]->rows * table[_CALIBRATION_BLACK_LEVEL_GB_FS_HDR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_GB_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_BLACK_LEVEL_B_FS_HDR, COMMAND_SET, table[_CALIBRATION_BLACK_LEVEL_B_FS_HDR]->ptr,
-					       table[_CALIBRATION_BLACK_LEVEL_B_FS_HDR]->rows * table[_CALIBRATION_BLACK_LEVEL_B_FS_HDR]->cols
-					       * table[_CALIBRATION_BLACK_LEVEL_B_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_GAMMA_LINEAR, COMMAND_SET, table[_CALIBRATION_GAMMA_LINEAR]->ptr,
-					       table[_CALIBRATION_GAMMA_LINEAR]->rows * table[_CALIBRATION_GAMMA_LINEAR]->cols
-					       * table[_CALIBRATION_GAMMA_LINEAR]->width, &ret);
-			apical_api_calibration(CALIBRATION_GAMMA_FS_HDR, COMMAND_SET, table[_CALIBRATION_GAMMA_FS_HDR]->ptr,
-					       table[_CALIBRATION_GAMMA_FS_HDR]->rows * table[_CALIBRATION_GAMMA_FS_HDR]->cols
-					       * table[_CALIBRATION_GAMMA_FS_HDR]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_RGB2REC709, COMMAND_SET, table[_CALIBRATION_IRIDIX_RGB2REC709]->ptr,
-					       table[_CALIBRATION_IRIDIX_RGB2REC709]->rows * table[_CALIBRATION_IRIDIX_RGB2REC709]->cols
-					       * table[_CALIBRATION_IRIDIX_RGB2REC709]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_REC709TORGB, COMMAND_SET, table[_CALIBRATION_IRIDIX_REC709TORGB]->ptr,
-					       table[_CALIBRATION_IRIDIX_REC709TORGB]->rows * table[_CALIBRATION_IRIDIX_REC709TORGB]->cols
-					       * table[_CALIBRATION_IRIDIX_REC709TORGB]->width, &ret);
-			apical_api_calibration(CALIBRATION_IRIDIX_ASYMMETRY, COMMAND_SET, table[_CALIBRATION_IRIDIX_ASYMMETRY]->ptr,
-					       table[_CALIBRATION_IRIDIX_ASYMMETRY]->rows * table[_CALIBRATION_IRIDIX_ASYMMETRY]->cols
-					       * table[_CALIBRATION_IRIDIX_ASYMMETRY]->width, &ret);
-			apical_api_calibration(CALIBRATION_DEFECT_PIXELS, COMMAND_SET, table[_CALIBRATION_DEFECT_PIXELS]->ptr,
-					       table[_CALIBRATION_DEFECT_PIXELS]->rows * table[_CALIBRATION_DEFECT_PIXELS]->cols
-					       * table[_CALIBRATION_DEFECT_PIXELS]->width, &ret);
-
-			/* green equalization */
-			apical_isp_raw_frontend_ge_strength_write(customer->ge_strength);
-			apical_isp_raw_frontend_ge_threshold_write(customer->ge_threshold);
-			apical_isp_raw_frontend_ge_slope_write(customer->ge_slope);
-			apical_isp_raw_frontend_ge_sens_write(customer->ge_sensitivity);
-
-			/* dpc configuration	 */
-			apical_isp_raw_frontend_dp_enable_write(customer->dp_module);
-			apical_isp_raw_frontend_hpdev_threshold_write(customer->hpdev_threshold);
-			apical_isp_raw_frontend_line_thresh_write(customer->line_threshold);
-			apical_isp_raw_frontend_hp_blend_write(customer->hp_blend);
-
-			apical_isp_demosaic_vh_slope_write(customer->dmsc_vh_slope);
-			apical_isp_demosaic_aa_slope_write(customer->dmsc_aa_slope);
-			apical_isp_demosaic_va_slope_write(customer->dmsc_va_slope);
-			apical_isp_demosaic_uu_slope_write(customer->dmsc_uu_slope);
-			apical_isp_demosaic_sat_slope_write(customer->dmsc_sat_slope);
-			apical_isp_demosaic_vh_thresh_write(customer->dmsc_vh_threshold);
-			apical_isp_demosaic_aa_thresh_write(customer->dmsc_aa_threshold);
-			apical_isp_demosaic_va_thresh_write(customer->dmsc_va_threshold);
-			apical_isp_demosaic_uu_thresh_write(customer->dmsc_uu_threshold);
-			apical_isp_demosaic_sat_thresh_write(customer->dmsc_sat_threshold);
-			apical_isp_demosaic_vh_offset_write(customer->dmsc_vh_offset);
-			apical_isp_demosaic_aa_offset_write(customer->dmsc_aa_offset);
-			apical_isp_demosaic_va_offset_write(customer->dmsc_va_offset);
-			apical_isp_demosaic_uu_offset_write(customer->dmsc_uu_offset);
-			apical_isp_demosaic_sat_offset_write(customer->dmsc_sat_offset);
-			apical_isp_demosaic_lum_thresh_write(customer->dmsc_luminance_thresh);
-			apical_isp_demosaic_np_offset_write(customer->dmsc_np_offset);
-			apical_isp_demosaic_dmsc_config_write(customer->dmsc_config);
-			apical_isp_demosaic_ac_thresh_write(customer->dmsc_ac_threshold);
-			apical_isp_demosaic_ac_slope_write(customer->dmsc_ac_slope);
-			apical_isp_demosaic_ac_offset_write(customer->dmsc_ac_offset);
-			apical_isp_demosaic_fc_slope_write(customer->dmsc_fc_slope);
-			apical_isp_demosaic_fc_alias_slope_write(customer->dmsc_fc_alias_slope);
-			apical_isp_demosaic_fc_alias_thresh_write(customer->dmsc_fc_alias_thresh);
-			apical_isp_demosaic_np_off_write(customer->dmsc_np_off);
-			apical_isp_demosaic_np_off_reflect_write(customer->dmsc_np_reflect);
-
-			apical_isp_temper_recursion_limit_write(customer->temper_recursion_limit);
-			apical_isp_frame_stitch_short_thresh_write(customer->wdr_short_thresh);
-			apical_isp_frame_stitch_long_thresh_write(customer->wdr_long_thresh);
-			apical_isp_frame_stitch_exposure_ratio_write(customer->wdr_expo_ratio_thresh);
-			apical_isp_frame_stitch_stitch_correct_write(customer->wdr_stitch_correct);
-			apical_isp_frame_stitch_stitch_error_thresh_write(customer->wdr_stitch_error_thresh);
-			apical_isp_frame_stitch_stitch_error_limit_write(customer->wdr_stitch_error_limit);
-			apical_isp_frame_stitch_black_level_out_write(customer->wdr_stitch_bl_long);
-			apical_isp_frame_stitch_black_level_short_write(customer->wdr_stitch_bl_short);
-			apical_isp_frame_stitch_black_level_long_write(customer->wdr_stitch_bl_output);
-
-			/* Max ISP Digital Gain */
-			api.type = TSYSTEM;
-			api.dir = COMMAND_SET;
-			api.value = customer->max_isp_dgain;
-			api.id = SYSTEM_MAX_ISP_DIGITAL_GAIN;
-
-			status = apical_command(api.type, api.id, api.value, api.dir, &reason);
-			if(status != ISP_SUCCESS) {
-				ISP_PRINT(ISP_WARNING_LEVEL,"Custom set max isp digital gain failure!reture value is %d,reason is %d\n",status,reason);
-			}
-
-			/* Max Sensor Analog Gain */
-			api.type = TSYSTEM;
-			api.dir = COMMAND_SET;
-			api.value = customer->max_sensor_again;
-			api.id = SYSTEM_MAX_SENSOR_ANALOG_GAIN;
-
-			status = apical_command(api.type, api.id, api.value, api.dir, &reason);
-			if(status != ISP_SUCCESS) {
-				ISP_PRINT(ISP_WARNING_LEVEL,"Custom set max isp digital gain failure!reture value is %d,reason is %d\n",status,reason);
-			}
-
-			/* modify the node */
-			api.type = TIMAGE;
-			api.dir = COMMAND_GET;
-			api.id = WDR_MODE_ID;
-			api.value = -1;
-			status = apical_command(api.type, api.id, api.value, api.dir, &reason);
-			if(status != ISP_SUCCESS) {
-				ISP_PRINT(ISP_WARNING_LEVEL,"Get WDR mode failure!reture value is %d,reason is %d\n",status,reason);
-			}
-
-			if (reason == IMAGE_WDR_MODE_LINEAR) {
-				stab.global_minimum_sinter_strength = *((uint16_t *)(table[ _CALIBRATION_SINTER_STRENGTH_LINEAR]->ptr) + 1);
-				stab.global_maximum_sinter_strength = *((uint16_t *)(table[ _CALIBRATION_SINTER_STRENGTH_LINEAR]->ptr) + table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->rows * table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->cols -1 );
-
-				stab.global_maximum_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_D_LINEAR]->ptr) + 1);
-				stab.global_minimum_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_D_LINEAR]->ptr) + table[_CALIBRATION_SHARP_ALT_D_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_D_LINEAR]->cols -1 );
-
-				stab.global_maximum_un_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_UD_LINEAR]->ptr) + 1);
-				stab.global_minimum_un_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_UD_LINEAR]->ptr) + table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->cols -1 );
+	tmp_top = (APICAL_READ_32(0x40) | 0x0c02da6c) & (~(customer->top));
+	if(TX_ISP_EXIST_FR_CHANNEL == 0)
+		tmp_top |= 0x00fc0000;
+
+	for (i = 0; i < image->calib_num; i++)
+		apical_api_calibration(image->calib[i].id, COMMAND_SET, image->calib[i].ptr,
+				       image->calib[i].size, &ret);
+
+	/* green equalization */
+	apical_isp_raw_frontend_ge_strength_write(customer->ge_strength);
+	apical_isp_raw_frontend_ge_threshold_write(customer->ge_threshold);
+	apical_isp_raw_frontend_ge_slope_write(customer->ge_slope);
+	apical_isp_raw_frontend_ge_sens_write(customer->ge_sensitivity);
+
+	/* dpc configuration	 */
+	apical_isp_raw_frontend_dp_enable_write(customer->dp_module);
+	apical_isp_raw_frontend_hpdev_threshold_write(customer->hpdev_threshold);
+	apical_isp_raw_frontend_line_thresh_write(customer->line_threshold);
+	apical_isp_raw_frontend_hp_blend_write(customer->hp_blend);
+
+	apical_isp_demosaic_vh_slope_write(customer->dmsc_vh_slope);
+	apical_isp_demosaic_aa_slope_write(customer->dmsc_aa_slope);
+	apical_isp_demosaic_va_slope_write(customer->dmsc_va_slope);
+	apical_isp_demosaic_uu_slope_write(customer->dmsc_uu_slope);
+	apical_isp_demosaic_sat_slope_write(customer->dmsc_sat_slope);
+	apical_isp_demosaic_vh_thresh_write(customer->dmsc_vh_threshold);
+	apical_isp_demosaic_aa_thresh_write(customer->dmsc_aa_threshold);
+	apical_isp_demosaic_va_thresh_write(customer->dmsc_va_threshold);
+	apical_isp_demosaic_uu_thresh_write(customer->dmsc_uu_threshold);
+	apical_isp_demosaic_sat_thresh_write(customer->dmsc_sat_threshold);
+	apical_isp_demosaic_vh_offset_write(customer->dmsc_vh_offset);
+	apical_isp_demosaic_aa_offset_write(customer->dmsc_aa_offset);
+	apical_isp_demosaic_va_offset_write(customer->dmsc_va_offset);
+	apical_isp_demosaic_uu_offset_write(customer->dmsc_uu_offset);
+	apical_isp_demosaic_sat_offset_write(customer->dmsc_sat_offset);
+	apical_isp_demosaic_lum_thresh_write(customer->dmsc_luminance_thresh);
+	apical_isp_demosaic_np_offset_write(customer->dmsc_np_offset);
+	apical_isp_demosaic_dmsc_config_write(customer->dmsc_config);
+	apical_isp_demosaic_ac_thresh_write(customer->dmsc_ac_threshold);
+	apical_isp_demosaic_ac_slope_write(customer->dmsc_ac_slope);
+	apical_isp_demosaic_ac_offset_write(customer->dmsc_ac_offset);
+	apical_isp_demosaic_fc_slope_write(customer->dmsc_fc_slope);
+	apical_isp_demosaic_fc_alias_slope_write(customer->dmsc_fc_alias_slope);
+	apical_isp_demosaic_fc_alias_thresh_write(customer->dmsc_fc_alias_thresh);
+	apical_isp_demosaic_np_off_write(customer->dmsc_np_off);
+	apical_isp_demosaic_np_off_reflect_write(customer->dmsc_np_reflect);
+
+	apical_isp_temper_recursion_limit_write(customer->temper_recursion_limit);
+	apical_isp_frame_stitch_short_thresh_write(customer->wdr_short_thresh);
+	apical_isp_frame_stitch_long_thresh_write(customer->wdr_long_thresh);
+	apical_isp_frame_stitch_exposure_ratio_write(customer->wdr_expo_ratio_thresh);
+	apical_isp_frame_stitch_stitch_correct_write(customer->wdr_stitch_correct);
+	apical_isp_frame_stitch_stitch_error_thresh_write(customer->wdr_stitch_error_thresh);
+	apical_isp_frame_stitch_stitch_error_limit_write(customer->wdr_stitch_error_limit);
+	apical_isp_frame_stitch_black_level_out_write(customer->wdr_stitch_bl_long);
+	apical_isp_frame_stitch_black_level_short_write(customer->wdr_stitch_bl_short);
+	apical_isp_frame_stitch_black_level_long_write(customer->wdr_stitch_bl_output);
+
+	/* Max ISP Digital Gain */
+	api.type = TSYSTEM;
+	api.dir = COMMAND_SET;
+	api.value = customer->max_isp_dgain;
+	api.id = SYSTEM_MAX_ISP_DIGITAL_GAIN;
 
-				stab.global_maximum_iridix_strength = *(uint8_t *)(table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_LINEAR]->ptr);
-			} else if (reason == IMAGE_WDR_MODE_FS_HDR) {
-				stab.global_minimum_sinter_strength = *((uint16_t *)(table[ _CALIBRATION_SINTER_STRENGTH_FS_HDR]->ptr) + 1);
-				stab.global_maximum_sinter_strength = *((uint16_t *)(table[ _CALIBRATION_SINTER_STRENGTH_FS_HDR]->ptr) + table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->rows * table[_CALIBRATION_SINTER_STRENGTH_LINEAR]->cols -1 );
+	status = apical_command(api.type, api.id, api.value, api.dir, &reason);
+	if(status != ISP_SUCCESS) {
+		ISP_PRINT(ISP_WARNING_LEVEL,"Custom set max isp digital gain failure!reture value is %d,reason is %d\n",status,reason);
+	}
 
-				stab.global_maximum_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_D_FS_HDR]->ptr) + 1);
-				stab.global_minimum_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_D_FS_HDR]->ptr) + table[_CALIBRATION_SHARP_ALT_D_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_D_LINEAR]->cols -1 );
+	/* Max Sensor Analog Gain */
+	api.type = TSYSTEM;
+	api.dir = COMMAND_SET;
+	api.value = customer->max_sensor_again;
+	api.id = SYSTEM_MAX_SENSOR_ANALOG_GAIN;
 
-				stab.global_maximum_un_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_UD_FS_HDR]->ptr) + 1);
-				stab.global_minimum_un_directional_sharpening = *((uint16_t *)(table[ _CALIBRATION_SHARP_ALT_UD_FS_HDR]->ptr) + table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->rows * table[_CALIBRATION_SHARP_ALT_UD_LINEAR]->cols -1 );
+	status = apical_command(api.type, api.id, api.value, api.dir, &reason);
+	if(status != ISP_SUCCESS) {
+		ISP_PRINT(ISP_WARNING_LEVEL,"Custom set max isp digital gain failure!reture value is %d,reason is %d\n",status,reason);
+	}
 
-				stab.global_maximum_iridix_strength = *(uint8_t *)(table[_CALIBRATION_IRIDIX_STRENGTH_MAXIMUM_WDR]->ptr);
-			}
-			stab.global_minimum_temper_strength = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + 1);
-			stab.global_maximum_temper_strength = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + table[_CALIBRATION_TEMPER_STRENGTH]->rows * table[_CALIBRATION_TEMPER_STRENGTH]->cols -1 );
-			ctrls->temper_max = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + table[_CALIBRATION_TEMPER_STRENGTH]->rows * table[_CALIBRATION_TEMPER_STRENGTH]->cols -1 );;
-			ctrls->temper_min = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + 1);
-			stab.global_minimum_iridix_strength = *(uint8_t *)(table[_CALIBRATION_IRIDIX_MIN_MAX_STR]->ptr);
-
-			APICAL_WRITE_32(0x40, tmp_top);
-			/* if it is T20,the FR is corresponding to DS2 in bin file. */
-			if (customer->top & (1 << 19)){
+	/* modify the node */
+	api.type = TIMAGE;
+	api.dir = COMMAND_GET;
+	api.id = WDR_MODE_ID;
+	api.value = -1;
+	status = apical_command(api.type, api.id, api.value, api.dir, &reason);
+	if(status != ISP_SUCCESS) {
+		ISP_PRINT(ISP_WARNING_LEVEL,"Get WDR mode failure!reture value is %d,reason is %d\n",status,reason);
+	}
+
+	if (reason == IMAGE_WDR_MODE_LINEAR || reason == IMAGE_WDR_MODE_FS_HDR) {
+		wdr = reason == IMAGE_WDR_MODE_FS_HDR;
+		stab.global_minimum_sinter_strength = image->sinter_min[wdr];
+		stab.global_maximum_sinter_strength = image->sinter_max[wdr];
+		stab.global_maximum_directional_sharpening = image->sharp_d_max[wdr];
+		stab.global_minimum_directional_sharpening = image->sharp_d_min[wdr];
+		stab.global_maximum_un_directional_sharpening = image->sharp_ud_max[wdr];
+		stab.global_minimum_un_directional_sharpening = image->sharp_ud_min[wdr];
+		stab.global_maximum_iridix_strength = image->iridix_max[wdr];
+	}
+	stab.global_minimum_temper_strength = image->temper_min;
+	stab.global_maximum_temper_strength = image->temper_max;
+	ctrls->temper_max = image->temper_max;
+	ctrls->temper_min = image->temper_min;
+	stab.global_minimum_iridix_strength = image->iridix_min;
+
+	APICAL_WRITE_32(0x40, tmp_top);
+	/* if it is T20,the FR is corresponding to DS2 in bin file. */
+	if (customer->top & (1 << 19)){
 #if TX_ISP_EXIST_FR_CHANNEL
-				apical_isp_top_bypass_fr_gamma_rgb_write(0);
-				apical_isp_fr_gamma_rgb_enable_write(1);
+		apical_isp_top_bypass_fr_gamma_rgb_write(0);
+		apical_isp_fr_gamma_rgb_enable_write(1);
 #endif
 #if TX_ISP_EXIST_DS2_CHANNEL
-				apical_isp_top_bypass_ds2_gamma_rgb_write(0);
-				apical_isp_ds2_gamma_rgb_enable_write(1);
+		apical_isp_top_bypass_ds2_gamma_rgb_write(0);
+		apical_isp_ds2_gamma_rgb_enable_write(1);
 #endif
-			} else {
+	} else {
 #if TX_ISP_EXIST_FR_CHANNEL
-				apical_isp_top_bypass_fr_gamma_rgb_write(1);
-				apical_isp_fr_gamma_rgb_enable_write(0);
+		apical_isp_top_bypass_fr_gamma_rgb_write(1);
+		apical_isp_fr_gamma_rgb_enable_write(0);
 #endif
 #if TX_ISP_EXIST_DS2_CHANNEL
-				apical_isp_top_bypass_ds2_gamma_rgb_write(1);
-				apical_isp_ds2_gamma_rgb_enable_write(0);
+		apical_isp_top_bypass_ds2_gamma_rgb_write(1);
+		apical_isp_ds2_gamma_rgb_enable_write(0);
 #endif
-			}
+	}
 
-			if ((customer->top) & (1 << 20)){
+	if ((customer->top) & (1 << 20)){
 #if TX_ISP_EXIST_FR_CHANNEL
-				apical_isp_top_bypass_fr_sharpen_write(0);
-				apical_isp_fr_sharpen_enable_write(1);
+		apical_isp_top_bypass_fr_sharpen_write(0);
+		apical_isp_fr_sharpen_enable_write(1);
 #endif
 #if TX_ISP_EXIST_DS2_CHANNEL
-				apical_isp_top_bypass_ds2_sharpen_write(0);
-				apical_isp_ds2_sharpen_enable_write(1);
+		apical_isp_top_bypass_ds2_sharpen_write(0);
+		apical_isp_ds2_sharpen_enable_write(1);
 #endif
-			} else {
+	} else {
 #if TX_ISP_EXIST_FR_CHANNEL
-				apical_isp_fr_sharpen_enable_write(1);
-				apical_isp_top_bypass_fr_sharpen_write(0);
+		apical_isp_fr_sharpen_enable_write(1);
+		apical_isp_top_bypass_fr_sharpen_write(0);
 #endif
 #ifdef TX_ISP_EXIST_DS2_CHANNEL
-				apical_isp_top_bypass_ds2_sharpen_write(1);
-				apical_isp_ds2_sharpen_enable_write(0);
+		apical_isp_top_bypass_ds2_sharpen_write(1);
+		apical_isp_ds2_sharpen_enable_write(0);
 #endif
-			}
-			if ((customer->top) & (1 << 27))
-				apical_isp_ds1_sharpen_enable_write(1);
-			else
-				apical_isp_ds1_sharpen_enable_write(0);
-		}
-		ctrls->daynight = dn;
 	}
+	if ((customer->top) & (1 << 27))
+		apical_isp_ds1_sharpen_enable_write(1);
+	else
+		apical_isp_ds1_sharpen_enable_write(0);
+
+	ctrls->daynight = dn;
+
+	now = private_sched_clock();
+	dn_switch->count++;
+	dn_switch->last_frames = core->frame_sequeue - dn_switch->req_frame;
+	dn_switch->last_us = div_u64(now - dn_switch->req_time, 1000);
+	dn_switch->apply_us = div_u64(now - start, 1000);
+	if (dn_switch->apply_us > dn_switch->max_apply_us)
+		dn_switch->max_apply_us = dn_switch->apply_us;
+	spin_unlock(&tuning->slock);
+
 	return ret;
 }
 
 
 static inline int apical_isp_day_or_night_s_ctrl(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
-	struct tx_isp_subdev *sd = tuning->parent;
-	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
-	TXispPrivParamManage *param = core->param;
+	struct isp_core_dn_switch *dn_switch = &tuning->dn;
 	struct image_tuning_ctrls *ctrls = &(tuning->ctrls);
 	int ret = ISP_SUCCESS;
 
 	ISP_CORE_MODE_DN_E dn = control->value;
-	if(!param){
+	if(!dn_switch->image[TX_ISP_PRIV_PARAM_DAY_MODE].ready
+	   || !dn_switch->image[TX_ISP_PRIV_PARAM_NIGHT_MODE].ready){
 		ISP_ERROR("Can't get the parameters of isp tuning!\n");
 		return -ENOENT;
 	}
 	if(dn != ctrls->daynight){
 		ctrls->daynight = dn;
-		core->isp_daynight_switch = 1;
+		apical_isp_day_or_night_request(tuning);
 	}
 	return ret;
 }
@@ -1853,11 +1763,8 @@ set_sharpness_val:
 	return ret;
 }
 
-static inline int apical_isp_sharp_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+static inline int apical_isp_sharp_apply_attr(struct isp_core_sharpness_attr *attr)
 {
-	struct isp_core_sharpness_attr *attr = &tuning->ctrls.sharp_attr;
-
-	copy_from_user(attr, (const void __user *)control->value, sizeof(*attr));
 #if 1
 	apical_isp_fr_sharpen_strength_write(attr->target_sharp);
 	apical_isp_ds1_sharpen_strength_write(attr->target_sharp);
@@ -1882,11 +1789,16 @@ static inline int apical_isp_sharp_s_attr(image_tuning_vdrv_t *tuning, struct v4
 	return ISP_SUCCESS;
 }
 
-static inline int apical_isp_demosaic_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+static inline int apical_isp_sharp_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
-	struct isp_core_demosaic_attr *attr = &tuning->ctrls.demo_attr;
+	struct isp_core_sharpness_attr *attr = &tuning->ctrls.sharp_attr;
 
 	copy_from_user(attr, (const void __user *)control->value, sizeof(*attr));
+	return apical_isp_sharp_apply_attr(attr);
+}
+
+static inline int apical_isp_demosaic_apply_attr(struct isp_core_demosaic_attr *attr)
+{
 	apical_isp_demosaic_vh_slope_write(attr->vh_slope);
 	apical_isp_demosaic_aa_slope_write(attr->aa_slope);
 	apical_isp_demosaic_va_slope_write(attr->va_slope);
@@ -1907,6 +1819,14 @@ static inline int apical_isp_demosaic_s_attr(image_tuning_vdrv_t *tuning, struct
 	return ISP_SUCCESS;
 }
 
+static inline int apical_isp_demosaic_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+{
+	struct isp_core_demosaic_attr *attr = &tuning->ctrls.demo_attr;
+
+	copy_from_user(attr, (const void __user *)control->value, sizeof(*attr));
+	return apical_isp_demosaic_apply_attr(attr);
+}
+
 static int apical_isp_gamma_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
 	int ret = ISP_SUCCESS;
@@ -1989,19 +1909,19 @@ static int apical_isp_stab_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_contr
 	return 0;
 }
 
-static int apical_isp_gamma_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+/* attr == NULL restores the default gamma */
+static int apical_isp_gamma_apply_attr(struct isp_core_gamma_attr *attr)
 {
 	int ret = ISP_SUCCESS;
-	struct isp_core_gamma_attr attr;
+	struct isp_core_gamma_attr def;
 
-	if (0 == control->value) {
-		apical_api_calibration(CALIBRATION_GAMMA_LINEAR, COMMAND_GET, attr.gamma, sizeof(attr.gamma), &ret);
+	if (NULL == attr) {
+		apical_api_calibration(CALIBRATION_GAMMA_LINEAR, COMMAND_GET, def.gamma, sizeof(def.gamma), &ret);
 		if (ret != ISP_SUCCESS)
 			goto err_get_def_gamma;
-	} else {
-		copy_from_user(&attr, (const void __user*)control->value, sizeof(attr));
+		attr = &def;
 	}
-	apical_api_calibration(CALIBRATION_GAMMA_LINEAR, COMMAND_SET, attr.gamma, sizeof(attr.gamma), &ret);
+	apical_api_calibration(CALIBRATION_GAMMA_LINEAR, COMMAND_SET, attr->gamma, sizeof(attr->gamma), &ret);
 	if (ret != ISP_SUCCESS)
 		goto err_set_def_gamma;
 	return ret;
@@ -2011,56 +1931,91 @@ err_get_def_gamma:
 	return ret;
 }
 
-static int apical_isp_ae_weight_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+static int apical_isp_gamma_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
-	struct isp_core_weight_attr attr;
-	unsigned int row,col;
+	struct isp_core_gamma_attr attr;
 
+	if (0 == control->value)
+		return apical_isp_gamma_apply_attr(NULL);
 	copy_from_user(&attr, (const void __user*)control->value, sizeof(attr));
+	return apical_isp_gamma_apply_attr(&attr);
+}
+
+static void apical_isp_ae_weight_read(struct isp_core_weight_attr *attr)
+{
+	unsigned int row,col;
 
 	for (row = 0; row < 15; row++){
 		for (col = 0; col < 15; col++){
-			apical_isp_zones_aexp_weight_write(row, col, (attr.weight[row][col]));
+			attr->weight[row][col] = apical_isp_zones_aexp_weight_read(row,col);
 		}
 	}
+}
 
-	return 0;
+static void apical_isp_awb_weight_read(struct isp_core_weight_attr *attr)
+{
+	unsigned int row,col;
+
+	for (row = 0; row < 15; row++){
+		for (col = 0; col < 15; col++){
+			attr->weight[row][col] = apical_isp_zones_awb_weight_read(row,col);
+		}
+	}
 }
 
-static int apical_isp_ae_weight_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+static int apical_isp_ae_weight_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
 	struct isp_core_weight_attr attr;
+	unsigned long flags = 0;
 	unsigned int row,col;
 
+	copy_from_user(&attr, (const void __user*)control->value, sizeof(attr));
+
 	for (row = 0; row < 15; row++){
 		for (col = 0; col < 15; col++){
-			attr.weight[row][col] = apical_isp_zones_aexp_weight_read(row,col);
+			apical_isp_zones_aexp_weight_write(row, col, (attr.weight[row][col]));
 		}
 	}
 
+	spin_lock_irqsave(&tuning->slock, flags);
+	memcpy(&tuning->stats_ae_weight, &attr, sizeof(attr));
+	spin_unlock_irqrestore(&tuning->slock, flags);
+
+	return 0;
+}
+
+static int apical_isp_ae_weight_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+{
+	struct isp_core_weight_attr attr;
+
+	apical_isp_ae_weight_read(&attr);
 	copy_to_user((void __user*)control->value, &attr, sizeof(attr));
 
 	return 0;
 }
 
-static int apical_isp_ae_hist_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+static void apical_isp_ae_hist_read(struct isp_core_ae_sta_info *info)
 {
-	struct isp_core_ae_sta_info info;
+	info->ae_histhresh[0] = apical_isp_metering_hist_thresh_0_1_read();
+	info->ae_histhresh[1] = apical_isp_metering_hist_thresh_1_2_read();
+	info->ae_histhresh[2] = apical_isp_metering_hist_thresh_3_4_read();
+	info->ae_histhresh[3] = apical_isp_metering_hist_thresh_4_5_read();
 
-	info.ae_histhresh[0] = apical_isp_metering_hist_thresh_0_1_read();
-	info.ae_histhresh[1] = apical_isp_metering_hist_thresh_1_2_read();
-	info.ae_histhresh[2] = apical_isp_metering_hist_thresh_3_4_read();
-	info.ae_histhresh[3] = apical_isp_metering_hist_thresh_4_5_read();
+	info->ae_hist[0] = apical_isp_metering_hist_0_read();
+	info->ae_hist[1] = apical_isp_metering_hist_1_read();
+	info->ae_hist[3] = apical_isp_metering_hist_3_read();
+	info->ae_hist[4] = apical_isp_metering_hist_4_read();
+	info->ae_hist[2] = 0xffff - info->ae_hist[0] - info->ae_hist[1] - info->ae_hist[3] - info->ae_hist[4];
 
-	info.ae_hist[0] = apical_isp_metering_hist_0_read();
-	info.ae_hist[1] = apical_isp_metering_hist_1_read();
-	info.ae_hist[3] = apical_isp_metering_hist_3_read();
-	info.ae_hist[4] = apical_isp_metering_hist_4_read();
-	info.ae_hist[2] = 0xffff - info.ae_hist[0] - info.ae_hist[1] - info.ae_hist[3] - info.ae_hist[4];
+	info->ae_stat_nodeh = apical_isp_metering_aexp_nodes_used_horiz_read();
+	info->ae_stat_nodev = apical_isp_metering_aexp_nodes_used_vert_read();
+}
 
-	info.ae_stat_nodeh = apical_isp_metering_aexp_nodes_used_horiz_read();
-	info.ae_stat_nodev = apical_isp_metering_aexp_nodes_used_vert_read();
+static int apical_isp_ae_hist_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+{
+	struct isp_core_ae_sta_info info;
 
+	apical_isp_ae_hist_read(&info);
 	copy_to_user((void __user*)control->value, &info, sizeof(info));
 	return 0;
 }
@@ -2082,28 +2037,32 @@ static int apical_isp_ae_hist_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_co
 	return 0;
 }
 
+static void apical_isp_awb_hist_read(struct isp_core_awb_sta_info *info)
+{
+	info->awb_stat.r_gain = apical_isp_metering_awb_rg_read();
+	info->awb_stat.b_gain = apical_isp_metering_awb_bg_read();
+	info->awb_stat.awb_sum = apical_isp_metering_awb_sum_read();
+
+	info->awb_stats_mode = apical_isp_metering_awb_stats_mode_read()?ISPCORE_AWB_STATS_CURRENT_MODE:ISPCORE_AWB_STATS_LEGACY_MODE;
+	info->awb_whitelevel = apical_isp_metering_white_level_awb_read();
+	info->awb_blacklevel = apical_isp_metering_black_level_awb_read();
+	info->cr_ref_max = apical_isp_metering_cr_ref_max_awb_read();
+	info->cr_ref_min = apical_isp_metering_cr_ref_min_awb_read();
+	info->cb_ref_max = apical_isp_metering_cb_ref_max_awb_read();
+	info->cb_ref_min = apical_isp_metering_cb_ref_min_awb_read();
+	info->awb_stat_nodeh = apical_isp_metering_awb_nodes_used_horiz_read();
+	info->awb_stat_nodev = apical_isp_metering_awb_nodes_used_vert_read();
+	/* info->cr_ref_high = apical_isp_metering_cr_ref_high_awb_read(); */
+	/* info->cr_ref_low = apical_isp_metering_cr_ref_low_awb_read(); */
+	/* info->cb_ref_high = apical_isp_metering_cb_ref_high_awb_read(); */
+	/* info->cb_ref_low = apical_isp_metering_cb_ref_low_awb_read(); */
+}
+
 static int apical_isp_awb_hist_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
 	struct isp_core_awb_sta_info info;
 
-	info.awb_stat.r_gain = apical_isp_metering_awb_rg_read();
-	info.awb_stat.b_gain = apical_isp_metering_awb_bg_read();
-	info.awb_stat.awb_sum = apical_isp_metering_awb_sum_read();
-
-	info.awb_stats_mode = apical_isp_metering_awb_stats_mode_read()?ISPCORE_AWB_STATS_CURRENT_MODE:ISPCORE_AWB_STATS_LEGACY_MODE;
-	info.awb_whitelevel = apical_isp_metering_white_level_awb_read();
-	info.awb_blacklevel = apical_isp_metering_black_level_awb_read();
-	info.cr_ref_max = apical_isp_metering_cr_ref_max_awb_read();
-	info.cr_ref_min = apical_isp_metering_cr_ref_min_awb_read();
-	info.cb_ref_max = apical_isp_metering_cb_ref_max_awb_read();
-	info.cb_ref_min = apical_isp_metering_cb_ref_min_awb_read();
-	info.awb_stat_nodeh = apical_isp_metering_awb_nodes_used_horiz_read();
-	info.awb_stat_nodev = apical_isp_metering_awb_nodes_used_vert_read();
-	/* info.cr_ref_high = apical_isp_metering_cr_ref_high_awb_read(); */
-	/* info.cr_ref_low = apical_isp_metering_cr_ref_low_awb_read(); */
-	/* info.cb_ref_high = apical_isp_metering_cb_ref_high_awb_read(); */
-	/* info.cb_ref_low = apical_isp_metering_cb_ref_low_awb_read(); */
-
+	apical_isp_awb_hist_read(&info);
 	copy_to_user((void __user*)control->value, &info, sizeof(info));
 
 	return 0;
@@ -2187,6 +2146,7 @@ static int apical_isp_af_hist_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_co
 static int apical_isp_awb_weight_s_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
 	struct isp_core_weight_attr attr;
+	unsigned long flags = 0;
 	unsigned int row,col;
 
 	copy_from_user(&attr, (const void __user*)control->value, sizeof(attr));
@@ -2197,20 +2157,18 @@ static int apical_isp_awb_weight_s_attr(image_tuning_vdrv_t *tuning, struct v4l2
 		}
 	}
 
+	spin_lock_irqsave(&tuning->slock, flags);
+	memcpy(&tuning->stats_awb_weight, &attr, sizeof(attr));
+	spin_unlock_irqrestore(&tuning->slock, flags);
+
 	return 0;
 }
 
 static int apical_isp_awb_weight_g_attr(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
 {
 	struct isp_core_weight_attr attr;
-	unsigned int row,col;
-
-	for (row = 0; row < 15; row++){
-		for (col = 0; col < 15; col++){
-			attr.weight[row][col] = apical_isp_zones_awb_weight_read(row,col);
-		}
-	}
 
+	apical_isp_awb_weight_read(&attr);
 	copy_to_user((void __user*)control->value, &attr, sizeof(attr));
 
 	return 0;
@@ -3444,6 +3402,170 @@ static int apical_isp_core_ops_s_ctrl(image_tuning_vdrv_t *tuning, struct v4l2_c
 	return ret;
 }
 
+/*
+   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+   batch of controls committed at frame start
+   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+ */
+#define ISP_TUNING_BATCH_TIMEOUT_MS	1000
+
+/*
+ * Validate one control of a batch and copy its user data into the shadow.
+ * Only the controls which neither sleep nor touch user memory while being
+ * applied are accepted, because the batch is applied in the interrupt.
+ */
+static int apical_isp_batch_check_ctrl(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+{
+	struct isp_core_tuning_shadow *shadow = &tuning->shadow;
+	int ret = ISP_SUCCESS;
+
+	switch (control->id) {
+	case V4L2_CID_SATURATION:
+	case V4L2_CID_BRIGHTNESS:
+	case V4L2_CID_CONTRAST:
+	case V4L2_CID_SHARPNESS:
+		if (control->value < 0 || control->value > 0xff)
+			ret = -EINVAL;
+		break;
+	case V4L2_CID_HFLIP:
+		if (control->value != 0 && control->value != 1)
+			ret = -EINVAL;
+		break;
+	case IMAGE_TUNING_CID_CUSTOM_DRC:
+		if (control->value < ISPMODULE_DRC_MANUAL || control->value > ISPMODULE_DRC_DISABLE)
+			ret = -EINVAL;
+		break;
+	case IMAGE_TUNING_CID_AE_COMP:
+	case IMAGE_TUNING_CID_MAX_AGAIN_ATTR:
+	case IMAGE_TUNING_CID_MAX_DGAIN_ATTR:
+		break;
+	case IMAGE_TUNING_CID_SHARP_ATTR:
+		if (copy_from_user(&shadow->sharp_attr, (const void __user *)control->value, sizeof(shadow->sharp_attr)))
+			ret = -EFAULT;
+		break;
+	case IMAGE_TUNING_CID_DEMO_ATTR:
+		if (copy_from_user(&shadow->demo_attr, (const void __user *)control->value, sizeof(shadow->demo_attr)))
+			ret = -EFAULT;
+		break;
+	case IMAGE_TUNING_CID_GAMMA_ATTR:
+		/* 0 means the default gamma, see apical_isp_gamma_s_attr */
+		if (control->value &&
+				copy_from_user(&shadow->gamma_attr, (const void __user *)control->value, sizeof(shadow->gamma_attr)))
+			ret = -EFAULT;
+		break;
+	default:
+		ret = -EPERM;
+		break;
+	}
+	return ret;
+}
+
+static int apical_isp_batch_apply_ctrl(image_tuning_vdrv_t *tuning, struct v4l2_control *control)
+{
+	struct isp_core_tuning_shadow *shadow = &tuning->shadow;
+	int ret = ISP_SUCCESS;
+
+	switch (control->id) {
+	case IMAGE_TUNING_CID_SHARP_ATTR:
+		tuning->ctrls.sharp_attr = shadow->sharp_attr;
+		ret = apical_isp_sharp_apply_attr(&tuning->ctrls.sharp_attr);
+		break;
+	case IMAGE_TUNING_CID_DEMO_ATTR:
+		tuning->ctrls.demo_attr = shadow->demo_attr;
+		ret = apical_isp_demosaic_apply_attr(&tuning->ctrls.demo_attr);
+		break;
+	case IMAGE_TUNING_CID_GAMMA_ATTR:
+		ret = apical_isp_gamma_apply_attr(control->value ? &shadow->gamma_attr : NULL);
+		break;
+	default:
+		ret = apical_isp_core_ops_s_ctrl(tuning, control);
+		break;
+	}
+	return ret;
+}
+
+static void apical_isp_batch_apply(image_tuning_vdrv_t *tuning)
+{
+	struct isp_image_tuning_batch_ctrl *batch = &tuning->shadow.batch;
+	int i = 0;
+
+	for (i = 0; i < batch->count; i++)
+		batch->status[i] = apical_isp_batch_apply_ctrl(tuning, &batch->controls[i]);
+}
+
+/* It is called in the interrupt of frame start. */
+static void isp_core_tuning_commit_batch(image_tuning_vdrv_t *tuning)
+{
+	struct isp_core_tuning_shadow *shadow = &tuning->shadow;
+	unsigned long flags = 0;
+
+	spin_lock_irqsave(&tuning->slock, flags);
+	if (shadow->pending) {
+		apical_isp_batch_apply(tuning);
+		shadow->pending = 0;
+		wake_up(&shadow->wq);
+	}
+	spin_unlock_irqrestore(&tuning->slock, flags);
+}
+
+static long isp_core_tunning_batch_ioctl(image_tuning_vdrv_t *tuning, unsigned long arg)
+{
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(tuning->parent);
+	struct isp_core_tuning_shadow *shadow = &tuning->shadow;
+	struct isp_image_tuning_batch_ctrl *batch = &shadow->batch;
+	unsigned long flags = 0;
+	long ret = ISP_SUCCESS;
+	long left = 0;
+	int i = 0;
+
+	/* only one batch is in flight, the shadow is free while we hold mlock */
+	mutex_lock(&tuning->mlock);
+	if (copy_from_user(batch, (void __user *)arg, sizeof(*batch))) {
+		ret = -EFAULT;
+		goto exit;
+	}
+	if (batch->count == 0 || batch->count > ISP_TUNING_BATCH_MAX_CTRLS) {
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	for (i = 0; i < batch->count; i++) {
+		batch->status[i] = apical_isp_batch_check_ctrl(tuning, &batch->controls[i]);
+		if (batch->status[i])
+			ret = -EINVAL;
+	}
+	if (ret)
+		goto copy_status;
+
+	if (core->state != TX_ISP_MODULE_RUNNING) {
+		/* no frame will start, there is nothing to tear */
+		apical_isp_batch_apply(tuning);
+		goto copy_status;
+	}
+
+	shadow->pending = 1;
+	left = wait_event_interruptible_timeout(shadow->wq, shadow->pending == 0,
+			msecs_to_jiffies(ISP_TUNING_BATCH_TIMEOUT_MS));
+	if (left <= 0) {
+		spin_lock_irqsave(&tuning->slock, flags);
+		if (shadow->pending) {
+			/* withdraw the batch, nothing of it has been applied */
+			shadow->pending = 0;
+			ret = left ? -EINTR : -ETIMEDOUT;
+			for (i = 0; i < batch->count; i++)
+				batch->status[i] = ret;
+		}
+		spin_unlock_irqrestore(&tuning->slock, flags);
+	}
+
+copy_status:
+	if (copy_to_user((void __user *)arg, batch, sizeof(*batch)))
+		ret = -EFAULT;
+exit:
+	mutex_unlock(&tuning->mlock);
+	return ret;
+}
+
 static long isp_core_tunning_default_ioctl(image_tuning_vdrv_t *tuning, unsigned int cmd, unsigned long arg)
 {
 	struct isp_image_tuning_default_ctrl ctrl;
@@ -3498,6 +3620,9 @@ static long isp_core_tunning_unlocked_ioctl(struct file *file, unsigned int cmd,
 		if (copy_to_user((void __user *)arg, &control, sizeof(control)))
 			ret = -EFAULT;
 		break;
+	case VIDIOC_DEFAULT_CMD_ISP_TUNING_BATCH:
+		ret = isp_core_tunning_batch_ioctl(tuning, arg);
+		break;
 	default:
 		ret = isp_core_tunning_default_ioctl(tuning, cmd, arg);
 		break;
@@ -3510,6 +3635,85 @@ done:
 }
 
 
+/*
+ * Publish the statistics of the frame just done into the next ring slot.
+ * The slot sequence is odd while it is written, so a reader copying the
+ * latest slot retries if the sequence changed or was odd.
+ */
+static void isp_core_tuning_publish_stats(image_tuning_vdrv_t *tuning)
+{
+	struct tx_isp_subdev *sd = tuning->parent;
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
+	struct isp_core_stats_ring *ring = tuning->stats;
+	struct isp_core_stats_frame *frame = NULL;
+	unsigned int next = 0;
+
+	if(!ring || tuning->state != TX_ISP_MODULE_INIT)
+		return;
+
+	next = (ring->latest + 1) % ISP_CORE_STATS_RING_SLOTS;
+	frame = &ring->frame[next];
+	frame->seq++;
+	smp_wmb();
+	frame->frame = core->frame_sequeue;
+	frame->timestamp = private_sched_clock();
+	apical_isp_ae_hist_read(&frame->ae);
+	apical_isp_awb_hist_read(&frame->awb);
+	spin_lock(&tuning->slock);
+	memcpy(&frame->ae_weight, &tuning->stats_ae_weight, sizeof(frame->ae_weight));
+	memcpy(&frame->awb_weight, &tuning->stats_awb_weight, sizeof(frame->awb_weight));
+	spin_unlock(&tuning->slock);
+	smp_wmb();
+	frame->seq++;
+	ring->latest = next;
+	ring->count++;
+
+	wake_up_interruptible(&tuning->stats_wq);
+}
+
+static int isp_core_tunning_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct miscdevice *dev = file->private_data;
+	struct tx_isp_module *module = miscdev_to_module(dev);
+	struct tx_isp_subdev *sd = module_to_subdev(module);
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
+	image_tuning_vdrv_t *tuning = core->tuning;
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if(!tuning->stats)
+		return -ENOMEM;
+	if(vma->vm_pgoff || size > (PAGE_SIZE << tuning->stats_order))
+		return -EINVAL;
+	/* the ring is published by the driver only */
+	if(vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_pfn_range(vma, vma->vm_start, virt_to_phys(tuning->stats) >> PAGE_SHIFT,
+			       size, vma->vm_page_prot);
+}
+
+static unsigned int isp_core_tunning_poll(struct file *file, poll_table *wait)
+{
+	struct miscdevice *dev = file->private_data;
+	struct tx_isp_module *module = miscdev_to_module(dev);
+	struct tx_isp_subdev *sd = module_to_subdev(module);
+	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
+	image_tuning_vdrv_t *tuning = core->tuning;
+	unsigned int mask = 0;
+
+	if(!tuning->stats)
+		return POLLERR;
+
+	poll_wait(file, &tuning->stats_wq, wait);
+	/* f_version is unused by this device, it keeps the count last reported */
+	if(file->f_version != tuning->stats->count){
+		file->f_version = tuning->stats->count;
+		mask |= POLLIN | POLLRDNORM;
+	}
+	return mask;
+}
+
 static int isp_core_tunning_open(struct inode *inode, struct file *file)
 {
 	struct miscdevice *dev = file->private_data;
@@ -3527,8 +3731,10 @@ static int isp_core_tunning_open(struct inode *inode, struct file *file)
 		return -EPERM;
 	}
 
-	core->isp_daynight_switch = 1;
+	apical_isp_day_or_night_request(tuning);
 	tuning->temper_paddr = 0;
+	apical_isp_ae_weight_read(&tuning->stats_ae_weight);
+	apical_isp_awb_weight_read(&tuning->stats_awb_weight);
 	table = param->isp_param[TX_ISP_PRIV_PARAM_DAY_MODE].calibrations;
 	ctrls->temper_max = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + table[_CALIBRATION_TEMPER_STRENGTH]->rows * table[_CALIBRATION_TEMPER_STRENGTH]->cols -1 );;
 	ctrls->temper_min = *((uint16_t *)(table[ _CALIBRATION_TEMPER_STRENGTH]->ptr) + 1);
@@ -3579,6 +3785,8 @@ static struct file_operations isp_core_tunning_fops = {
 	.open = isp_core_tunning_open,
 	.release = isp_core_tunning_release,
 	.unlocked_ioctl = isp_core_tunning_unlocked_ioctl,
+	.mmap = isp_core_tunning_mmap,
+	.poll = isp_core_tunning_poll,
 };
 
 static int isp_core_tuning_activate(struct isp_core_tuning_driver *tuning)
@@ -3610,11 +3818,18 @@ static int isp_core_tuning_event(struct isp_core_tuning_driver *tuning, unsigned
 		ret = isp_core_tuning_slake(tuning);
 		break;
 	case TX_ISP_EVENT_CORE_FRAME_DONE:
+		isp_core_tuning_publish_stats(tuning);
 		isp_frame_done_wakeup();
 		break;
 	case TX_ISP_EVENT_CORE_DAY_NIGHT:
 		apical_isp_day_or_night_s_ctrl_internal(tuning);
 		break;
+	case TX_ISP_EVENT_CORE_FRAME_START:
+		isp_core_tuning_commit_batch(tuning);
+		break;
+	case TX_ISP_EVENT_CORE_DN_PREPARE:
+		ret = apical_isp_day_or_night_prepare(tuning);
+		break;
 	default:
 		break;
 	}
@@ -3635,6 +3850,22 @@ struct isp_core_tuning_driver *isp_core_tuning_init(struct tx_isp_subdev *parent
 	tuning->parent = parent;
 	spin_lock_init(&tuning->slock);
 	mutex_init(&tuning->mlock);
+	init_waitqueue_head(&tuning->shadow.wq);
+	init_waitqueue_head(&tuning->stats_wq);
+
+	/* the statistics ring is mapped to userspace, so it takes whole pages */
+	tuning->stats_order = get_order(sizeof(struct isp_core_stats_ring));
+	tuning->stats = (struct isp_core_stats_ring *)__get_free_pages(GFP_KERNEL | __GFP_ZERO, tuning->stats_order);
+	if(tuning->stats){
+		struct page *page = virt_to_page(tuning->stats);
+		int i;
+		for (i = 0; i < (1 << tuning->stats_order); i++)
+			SetPageReserved(page + i);
+		tuning->stats->size = sizeof(struct isp_core_stats_ring);
+		tuning->stats->slots = ISP_CORE_STATS_RING_SLOTS;
+	}else{
+		ISP_WRANING("Failed to allocate the statistics ring, mmap is disabled\n");
+	}
 
 	tuning->state = TX_ISP_MODULE_SLAKE;
 	tuning->fops = &isp_core_tunning_fops;
@@ -3644,6 +3875,16 @@ struct isp_core_tuning_driver *isp_core_tuning_init(struct tx_isp_subdev *parent
 
 void isp_core_tuning_deinit(image_tuning_vdrv_t *tuning)
 {
-	if(tuning)
-		kfree(tuning);
+	struct page *page = NULL;
+	int i;
+
+	if(!tuning)
+		return;
+	if(tuning->stats){
+		page = virt_to_page(tuning->stats);
+		for (i = 0; i < (1 << tuning->stats_order); i++)
+			ClearPageReserved(page + i);
+		free_pages((unsigned long)tuning->stats, tuning->stats_order);
+	}
+	kfree(tuning);
 }
@@ -417,6 +417,31 @@ struct isp_core_awb_sta_info{
 	unsigned char awb_stat_nodev;
 };
 
+/*
+ * Per-frame statistics, published into a ring that userspace maps from the
+ * tuning device (offset 0, read only). Read frame[latest]: retry while its
+ * seq is odd or changed during the copy. poll() signals every new frame.
+ */
+#define ISP_CORE_STATS_RING_SLOTS	4
+
+struct isp_core_stats_frame{
+	volatile unsigned int seq;
+	unsigned int frame;			/* isp frame sequence */
+	unsigned long long timestamp;		/* ns */
+	struct isp_core_ae_sta_info ae;
+	struct isp_core_awb_sta_info awb;
+	struct isp_core_weight_attr ae_weight;
+	struct isp_core_weight_attr awb_weight;
+};
+
+struct isp_core_stats_ring{
+	unsigned int size;
+	unsigned int slots;
+	volatile unsigned int count;		/* frames published */
+	volatile unsigned int latest;		/* slot of the latest frame */
+	struct isp_core_stats_frame frame[ISP_CORE_STATS_RING_SLOTS];
+};
+
 struct af_sta_info{
 	unsigned short af_metrics;
 	unsigned short af_metrics_alt;
@@ -773,6 +798,56 @@ struct image_tuning_ctrls {
 
 };
 
+/* the batch of controls waiting for the next frame start */
+struct isp_core_tuning_shadow {
+	struct isp_image_tuning_batch_ctrl batch;
+	struct isp_core_sharpness_attr sharp_attr;
+	struct isp_core_demosaic_attr demo_attr;
+	struct isp_core_gamma_attr gamma_attr;
+	volatile unsigned int pending;
+	wait_queue_head_t wq;
+};
+
+#define ISP_CORE_DN_CALIB_MAX	96
+
+struct isp_core_dn_calib {
+	unsigned int id;
+	void *ptr;
+	unsigned int size;
+};
+
+/* everything a day/night switch writes, resolved from the bin file once */
+struct isp_core_dn_image {
+	TXispPrivCustomerParamer *customer;
+	struct isp_core_dn_calib calib[ISP_CORE_DN_CALIB_MAX];
+	unsigned int calib_num;
+	unsigned int clip_min_uv;
+	unsigned int clip_max_uv;
+	/* index 0 is linear mode, index 1 is fs hdr mode */
+	uint16_t sinter_min[2];
+	uint16_t sinter_max[2];
+	uint16_t sharp_d_min[2];
+	uint16_t sharp_d_max[2];
+	uint16_t sharp_ud_min[2];
+	uint16_t sharp_ud_max[2];
+	uint8_t iridix_max[2];
+	uint8_t iridix_min;
+	uint16_t temper_min;
+	uint16_t temper_max;
+	int ready;
+};
+
+struct isp_core_dn_switch {
+	struct isp_core_dn_image image[TX_ISP_PRIV_PARAM_BUTT_MODE];
+	unsigned int req_frame;
+	unsigned long long req_time;
+	unsigned int count;
+	unsigned int last_frames;	/* frames from request to applied */
+	unsigned int last_us;		/* us from request to applied */
+	unsigned int apply_us;		/* us spent in the interrupt */
+	unsigned int max_apply_us;
+};
+
 /**
  * struct fimc_isp - FIMC-IS ISP data structure
  * @parent: pointer to ISP CORE device
@@ -794,6 +869,13 @@ typedef struct isp_core_tuning_driver {
 	int			state;
 	struct file_operations *fops;
 	int (*event)(struct isp_core_tuning_driver *tuning, unsigned int event, void *data);
+	struct isp_core_tuning_shadow shadow;
+	struct isp_core_dn_switch dn;
+	struct isp_core_stats_ring *stats;
+	unsigned int stats_order;
+	struct isp_core_weight_attr stats_ae_weight;
+	struct isp_core_weight_attr stats_awb_weight;
+	wait_queue_head_t stats_wq;
 } image_tuning_vdrv_t;
 
 #define ctrl_to_image_tuning(_ctrl) \
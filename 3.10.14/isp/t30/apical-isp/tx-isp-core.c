@@ -33,6 +33,7 @@
 #include "tx-isp-core-tuning.h"
 
 #include "../videoin/tx-isp-vic.h"
+#include <tx-isp-trace.h>
 
 #if ISP_HAS_CONNECTION_DEBUG
 #include "apical_cmd_interface.h"
@@ -52,44 +53,6 @@ static int isp_clk = ISP_CLK_1080P_MODE;
 module_param(isp_clk, int, S_IRUGO);
 MODULE_PARM_DESC(isp_clk, "isp core clock");
 
-/*
-   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
-   manager the buffer of frame channels
-   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
- */
-static inline void init_buffer_fifo(struct list_head *fifo)
-{
-	TX_INIT_LIST_HEAD(fifo);
-}
-
-static struct frame_channel_buffer *pop_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	if(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		//		printk("^-^ %s %d %p %p^-^\n",__func__,__LINE__, fifo, buf);
-		tx_list_del(&(buf->entry));
-	}else
-		buf = NULL;
-
-	return buf;
-}
-
-static void inline push_buffer_fifo(struct list_head *fifo, struct frame_channel_buffer *buf)
-{
-	//	printk("^@^ %s %d %p %p^-^\n",__func__,__LINE__, fifo, buf);
-	tx_list_add_tail(&(buf->entry), fifo);
-}
-
-static void inline cleanup_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	while(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}
-}
-
 /*
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
    interrupt handler
@@ -307,7 +270,7 @@ static int isp_configure_base_addr(struct tx_isp_core_device *core)
 			for (i = 0, bank_id = current_bank; i < chan->usingbanks; i++, bank_id++) {
 				bank_id = bank_id % chan->usingbanks;
 				if (chan->bank_flag[bank_id] == 0) {
-					buf = pop_buffer_fifo(&chan->fifo);
+					buf = tx_isp_fifo_pop(&chan->fifo);
 					if(buf != NULL){
 #if 0
 						if (core->vflip_state) {
@@ -478,14 +441,20 @@ static inline void isp_core_update_addr(struct isp_core_output_channel *chan)
 	}else{
 		bank_id = current_bank;
 	}
-	if (chan->bank_flag[bank_id]) {
+	if (chan->drop_frame && chan->bank_flag[bank_id]) {
+		/* keep the buffer in its bank, the next frame overwrites it */
+		chan->reposted_cnt++;
+	} else if (chan->bank_flag[bank_id]) {
 		buf.addr = chan->banks_addr[bank_id];
 		buf.priv = core->frame_sequeue;
 		tx_isp_send_event_to_remote(chan->pad, TX_ISP_EVENT_FRAME_CHAN_DQUEUE_BUFFER, &buf);
 		chan->bank_flag[bank_id] = 0;
 	} else {
+		tx_isp_fifo_underrun(&chan->fifo);
+		tx_isp_trace_drop(TX_ISP_TRACE_CORE, TX_ISP_DROP_NO_BUFFER);
 		tx_isp_send_event_to_remote(chan->pad, TX_ISP_EVENT_FRAME_CHAN_DQUEUE_BUFFER, NULL);
 	}
+	chan->drop_frame = 0;
 
 	next_bank = (current_bank + 1) % chan->usingbanks;
 	if (chan->bank_flag[next_bank] != 1) {
@@ -493,6 +462,21 @@ static inline void isp_core_update_addr(struct isp_core_output_channel *chan)
 	}
 	return;
 }
+static struct tx_isp_core_device *g_core = NULL;
+/* called by the VIC when it resets on an input error */
+void tx_isp_core_drop_frame(void)
+{
+	struct tx_isp_core_device *core = g_core;
+	int index = 0;
+
+	if (core == NULL || core->state != TX_ISP_MODULE_RUNNING)
+		return;
+	for (index = 0; index < core->num_chans; index++) {
+		if (core->chans[index].state == TX_ISP_MODULE_RUNNING)
+			core->chans[index].drop_frame = 1;
+	}
+}
+
 static char g_switch_lfb_off = 0;
 static char g_switch_lfb_on = 0;
 extern void tx_isp_sync_ldc(void);
@@ -519,6 +503,8 @@ static irqreturn_t ispcore_interrupt_service_routine(struct tx_isp_subdev *sd, u
 						isp_configure_base_addr(core);
 						core->frame_state = 1;
 						core->frame_sequeue++;
+						if (core->tuning)
+							core->tuning->event(core->tuning, TX_ISP_EVENT_CORE_FRAME_START, NULL);
 						ret = IRQ_WAKE_THREAD;
 						break;
 					case APICAL_IRQ_FRAME_WRITER_FR:
@@ -561,6 +547,8 @@ static irqreturn_t ispcore_interrupt_service_routine(struct tx_isp_subdev *sd, u
 						/*printk("^~^ frame done ^~^\n");*/
 						chan = &core->chans[ISP_FR_VIDEO_CHANNEL];
 						core->frame_state = 0;
+						tx_isp_trace_stamp(TX_ISP_TRACE_CORE);
+						tx_isp_trace_fifo_depth(TX_ISP_TRACE_CORE, &chan->fifo);
 						isp_configure_base_addr(core);
 						isp_modify_dma_direction(chan);
 						if (chan->dma_state != 1) {
@@ -1132,11 +1120,26 @@ static int ispcore_frame_channel_set_crop(struct isp_core_output_channel *chan,
 
 static int ispcore_frame_channel_set_scaler(struct isp_core_output_channel *chan, struct frame_image_format *fmt)
 {
+	struct tx_isp_core_device *core = chan->priv;
 	apical_api_control_t api;
 	unsigned int index;
+	unsigned int size[4];
 	unsigned char status = 0;
 	int ret = ISP_SUCCESS;
 
+	if (fmt && fmt->scaler_enable) {
+		size[0] = fmt->crop_enable ? fmt->crop_width : core->contrl.inwidth;
+		size[1] = fmt->crop_enable ? fmt->crop_height : core->contrl.inheight;
+		size[2] = fmt->scaler_out_width;
+		size[3] = fmt->scaler_out_height;
+		/* the firmware already runs this ratio, don't reset the scaler */
+		if (chan->scaler_valid && !memcmp(size, chan->scaler_size, sizeof(size))) {
+			chan->scaler_skipped++;
+			return ISP_SUCCESS;
+		}
+	}
+	chan->scaler_valid = false;
+
 	switch (chan->index) {
 		case ISP_DS1_VIDEO_CHANNEL:
 			apical_isp_top_bypass_ds1_scaler_write((fmt && fmt->scaler_enable)?0:1);
@@ -1188,6 +1191,10 @@ static int ispcore_frame_channel_set_scaler(struct isp_core_output_channel *chan
 		api.id = IMAGE_RESIZE_ENABLE_ID;
 		status = apical_command(api.type, api.id, api.value, api.dir, &ret);
 		//	printk("[%d]apical command: status = %d, ret = 0x%08x\n",__LINE__, status, ret);	return ret;
+		if (ret == ISP_SUCCESS) {
+			memcpy(chan->scaler_size, size, sizeof(size));
+			chan->scaler_valid = true;
+		}
 
 	} else {
 		api.value = (index << 16) + DISABLE;
@@ -1260,6 +1267,7 @@ static int ispcore_frame_channel_streamon(struct tx_isp_subdev_pad *pad)
 	memset(chan->vflip_flag, 0 ,sizeof(chan->vflip_flag));
 	memset(chan->banks_addr, 0 ,sizeof(chan->banks_addr));
 	chan->dma_state = 0;
+	chan->drop_frame = 0;
 	chan->vflip_state = 0xff;
 	chan->state = TX_ISP_MODULE_ACTIVATE;
 
@@ -1389,7 +1397,7 @@ static int ispcore_frame_channel_streamoff(struct tx_isp_subdev_pad *pad)
 	private_spin_lock_irqsave(&chan->slock, flags);
 	chan->state = TX_ISP_MODULE_ACTIVATE;
 	pad->state = TX_ISP_PADSTATE_LINKED;
-	cleanup_buffer_fifo(&chan->fifo);
+	tx_isp_fifo_flush(&chan->fifo);
 	cleanup_chan_banks(chan);
 	private_spin_unlock_irqrestore(&chan->slock, flags);
 
@@ -1423,7 +1431,7 @@ static int ispcore_frame_channel_qbuf(struct tx_isp_subdev_pad *pad, void *data)
 	/*printk("## %s %d buf = 0x%08x ##\n", __func__,__LINE__, buf->addr);*/
 	if (buf && chan) {
 		private_spin_lock_irqsave(&chan->slock, flags);
-		push_buffer_fifo(&chan->fifo, buf);
+		tx_isp_fifo_push(&chan->fifo, buf);
 		private_spin_unlock_irqrestore(&chan->slock, flags);
 	}
 	return 0;
@@ -1441,7 +1449,7 @@ static int ispcore_frame_channel_freebufs(struct tx_isp_subdev_pad *pad, void *d
 	chan = pad->priv;
 	if (chan) {
 		private_spin_lock_irqsave(&chan->slock, flags);
-		cleanup_buffer_fifo(&chan->fifo);
+		tx_isp_fifo_flush(&chan->fifo);
 		private_spin_unlock_irqrestore(&chan->slock, flags);
 	}
 	return 0;
@@ -1485,6 +1493,7 @@ static int ispcore_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *da
 	struct v4l2_mbus_framefmt *mbus = NULL;
 	unsigned int width = 0;
 	unsigned int height = 0;
+	unsigned long long start = private_sched_clock();
 	int ret = 0;
 
 	if (IS_ERR_OR_NULL(core)) {
@@ -1574,6 +1583,7 @@ static int ispcore_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *da
 		goto failed_s_fmt;
 	}
 	chan->fmt = *fmt;
+	chan->reconfig_us = div_u64(private_sched_clock() - start, 1000);
 	return 0;
 failed_s_fmt:
 	if (fmt->scaler_enable)
@@ -1630,6 +1640,11 @@ static int ispcore_pad_event_handle(struct tx_isp_subdev_pad *pad, unsigned int
 		case TX_ISP_EVENT_FRAME_CHAN_SET_BANKS:
 			ret = ispcore_frame_channel_s_banks(pad, data);
 			break;
+		case TX_ISP_EVENT_FRAME_CHAN_SET_RATE:
+		case TX_ISP_EVENT_FRAME_CHAN_SET_ROI:
+			/* the isp dma can't change them while streaming */
+			ret = -ENOIOCTLCMD;
+			break;
 		default:
 			break;
 	}
@@ -1972,6 +1987,7 @@ static int ispcore_core_ops_init(struct tx_isp_subdev *sd, int on)
 {
 	struct tx_isp_core_device *core = IS_ERR_OR_NULL(sd) ? NULL : tx_isp_get_subdevdata(sd);
 	unsigned long flags = 0;
+	int i = 0;
 	int ret = ISP_SUCCESS;
 
 	if (IS_ERR_OR_NULL(core)) {
@@ -1988,6 +2004,9 @@ static int ispcore_core_ops_init(struct tx_isp_subdev *sd, int on)
 			ret = -EINVAL;
 			goto exit;
 		}
+		/* the firmware is restarted below, forget the programmed scalers */
+		for (i = 0; i < core->num_chans; i++)
+			core->chans[i].scaler_valid = false;
 
 		private_spin_lock_irqsave(&core->slock, flags);
 		if (core->state != TX_ISP_MODULE_ACTIVATE) {
@@ -1999,6 +2018,8 @@ static int ispcore_core_ops_init(struct tx_isp_subdev *sd, int on)
 		private_spin_unlock_irqrestore(&core->slock, flags);
 
 		core->param = load_tx_isp_parameters(core->vin.attr);
+		if (core->tuning)
+			core->tuning->event(core->tuning, TX_ISP_EVENT_CORE_DN_PREPARE, NULL);
 		apical_init();
 #if ISP_HAS_STREAM_CONNECTION
 		apical_connection_init();
@@ -2276,7 +2297,7 @@ static int isp_core_output_channel_init(struct tx_isp_core_device *core)
 		chan->state = TX_ISP_MODULE_SLAKE;
 		chan->min_width = 128;
 		chan->min_height = 128;
-		init_buffer_fifo(&(chan->fifo));
+		tx_isp_fifo_init(&(chan->fifo));
 		private_spin_lock_init(&(chan->slock));
 		chan->priv = core;
 		sd->outpads[index].event = ispcore_pad_event_handle;
@@ -2333,6 +2354,7 @@ static int isp_info_show(struct seq_file *m, void *v)
 	unsigned int sharpness = 0;
 	unsigned int brightness = 0;
 	int ret = 0;
+	int i = 0;
 	uint8_t evtolux = 0;
 
 	len += seq_printf(m ,"****************** ISP INFO **********************\n");
@@ -2459,6 +2481,20 @@ static int isp_info_show(struct seq_file *m, void *v)
 	len += seq_printf(m ,"SENSOR Integration Time : %d lines\n", stab.global_integration_time);
 	len += seq_printf(m ,"ISP Top Value : 0x%x\n", APICAL_READ_32(0x40));
 	len += seq_printf(m ,"ISP Runing Mode : %s\n", ((apical_isp_ds1_cs_conv_clip_min_uv_read() == 512) ? "Night" : "Day"));
+	if (core->tuning) {
+		len += seq_printf(m ,"ISP Day/Night switch : %u times\n", core->tuning->dn.count);
+		len += seq_printf(m ,"ISP Day/Night switch latency : %u frames, %u us\n",
+				  core->tuning->dn.last_frames, core->tuning->dn.last_us);
+		len += seq_printf(m ,"ISP Day/Night switch apply : %u us (max %u us)\n",
+				  core->tuning->dn.apply_us, core->tuning->dn.max_apply_us);
+	}
+	for (i = 0; i < core->num_chans; i++) {
+		len += seq_printf(m ,"ISP chan%d reconfig : %u us, %u scaler reloads skipped\n",
+				  i, core->chans[i].reconfig_us, core->chans[i].scaler_skipped);
+		len += seq_printf(m ,"ISP chan%d reposted frames : %u\n", i, core->chans[i].reposted_cnt);
+		len += seq_printf(m ,"ISP chan%d fifo : high water %u, underrun %u\n", i,
+				  core->chans[i].fifo.high_water, core->chans[i].fifo.underrun);
+	}
 	len += seq_printf(m ,"ISP OUTPUT FPS : %d / %d\n", vin->fps >> 16, vin->fps & 0xffff);
 	len += seq_printf(m ,"SENSOR analog gain : %d\n", sensor_again);
 	len += seq_printf(m ,"MAX SENSOR analog gain : %d\n", max_sensor_again);
@@ -2592,6 +2628,7 @@ static int tx_isp_core_probe(struct platform_device *pdev)
 	core_dev->state = TX_ISP_MODULE_SLAKE;
 	private_platform_set_drvdata(pdev, &sd->module);
 	tx_isp_set_subdevdata(sd, core_dev);
+	g_core = core_dev;
 	tx_isp_set_module_nodeops(&sd->module, core_dev->tuning->fops);
 	tx_isp_set_subdev_debugops(sd, &isp_info_proc_fops);
 
@@ -2617,6 +2654,7 @@ static int __exit tx_isp_core_remove(struct platform_device *pdev)
 	struct tx_isp_subdev *sd = module_to_subdev(module);
 	struct tx_isp_core_device *core = tx_isp_get_subdevdata(sd);
 
+	g_core = NULL;
 	if (core->tuning) {
 		isp_core_tuning_deinit(core->tuning);
 		core->tuning = NULL;
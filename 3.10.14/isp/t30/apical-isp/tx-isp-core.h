@@ -90,7 +90,7 @@ struct isp_core_output_channel {
 	unsigned int min_height;
 	bool	has_crop;
 	bool	has_scaler;
-	struct list_head fifo;
+	struct tx_isp_fifo fifo;
 	spinlock_t slock;
 	unsigned char bank_flag[ISP_DMA_WRITE_MAXBASE_NUM];
 	unsigned char vflip_flag[ISP_DMA_WRITE_MAXBASE_NUM];
@@ -100,6 +100,13 @@ struct isp_core_output_channel {
 	unsigned char reset_dma_flag;
 	unsigned char vflip_state;
 	unsigned char usingbanks;
+	unsigned char drop_frame;	/* the frame in flight was broken by VIC */
+	unsigned int reposted_cnt;
+	/* the scaler in/out size last given to the firmware */
+	unsigned int scaler_size[4];
+	bool	scaler_valid;
+	unsigned int scaler_skipped;
+	unsigned int reconfig_us;
 };
 
 struct tx_isp_core_device {
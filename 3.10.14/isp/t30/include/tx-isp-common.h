@@ -330,11 +330,15 @@ enum tx_isp_notification {
 	TX_ISP_EVENT_FRAME_CHAN_DQUEUE_BUFFER,
 	TX_ISP_EVENT_FRAME_CHAN_FREE_BUFFER,
 	TX_ISP_EVENT_FRAME_CHAN_SET_BANKS,
+	TX_ISP_EVENT_FRAME_CHAN_SET_RATE,
+	TX_ISP_EVENT_FRAME_CHAN_SET_ROI,
 	/* the tuning node of isp's core */
 	TX_ISP_EVENT_ACTIVATE_MODULE = NOTIFICATION_TYPE_TUN_OPS,
 	TX_ISP_EVENT_SLAVE_MODULE,
 	TX_ISP_EVENT_CORE_FRAME_DONE,
 	TX_ISP_EVENT_CORE_DAY_NIGHT,
+	TX_ISP_EVENT_CORE_FRAME_START,
+	TX_ISP_EVENT_CORE_DN_PREPARE,
 };
 
 struct tx_isp_notify_argument{
@@ -359,6 +363,18 @@ struct isp_image_tuning_default_ctrl {
 	struct v4l2_control control;
 };
 
+/*
+ * A batch of tuning controls committed together at the next frame start.
+ * The whole batch is rejected if any control fails validation; status[i]
+ * holds the result of controls[i] either way.
+ */
+#define ISP_TUNING_BATCH_MAX_CTRLS	32
+struct isp_image_tuning_batch_ctrl {
+	unsigned int count;
+	struct v4l2_control controls[ISP_TUNING_BATCH_MAX_CTRLS];
+	int status[ISP_TUNING_BATCH_MAX_CTRLS];
+};
+
 /**
  * struct frame_image_format
  * @type:	enum v4l2_buf_type; type of the data stream
@@ -383,6 +399,24 @@ struct frame_image_format {
 	unsigned int rate_mask;
 };
 
+/* the channel outputs num of every den frames, 1 <= num <= den <= 32 */
+struct frame_image_rate {
+	unsigned int num;
+	unsigned int den;
+};
+
+/*
+ * A new window of a running channel, the output size doesn't change:
+ * the input is scaled to scaler_out (0 means no scaling), then the
+ * output size is cropped at crop_left/crop_top.
+ */
+struct frame_image_roi {
+	unsigned int scaler_out_width;
+	unsigned int scaler_out_height;
+	unsigned int crop_left;
+	unsigned int crop_top;
+};
+
 #define ISP_LFB_DEFAULT_BUF_BASE0 0xf0000000
 #define ISP_LFB_DEFAULT_BUF_BASE1 0xf8000000
 enum tx_isp_module_link_id {
@@ -397,6 +431,9 @@ enum tx_isp_module_link_id {
 #define VIDIOC_GET_FRAME_FORMAT		_IOR('V', BASE_VIDIOC_PRIVATE + 4, struct frame_image_format)
 #define VIDIOC_DEFAULT_CMD_SET_BANKS	_IOW('V', BASE_VIDIOC_PRIVATE + 5, int)
 #define VIDIOC_DEFAULT_CMD_ISP_TUNING	_IOWR('V', BASE_VIDIOC_PRIVATE + 6, struct isp_image_tuning_default_ctrl)
+#define VIDIOC_DEFAULT_CMD_ISP_TUNING_BATCH	_IOWR('V', BASE_VIDIOC_PRIVATE + 7, struct isp_image_tuning_batch_ctrl)
+#define VIDIOC_SET_FRAME_RATE		_IOW('V', BASE_VIDIOC_PRIVATE + 8, struct frame_image_rate)
+#define VIDIOC_SET_FRAME_ROI		_IOW('V', BASE_VIDIOC_PRIVATE + 9, struct frame_image_roi)
 
 #define VIDIOC_CREATE_SUBDEV_LINKS	_IOW('V', BASE_VIDIOC_PRIVATE + 16, int)
 #define VIDIOC_DESTROY_SUBDEV_LINKS	_IOW('V', BASE_VIDIOC_PRIVATE + 17, int)
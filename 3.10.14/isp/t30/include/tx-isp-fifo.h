@@ -0,0 +1,102 @@
+#ifndef __TX_ISP_FIFO_H__
+#define __TX_ISP_FIFO_H__
+
+#include <linux/compiler.h>
+#include <linux/errno.h>
+#include <asm/barrier.h>
+
+/*
+ * Buffer fifo shared by the modules of the ISP graph.
+ *
+ * A fixed ring of frame_channel_buffer pointers, so queueing a buffer
+ * never allocates and never touches the buffer itself. head is only
+ * written by the producer and tail only by the consumer, so a single
+ * producer and a single consumer may run concurrently, e.g. qbuf against
+ * the interrupt handler. A fifo with more than one producer or consumer
+ * (flushing on stream off) still needs the lock of its owner.
+ */
+#define TX_ISP_FIFO_SIZE	64	/* must be power of 2 */
+
+struct frame_channel_buffer;
+
+struct tx_isp_fifo {
+	struct frame_channel_buffer *slots[TX_ISP_FIFO_SIZE];
+	volatile unsigned int head;
+	volatile unsigned int tail;
+
+	/* statistics */
+	unsigned int high_water;	/* the deepest the fifo has been */
+	unsigned int underrun;		/* the hardware needed a buffer, none was queued */
+	unsigned int overrun;		/* pushes refused because it was full */
+};
+
+static inline void tx_isp_fifo_init(struct tx_isp_fifo *fifo)
+{
+	fifo->head = 0;
+	fifo->tail = 0;
+	fifo->high_water = 0;
+	fifo->underrun = 0;
+	fifo->overrun = 0;
+}
+
+static inline unsigned int tx_isp_fifo_depth(struct tx_isp_fifo *fifo)
+{
+	return fifo->head - fifo->tail;
+}
+
+static inline int tx_isp_fifo_empty(struct tx_isp_fifo *fifo)
+{
+	return fifo->head == fifo->tail;
+}
+
+static inline int tx_isp_fifo_push(struct tx_isp_fifo *fifo, struct frame_channel_buffer *buf)
+{
+	unsigned int depth = fifo->head - fifo->tail;
+
+	if(depth >= TX_ISP_FIFO_SIZE){
+		fifo->overrun++;
+		return -ENOSPC;
+	}
+	fifo->slots[fifo->head & (TX_ISP_FIFO_SIZE - 1)] = buf;
+	smp_wmb();
+	fifo->head++;
+	if(depth + 1 > fifo->high_water)
+		fifo->high_water = depth + 1;
+	return 0;
+}
+
+static inline struct frame_channel_buffer *tx_isp_fifo_pop(struct tx_isp_fifo *fifo)
+{
+	struct frame_channel_buffer *buf = NULL;
+
+	if(fifo->head == fifo->tail)
+		return NULL;
+	smp_rmb();
+	buf = fifo->slots[fifo->tail & (TX_ISP_FIFO_SIZE - 1)];
+	smp_mb();
+	fifo->tail++;
+	return buf;
+}
+
+/*
+ * An empty fifo is normal while a stage waits for its producer, so only
+ * the consumer knows when it actually starved.
+ */
+static inline void tx_isp_fifo_underrun(struct tx_isp_fifo *fifo)
+{
+	fifo->underrun++;
+}
+
+/* drop every queued buffer, it belongs to the consumer side */
+static inline void tx_isp_fifo_flush(struct tx_isp_fifo *fifo)
+{
+	fifo->tail = fifo->head;
+}
+
+#define tx_isp_fifo_for_each(fifo, index, buf)					\
+	for ((index) = (fifo)->tail;						\
+	     (index) != (fifo)->head &&						\
+	     ((buf) = (fifo)->slots[(index) & (TX_ISP_FIFO_SIZE - 1)], 1);	\
+	     (index)++)
+
+#endif /* __TX_ISP_FIFO_H__ */
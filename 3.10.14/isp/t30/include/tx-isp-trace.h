@@ -0,0 +1,53 @@
+#ifndef __TX_ISP_TRACE_H__
+#define __TX_ISP_TRACE_H__
+
+#include <linux/proc_fs.h>
+#include <tx-isp-fifo.h>
+
+/*
+ * Per-frame pipeline trace.
+ *
+ * VIC frame done opens a new record in a small ring; every later stage
+ * stamps the oldest record it has not seen yet, so a stage that falls
+ * behind is still charged against the frame it is actually working on.
+ * Latency of a stage is measured from the VIC frame done of its record.
+ * The output stages see a frame once per channel, so they keep a cursor
+ * per channel and a channel skipping frames for its rate steps over them.
+ * All hooks run in interrupt context and cost a clock read plus a few
+ * counter updates, so the trace is enabled by default.
+ */
+enum tx_isp_trace_stage {
+	TX_ISP_TRACE_VIC,
+	TX_ISP_TRACE_CORE,
+	TX_ISP_TRACE_LDC,
+	TX_ISP_TRACE_NCU,
+	TX_ISP_TRACE_MSCALER,
+	TX_ISP_TRACE_FRAME_CHAN,
+	TX_ISP_TRACE_STAGE_MAX,
+};
+
+enum tx_isp_trace_drop {
+	TX_ISP_DROP_VIC_ERROR,		/* VIC reported a frame error */
+	TX_ISP_DROP_NO_BUFFER,		/* a stage found its buffer fifo empty */
+	TX_ISP_DROP_LDC_RESET,		/* ldc watchdog reset the engine */
+	TX_ISP_DROP_NCU_RESET,		/* ncu watchdog reset the engine */
+	TX_ISP_DROP_CHAN_UNMATCHED,	/* frame channel got an unknown buffer */
+	TX_ISP_DROP_CAUSE_MAX,
+};
+
+#define TX_ISP_TRACE_RING_SIZE		32	/* must be power of 2 */
+#define TX_ISP_TRACE_HIST_BUCKETS	16	/* log2(us), last bucket is open */
+#define TX_ISP_TRACE_CHANS		4	/* output channels of mscaler and frame channels */
+
+void tx_isp_trace_stamp(enum tx_isp_trace_stage stage);
+void tx_isp_trace_depth(enum tx_isp_trace_stage stage, unsigned int depth);
+void tx_isp_trace_fifo_depth(enum tx_isp_trace_stage stage, struct tx_isp_fifo *fifo);
+void tx_isp_trace_drop(enum tx_isp_trace_stage stage, enum tx_isp_trace_drop cause);
+void tx_isp_trace_stamp_chan(enum tx_isp_trace_stage stage, unsigned int chan);
+void tx_isp_trace_skip_chan(enum tx_isp_trace_stage stage, unsigned int chan);
+void tx_isp_trace_drop_chan(enum tx_isp_trace_stage stage, unsigned int chan,
+		enum tx_isp_trace_drop cause);
+void tx_isp_trace_start_chan(unsigned int chan);
+
+int tx_isp_trace_proc_init(struct proc_dir_entry *parent);
+#endif /* __TX_ISP_TRACE_H__ */
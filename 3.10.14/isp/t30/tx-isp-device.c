@@ -24,6 +24,7 @@
 #include <tx-isp-common.h>
 #include "tx-isp-interrupt.h"
 #include "tx-isp-debug.h"
+#include "tx-isp-trace.h"
 #include "videoin/tx-isp-vic.h"
 #include "videoin/tx-isp-csi.h"
 #include "videoin/tx-isp-video-in.h"
@@ -1327,6 +1328,7 @@ static int tx_isp_probe(struct platform_device *pdev)
 	if(ret){
 		goto failed_to_nodes;
 	}
+	tx_isp_trace_proc_init(ispdev->proc);
 
 	isp_mem_init();
 	/*isp_debug_init();*/
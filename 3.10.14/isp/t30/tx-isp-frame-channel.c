@@ -28,6 +28,7 @@
 #include "tx-isp-frame-channel.h"
 #include "tx-isp-videobuf.h"
 #include "tx-isp-debug.h"
+#include <tx-isp-trace.h>
 
 #define V4L2_BUFFER_MASK_FLAGS	(V4L2_BUF_FLAG_MAPPED | V4L2_BUF_FLAG_QUEUED | \
 				 V4L2_BUF_FLAG_DONE | V4L2_BUF_FLAG_ERROR | \
@@ -57,6 +58,8 @@ static int frame_channel_buffer_done(struct tx_isp_frame_channel *chan, void *ar
 	if(vb && vb->state == FS_VB2_BUF_STATE_ACTIVE){
 		struct timespec ts;
 		getrawmonotonic(&ts);
+		tx_isp_trace_stamp_chan(TX_ISP_TRACE_FRAME_CHAN, chan->index);
+		tx_isp_trace_depth(TX_ISP_TRACE_FRAME_CHAN, q->queued_count);
 
 		vb->v4l2_buf.timestamp.tv_sec = ts.tv_sec;
 		vb->v4l2_buf.timestamp.tv_usec = ts.tv_nsec / 1000;
@@ -82,6 +85,7 @@ static int frame_channel_buffer_done(struct tx_isp_frame_channel *chan, void *ar
 	//	printk("bufdone chan%d buf.index = %d\n", chan->index, buf->vb.v4l2_buf.index);
 	}else{
 		chan->losed_frames++;
+		tx_isp_trace_drop_chan(TX_ISP_TRACE_FRAME_CHAN, chan->index, TX_ISP_DROP_CHAN_UNMATCHED);
 	}
 
 	return 0;
@@ -1091,6 +1095,52 @@ done:
 	return ret;
 }
 
+static long frame_channel_vidioc_set_rate(struct tx_isp_frame_channel *chan, unsigned long arg)
+{
+	struct frame_image_rate rate;
+	long ret = 0;
+
+	if(IS_ERR_OR_NULL(chan)){
+		return -EINVAL;
+	}
+
+	ret = copy_from_user(&rate, (void __user *)arg, sizeof(rate));
+	if(ret){
+		ISP_ERROR("Failed to copy from user\n");
+		return -ENOMEM;
+	}
+
+	ret = tx_isp_send_event_to_remote(chan->pad, TX_ISP_EVENT_FRAME_CHAN_SET_RATE, &rate);
+	if(ret == -ENOIOCTLCMD){
+		ISP_ERROR("The frame chan%d can't drop frames!\n", chan->index);
+		return -EPERM;
+	}
+	return ret;
+}
+
+static long frame_channel_vidioc_set_roi(struct tx_isp_frame_channel *chan, unsigned long arg)
+{
+	struct frame_image_roi roi;
+	long ret = 0;
+
+	if(IS_ERR_OR_NULL(chan)){
+		return -EINVAL;
+	}
+
+	ret = copy_from_user(&roi, (void __user *)arg, sizeof(roi));
+	if(ret){
+		ISP_ERROR("Failed to copy from user\n");
+		return -ENOMEM;
+	}
+
+	ret = tx_isp_send_event_to_remote(chan->pad, TX_ISP_EVENT_FRAME_CHAN_SET_ROI, &roi);
+	if(ret == -ENOIOCTLCMD){
+		ISP_ERROR("The frame chan%d can't move its window!\n", chan->index);
+		return -EPERM;
+	}
+	return ret;
+}
+
 static long frame_channel_unlocked_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	struct miscdevice *mdev = file->private_data;
@@ -1104,6 +1154,12 @@ static long frame_channel_unlocked_ioctl(struct file *file, unsigned int cmd, un
 		case VIDIOC_GET_FRAME_FORMAT:
 			ret = frame_channel_vidioc_get_fmt(chan, arg);
 			break;
+		case VIDIOC_SET_FRAME_RATE:
+			ret = frame_channel_vidioc_set_rate(chan, arg);
+			break;
+		case VIDIOC_SET_FRAME_ROI:
+			ret = frame_channel_vidioc_set_roi(chan, arg);
+			break;
 		case VIDIOC_REQBUFS:
 			ret = frame_channel_reqbufs(chan, arg);
 			break;
@@ -8,8 +8,12 @@
 #include <linux/proc_fs.h>
 
 #include <tx-isp-common.h>
+#include <tx-isp-fifo.h>
 
 #define ISP_VIDEO_MAX_FRAME 64
+#if ISP_VIDEO_MAX_FRAME > TX_ISP_FIFO_SIZE
+#error "the module fifos must hold every frame channel buffer"
+#endif
 /**
  * enum fs_vb2_buffer_state - current video buffer state
  * @FS_VB2_BUF_STATE_DEQUEUED:	buffer under userspace control
@@ -10,16 +10,20 @@
 #include <linux/delay.h>
 #include <asm/mipsregs.h>
 #include <linux/clk.h>
+#include <linux/crc32.h>
+#include <linux/firmware.h>
 #include <tx-isp-list.h>
 #include "tx-isp-ldc.h"
 #include "tx-isp-frame-channel.h"
 #include "tx-isp-videobuf.h"
+#include <tx-isp-trace.h>
 
 static int isp_m1_bufs = 2;
 module_param(isp_m1_bufs, int, S_IRUGO);
 MODULE_PARM_DESC(isp_m1_bufs, "isp m1 inter buffers");
 
-static char ldc_params_version[16] = "20190610a";
+#define LDC_DEFAULT_VERSION "20190610a"
+static char ldc_params_version[16] = LDC_DEFAULT_VERSION;
 tx_isp_ldc_opt *ldc_user_params = NULL;
 tx_isp_ldc_opt ldc_default_params[] = {
 	/* 1280x720 */
@@ -180,43 +184,6 @@ static unsigned int ldc_params_nums = ARRAY_SIZE(ldc_default_params);
    manager the buffer of frame channels
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
  */
-static inline void init_buffer_fifo(struct list_head *fifo)
-{
-	TX_INIT_LIST_HEAD(fifo);
-}
-
-static struct frame_channel_buffer *pop_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	if(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}else
-		buf = NULL;
-
-	return buf;
-}
-
-static void inline push_buffer_fifo(struct list_head *fifo, struct frame_channel_buffer *buf)
-{
-	//	printk("^@^ %s %d %p %p^-^\n",__func__,__LINE__, fifo, buf);
-	tx_list_add_tail(&(buf->entry), fifo);
-}
-
-static void inline cleanup_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	while(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}
-}
-
-static int inline is_empty_fifo(struct list_head *fifo)
-{
-	return tx_list_empty(fifo);
-}
-
 static struct frame_channel_buffer *addr_to_inbuf(struct tx_isp_ldc_device *ldc, unsigned int addr)
 {
 	struct frame_channel_buffer *buf = NULL;
@@ -231,44 +198,86 @@ static struct frame_channel_buffer *addr_to_inbuf(struct tx_isp_ldc_device *ldc,
 	return buf;
 }
 
+static void ldc_stage_buffers(struct tx_isp_ldc_device *ldc)
+{
+	if(ldc->next_inbuf || tx_isp_fifo_empty(&ldc->outfifo) || tx_isp_fifo_empty(&ldc->infifo))
+		return;
+	ldc->next_outbuf = tx_isp_fifo_pop(&ldc->outfifo);
+	ldc->next_inbuf = tx_isp_fifo_pop(&ldc->infifo);
+}
+
+/*
+ * Give the staged pair back before the output fifo is flushed. The input
+ * buffer goes to the tail of infifo, the order of frames doesn't matter
+ * any more once the outputs are being freed.
+ */
+static void ldc_unstage_buffers(struct tx_isp_ldc_device *ldc)
+{
+	if(ldc->next_inbuf){
+		tx_isp_fifo_push(&ldc->infifo, ldc->next_inbuf);
+		tx_isp_fifo_push(&ldc->outfifo, ldc->next_outbuf);
+	}
+	ldc->next_inbuf = NULL;
+	ldc->next_outbuf = NULL;
+	ldc->idle_since = 0;
+}
+
 static void ldc_restart_module(struct tx_isp_ldc_device *ldc)
 {
 	struct frame_channel_buffer *tmp = NULL;
-#if 0
-	tx_isp_reg_set(&ldc->sd, LDC_CTR, 1, 1, 1); // reset ldc
-
-	tx_isp_sd_writel(&ldc->sd, LDC_CTR, ldc->regs.ctrl);
-	tx_isp_sd_writel(&ldc->sd, LDC_RES_VAL, ldc->regs.resolution);
-	tx_isp_sd_writel(&ldc->sd, LDC_DIS_COEFFX, ldc->regs.coef_x);
-	tx_isp_sd_writel(&ldc->sd, LDC_DIS_COEFFY, ldc->regs.coef_y);
-	tx_isp_sd_writel(&ldc->sd, LDC_UDIS_R, ldc->regs.udis_r);
-	tx_isp_sd_writel(&ldc->sd, LDC_LINE_LEN, ldc->regs.len);
-	tx_isp_sd_writel(&ldc->sd, LDC_P1_VAL, ldc->regs.p1);
-	tx_isp_sd_writel(&ldc->sd, LDC_R2_REP, ldc->regs.r2);
-	tx_isp_sd_writel(&ldc->sd, LDC_FILL_VAL, ldc->regs.fill);
-	tx_isp_sd_writel(&ldc->sd, LDC_Y_IN_STR, ldc->regs.stride);
-	tx_isp_sd_writel(&ldc->sd, LDC_UV_IN_STR, ldc->regs.stride);
-	tx_isp_sd_writel(&ldc->sd, LDC_Y_OUT_STR, ldc->regs.stride);
-	tx_isp_sd_writel(&ldc->sd, LDC_UV_OUT_STR, ldc->regs.stride);
-#endif
-	if(!is_empty_fifo(&ldc->outfifo) && !is_empty_fifo(&ldc->infifo)){
-		tmp = pop_buffer_fifo(&ldc->outfifo);
-		tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAOUT, tmp->addr);
-		tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAOUT, tmp->addr + ldc->uv_offset);
-		/*printk("%s[%d]: outbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);*/
-		ldc->cur_outbuf = tmp;
-		tmp = pop_buffer_fifo(&ldc->infifo);
-		tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAIN, tmp->addr);
-		tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAIN, tmp->addr + ldc->uv_offset);
-		/*printk("%s[%d]: inbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);*/
-		ldc->cur_inbuf = tmp;
-		tx_isp_reg_set(&ldc->sd, LDC_CTR, 0, 0, 1); // start ldc
-		ldc->frame_state = 1;
-		ldc->start_cnt++;
-	}
+
+	tmp = ldc->next_outbuf;
+	tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAOUT, tmp->addr);
+	tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAOUT, tmp->addr + ldc->uv_offset);
+	/*printk("%s[%d]: outbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);*/
+	ldc->cur_outbuf = tmp;
+	tmp = ldc->next_inbuf;
+	tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAIN, tmp->addr);
+	tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAIN, tmp->addr + ldc->uv_offset);
+	/*printk("%s[%d]: inbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);*/
+	ldc->cur_inbuf = tmp;
+	tx_isp_reg_set(&ldc->sd, LDC_CTR, 0, 0, 1); // start ldc
+	ldc->frame_state = 1;
+	ldc->start_cnt++;
+	ldc->next_outbuf = NULL;
+	ldc->next_inbuf = NULL;
 	return;
 }
 
+/*
+ * Start the LDC from whichever of frame done, qbuf and dqbuf finds it
+ * idle with a staged pair, and stage the next pair while it runs. An
+ * input frame that waits for an output buffer is counted as idle gap.
+ * It must be called in the ISR or with slock held.
+ */
+static void ldc_schedule(struct tx_isp_ldc_device *ldc)
+{
+	unsigned int gap = 0;
+
+	ldc_stage_buffers(ldc);
+	if(ldc->frame_state || ((tx_isp_sd_readl((&ldc->sd), LDC_SAT) & LDC_STAT_ST_MASK) == LDC_STAT_ST_RUN))
+		return;
+
+	if(ldc->next_inbuf == NULL){
+		if(!tx_isp_fifo_empty(&ldc->infifo) && !ldc->idle_since){
+			ldc->idle_since = private_sched_clock();
+			tx_isp_fifo_underrun(&ldc->outfifo);
+		}
+		return;
+	}
+
+	if(ldc->idle_since){
+		gap = div_u64(private_sched_clock() - ldc->idle_since, 1000);
+		ldc->idle_gap_us += gap;
+		ldc->idle_gap_cnt++;
+		if(gap > ldc->max_idle_gap_us)
+			ldc->max_idle_gap_us = gap;
+		ldc->idle_since = 0;
+	}
+	ldc_restart_module(ldc);
+	ldc_stage_buffers(ldc);
+}
+
 /*
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
    interrupt handler
@@ -281,6 +290,7 @@ static irqreturn_t ldc_core_interrupt_service_routine(struct tx_isp_subdev *sd,
 	unsigned int stat = tx_isp_sd_readl((&ldc->sd), LDC_SAT);
 
 	if(stat & LDC_STAT_FRAME_DONE){
+		tx_isp_trace_stamp(TX_ISP_TRACE_LDC);
 		tx_isp_send_event_to_remote(sd->outpads, TX_ISP_EVENT_FRAME_CHAN_DQUEUE_BUFFER, ldc->cur_outbuf);
 		ldc->cur_outbuf = NULL;
 		tx_isp_send_event_to_remote(sd->inpads, TX_ISP_EVENT_FRAME_CHAN_QUEUE_BUFFER, ldc->cur_inbuf);
@@ -290,27 +300,8 @@ static irqreturn_t ldc_core_interrupt_service_routine(struct tx_isp_subdev *sd,
 		/*printk("%s[%d]: \n",__func__,__LINE__);*/
 	}
 
-	if(ldc->state == TX_ISP_MODULE_RUNNING){
-		if(((stat & LDC_STAT_ST_MASK) != LDC_STAT_ST_RUN) && (!ldc->frame_state)){
-#if 0
-			if(!is_empty_fifo(&ldc->outfifo) && !is_empty_fifo(&ldc->infifo)){
-				tmp = pop_buffer_fifo(&ldc->outfifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAOUT, tmp->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAOUT, tmp->addr + ldc->uv_offset);
-    			printk("%s[%d]: outbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);
-				ldc->cur_outbuf = tmp;
-				tmp = pop_buffer_fifo(&ldc->infifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAIN, tmp->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAIN, tmp->addr + ldc->uv_offset);
-    			printk("%s[%d]: inbuf = 0x%08x\n",__func__,__LINE__,tmp->addr);
-				ldc->cur_inbuf = tmp;
-				tx_isp_reg_set(&ldc->sd, LDC_CTR, 0, 0, 1); // start ldc
-			}
-#else
-		ldc_restart_module(ldc);
-#endif
-		}
-	}
+	if(ldc->state == TX_ISP_MODULE_RUNNING)
+		ldc_schedule(ldc);
 
 	tx_isp_reg_set(&ldc->sd, LDC_SAT, 0, 0, 1); // clear interrupt
 
@@ -327,6 +318,7 @@ void tx_isp_sync_ldc(void)
 
 	if((ldc == NULL) || (ldc->state != TX_ISP_MODULE_RUNNING))
 		return;
+	tx_isp_trace_fifo_depth(TX_ISP_TRACE_LDC, &ldc->infifo);
 	if((tx_isp_last_done != ldc->done_cnt) || (ldc->start_cnt == ldc->done_cnt)){
 		tx_isp_last_done = ldc->done_cnt;
 		lost_cnt = 0;;
@@ -363,6 +355,7 @@ void tx_isp_sync_ldc(void)
 		ldc->frame_state = 1;
 		ldc->start_cnt++;
 		ldc->reset_cnt++;
+		tx_isp_trace_drop(TX_ISP_TRACE_LDC, TX_ISP_DROP_LDC_RESET);
 	}
 
 	tx_isp_sync_ncu();
@@ -384,36 +377,18 @@ static int ldc_frame_channel_dqbuf(struct tx_isp_subdev_pad *pad, void *data)
 	spin_lock_irqsave(&ldc->slock, flags);
 	if(tmp && ldc){
 		buf = addr_to_inbuf(ldc, tmp->addr);
+		/* the previous frame is still waiting for an output buffer */
+		if(buf && ldc->state == TX_ISP_MODULE_RUNNING && !ldc->frame_state
+				&& (ldc->next_inbuf || !tx_isp_fifo_empty(&ldc->infifo)))
+			ldc->missed_cnt++;
 		if(buf)
-			push_buffer_fifo(&ldc->infifo, buf);
+			tx_isp_fifo_push(&ldc->infifo, buf);
 		else
 			ISP_ERROR("Can't find the addr(0x%08x) in bufs\n", tmp->addr);
 	}
 
-	if(ldc->state == TX_ISP_MODULE_RUNNING){
-//		stat = tx_isp_sd_readl((&ldc->sd), LDC_SAT);
-  //  	printk("%s[%d]: stat = 0x%08x\n",__func__,__LINE__,stat);
-		if(((tx_isp_sd_readl((&ldc->sd), LDC_SAT) & LDC_STAT_ST_MASK)
-				!= LDC_STAT_ST_RUN)  && (!ldc->frame_state)){
-#if 0
-			if(!is_empty_fifo(&ldc->outfifo) && !is_empty_fifo(&ldc->infifo)){
-				buf = pop_buffer_fifo(&ldc->outfifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAOUT, buf->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAOUT, buf->addr + ldc->uv_offset);
-				ldc->cur_outbuf = buf;
-    			printk("%s[%d]: outbuf = 0x%08x\n",__func__,__LINE__,buf->addr);
-				buf = pop_buffer_fifo(&ldc->infifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAIN, buf->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAIN, buf->addr + ldc->uv_offset);
-				tx_isp_reg_set(&ldc->sd, LDC_CTR, 0, 0, 1); // start ldc
-    			printk("%s[%d]: inbuf = 0x%08x\n",__func__,__LINE__,buf->addr);
-				ldc->cur_inbuf = buf;
-			}
-#else
-		ldc_restart_module(ldc);
-#endif
-		}
-	}
+	if(ldc->state == TX_ISP_MODULE_RUNNING)
+		ldc_schedule(ldc);
 	spin_unlock_irqrestore(&ldc->slock, flags);
 
 	return 0;
@@ -432,31 +407,11 @@ static int ldc_frame_channel_qbuf(struct tx_isp_subdev_pad *pad, void *data)
 
 	spin_lock_irqsave(&ldc->slock, flags);
 	if(buf && ldc){
-		push_buffer_fifo(&ldc->outfifo, buf);
+		tx_isp_fifo_push(&ldc->outfifo, buf);
 	}
 
-	if(ldc->state == TX_ISP_MODULE_RUNNING){
-		if(((tx_isp_sd_readl((&ldc->sd), LDC_SAT) & LDC_STAT_ST_MASK)
-				!= LDC_STAT_ST_RUN) && (!ldc->frame_state)){
-#if 0
-			if(!is_empty_fifo(&ldc->infifo)){
-				buf = pop_buffer_fifo(&ldc->outfifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAOUT, buf->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAOUT, buf->addr + ldc->uv_offset);
-    			printk("%s[%d]: outbuf = 0x%08x\n",__func__,__LINE__,buf->addr);
-				ldc->cur_outbuf = buf;
-				buf = pop_buffer_fifo(&ldc->infifo);
-				tx_isp_sd_writel(&ldc->sd, LDC_Y_DMAIN, buf->addr);
-				tx_isp_sd_writel(&ldc->sd, LDC_UV_DMAIN, buf->addr + ldc->uv_offset);
-    			printk("%s[%d]: inbuf = 0x%08x\n",__func__,__LINE__,buf->addr);
-				ldc->cur_inbuf = buf;
-				tx_isp_reg_set(&ldc->sd, LDC_CTR, 0, 0, 1); // start ldc
-			}
-#else
-		ldc_restart_module(ldc);
-#endif
-		}
-	}
+	if(ldc->state == TX_ISP_MODULE_RUNNING)
+		ldc_schedule(ldc);
 	spin_unlock_irqrestore(&ldc->slock, flags);
 
 	return 0;
@@ -469,7 +424,8 @@ static int ldc_frame_channel_freebufs(struct tx_isp_subdev_pad *pad, void *data)
 
 	if(ldc){
 		private_spin_lock_irqsave(&ldc->slock, flags);
-		cleanup_buffer_fifo(&ldc->outfifo);
+		ldc_unstage_buffers(ldc);
+		tx_isp_fifo_flush(&ldc->outfifo);
 		private_spin_unlock_irqrestore(&ldc->slock, flags);
 	}
 	return 0;
@@ -516,88 +472,107 @@ static void ldc_clks_ops(struct tx_isp_subdev *sd, int on)
 	return;
 }
 
-static const unsigned int crc_table[8] = {
-	0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL,
-	0x076dc419L, 0x706af48fL, 0xe963a535L, 0x9e6495a3L,
-};
-
-static unsigned int crc32(const unsigned int *p, unsigned int len)
+/*
+ * The table is fetched by the firmware loader in the background, so
+ * neither streamon nor a read-only rootfs is affected. It is looked up
+ * as ldc_<sensor>.bin in the firmware search path (/lib/firmware or the
+ * firmware_class.path given on the command line). Until it arrives, or
+ * if it is missing or corrupt, ldc_default_params are used. A verified
+ * table stays cached until another sensor is selected.
+ */
+static void ldc_parse_parameters(const struct firmware *fw, void *context)
 {
-	int i = 0;
-	unsigned int crc = crc_table[0];
-	for(i = 0; i < len; i++){
-		crc ^= *p++;
-		crc = crc ^ crc_table[crc & 0x7];
+	struct tx_isp_ldc_device *ldc = context;
+	struct ldc_params_header *header;
+	unsigned long flags = 0;
+	unsigned int size = 0;
+	unsigned int crc = 0;
+	char *udata = NULL;
+
+	if(fw == NULL){
+		ISP_WRANING("%s isn't found; LDC will use default parameter!\n", ldc->fw_name);
+		goto exit;
+	}
+
+	header = (struct ldc_params_header *)fw->data;
+	if(fw->size < sizeof(*header) || header->flags != fw->size - sizeof(*header)
+			|| header->flags % sizeof(tx_isp_ldc_opt)){
+		ISP_WRANING("flags is error; LDC will use default parameter!\n");
+		goto release;
+	}
+	size = header->flags;
+
+	crc = crc32_le(~0, fw->data + sizeof(*header), size) ^ ~0;
+	if(header->crc != crc){
+		ISP_WRANING("crc is error; LDC will use default parameter!\n");
+		goto release;
+	}
+
+	udata = kmalloc(size, GFP_KERNEL);
+	if(udata == NULL){
+		ISP_ERROR("%s[%d]: Failed to alloc %d KB buffer!\n",__func__,__LINE__, size >> 10);
+		goto release;
 	}
+	memcpy(udata, fw->data + sizeof(*header), size);
+
+	private_spin_lock_irqsave(&ldc->slock, flags);
+	ldc->udata = udata;
+	ldc_user_params = (tx_isp_ldc_opt *)udata;
+	ldc_params_nums = size / sizeof(tx_isp_ldc_opt);
+	memcpy(ldc_params_version, header->version, sizeof(ldc_params_version));
+	private_spin_unlock_irqrestore(&ldc->slock, flags);
 
-	return crc;
+release:
+	release_firmware(fw);
+exit:
+	private_mutex_lock(&ldc->mlock);
+	ldc->fw_pending = false;
+	private_mutex_unlock(&ldc->mlock);
 }
 
 static void ldc_load_parameters(struct tx_isp_ldc_device *ldc)
 {
 	struct tx_isp_sensor_attribute *attr = ldc->vin.attr;
-	struct file *file = NULL;
-	struct inode *inode = NULL;
-	mm_segment_t old_fs;
-	loff_t fsize;
-	loff_t *pos;
-	unsigned int crc = 0;
-	struct ldc_params_header *header;
+	unsigned long flags = 0;
 	char file_name[64];
+	char *udata = NULL;
+	int ret = 0;
 
-	if(ldc_user_params)
+	if(attr == NULL)
 		return;
 
 	memset(file_name, 0, sizeof(file_name));
-	/* open file */
-	snprintf(file_name, sizeof(file_name), "/etc/sensor/ldc_%s.bin", attr->name);
-	file = filp_open(file_name, O_RDONLY, 0);
-	if (file < 0 || IS_ERR(file)) {
-		goto failed_open_file;
-	}
-	/* read file */
-	inode = file->f_dentry->d_inode;
-	fsize = inode->i_size;
-	old_fs = get_fs();
-	set_fs(KERNEL_DS);
-	pos = &(file->f_pos);
-
-	/* check flags and crc */
-	if(ldc->udata == NULL){
-		ldc->udata = kmalloc(fsize, GFP_KERNEL);
-		if(ldc->udata == NULL){
-			printk("%s[%d]: Failed to alloc %lld KB buffer!\n",__func__,__LINE__, fsize >> 10);
-			goto failed_malloc_data;
-		}
-	}
-	vfs_read(file, ldc->udata, fsize, pos);
-	filp_close(file, NULL);
-	set_fs(old_fs);
-
-	header = (struct ldc_params_header *)ldc->udata;
-	if(header->flags != fsize - sizeof(*header)){
-		printk("flags is error; LDC will use default parameter!\n");
-		goto flags_error;
-	}
+	snprintf(file_name, sizeof(file_name), "ldc_%s.bin", attr->name);
 
-	ldc_user_params = (tx_isp_ldc_opt *)(ldc->udata + sizeof(*header));
-	crc = crc32((void *)ldc_user_params, header->flags / sizeof(int));
-	if(header->crc != crc){
-		printk("crc is error; LDC will use default parameter!\n");
-		goto crc_error;
+	private_mutex_lock(&ldc->mlock);
+	/* the table is on its way or already cached */
+	if(ldc->fw_pending || (ldc->udata && !strcmp(ldc->fw_name, file_name))){
+		private_mutex_unlock(&ldc->mlock);
+		return;
 	}
-	ldc_params_nums = header->flags / sizeof(tx_isp_ldc_opt);
-	memcpy(ldc_params_version, header->version, sizeof(ldc_params_version));
-	return;
 
-crc_error:
-	ldc_user_params = NULL;
-flags_error:
-	kfree(ldc->udata);
+	/* drop the table of the previous sensor */
+	private_spin_lock_irqsave(&ldc->slock, flags);
+	udata = ldc->udata;
 	ldc->udata = NULL;
-failed_malloc_data:
-failed_open_file:
-	return;
+	ldc_user_params = NULL;
+	ldc_params_nums = ARRAY_SIZE(ldc_default_params);
+	strlcpy(ldc_params_version, LDC_DEFAULT_VERSION, sizeof(ldc_params_version));
+	private_spin_unlock_irqrestore(&ldc->slock, flags);
+	kfree(udata);
+
+	memcpy(ldc->fw_name, file_name, sizeof(ldc->fw_name));
+	ldc->fw_pending = true;
+	private_mutex_unlock(&ldc->mlock);
+
+	ret = request_firmware_nowait(THIS_MODULE, FW_ACTION_HOTPLUG, ldc->fw_name,
+			ldc->sd.module.dev, GFP_KERNEL, ldc, ldc_parse_parameters);
+	if(ret){
+		ISP_WRANING("Failed to request %s(%d); LDC will use default parameter!\n", ldc->fw_name, ret);
+		private_mutex_lock(&ldc->mlock);
+		ldc->fw_pending = false;
+		private_mutex_unlock(&ldc->mlock);
+	}
 }
 
 static int ldc_frame_channel_streamoff(struct tx_isp_subdev_pad *pad);
@@ -660,6 +635,8 @@ static int ldc_sync_sensor_attr(struct tx_isp_subdev *sd, void *arg)
 	}
 	if(arg){
 		memcpy(&ldc->vin, (void *)arg, sizeof(struct tx_isp_video_in));
+		/* start fetching the table long before the first streamon */
+		ldc_load_parameters(ldc);
 	}else
 		memset(&ldc->vin, 0, sizeof(struct tx_isp_video_in));
 	return 0;
@@ -682,8 +659,8 @@ static int ldc_activate_module(struct tx_isp_subdev *sd)
 	private_spin_lock_irqsave(&ldc->slock, flags);
 	/* clk ops */
 	ldc_clks_ops(sd, 1);
-	init_buffer_fifo(&ldc->outfifo);
-	init_buffer_fifo(&ldc->infifo);
+	tx_isp_fifo_init(&ldc->outfifo);
+	tx_isp_fifo_init(&ldc->infifo);
 	ldc->state = TX_ISP_MODULE_ACTIVATE;
 	private_spin_unlock_irqrestore(&ldc->slock, flags);
 	return 0;
@@ -707,12 +684,6 @@ static int ldc_slake_module(struct tx_isp_subdev *sd)
 	ldc_clks_ops(sd, 0);
 	ldc->state = TX_ISP_MODULE_SLAKE;
 	private_spin_unlock_irqrestore(&ldc->slock, flags);
-	if(ldc->udata){
-		kfree(ldc->udata);
-		ldc->udata = NULL;
-		ldc_user_params = NULL;
-		ldc_params_nums = ARRAY_SIZE(ldc_default_params);
-	}
 	return 0;
 }
 
@@ -759,7 +730,9 @@ static int ldc_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *data)
 	struct tx_isp_ldc_device *ldc = IS_ERR_OR_NULL(pad) ? NULL : pad->priv;
 	struct frame_image_format *fmt = NULL;
 	tx_isp_ldc_opt *ldc_params = NULL;
+	unsigned int nums = 0;
 	unsigned int index = 0;
+	unsigned long flags = 0;
 	int ret = 0;
 
 	if(IS_ERR_OR_NULL(pad) || (pad->type == TX_ISP_PADTYPE_UNDEFINE))
@@ -775,8 +748,11 @@ static int ldc_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *data)
 		}
 
 		ldc->current_param = NULL;
+		private_spin_lock_irqsave(&ldc->slock, flags);
 		ldc_params = ldc_user_params ? ldc_user_params : ldc_default_params;
-		for(index = 0; index < ldc_params_nums; index++){
+		nums = ldc_params_nums;
+		private_spin_unlock_irqrestore(&ldc->slock, flags);
+		for(index = 0; index < nums; index++){
 			if((ldc_params[index].width == fmt->pix.width) && (ldc_params[index].height == fmt->pix.height)){
 				ldc->current_param = &(ldc_params[index]);
 				break;
@@ -919,9 +895,16 @@ static int ldc_frame_channel_streamon(struct tx_isp_subdev_pad *pad)
 	ldc->state = TX_ISP_MODULE_RUNNING;
 	ldc->cur_outbuf = NULL;
 	ldc->cur_inbuf = NULL;
+	ldc->next_outbuf = NULL;
+	ldc->next_inbuf = NULL;
+	ldc->idle_since = 0;
 	ldc->done_cnt = 0;
 	ldc->start_cnt = 0;
 	ldc->reset_cnt = 0;
+	ldc->missed_cnt = 0;
+	ldc->idle_gap_cnt = 0;
+	ldc->idle_gap_us = 0;
+	ldc->max_idle_gap_us = 0;
 	private_spin_unlock_irqrestore(&ldc->slock, flags);
 
 	ret = tx_isp_send_event_to_remote(inpad, TX_ISP_EVENT_FRAME_CHAN_STREAM_ON, NULL);
@@ -995,8 +978,10 @@ static int ldc_frame_channel_streamoff(struct tx_isp_subdev_pad *pad)
 		ldc->buf_addr = 0;
 	}
 
-	init_buffer_fifo(&ldc->outfifo);
-	init_buffer_fifo(&ldc->infifo);
+	ldc->next_outbuf = NULL;
+	ldc->next_inbuf = NULL;
+	tx_isp_fifo_init(&ldc->outfifo);
+	tx_isp_fifo_init(&ldc->infifo);
 	tx_isp_reg_set(&ldc->sd, LDC_CTR, 3, 3, 0); // disable interrupt
 	if(irqdev->irq)
 		irqdev->disable_irq(irqdev);
@@ -1057,6 +1042,7 @@ static int tx_isp_ldc_show(struct seq_file *m, void *v)
 	struct tx_isp_ldc_device *ldc = IS_ERR_OR_NULL(sd) ? NULL : tx_isp_get_subdevdata(sd);
 	struct frame_channel_buffer *pos = NULL;
 	unsigned long flags = 0;
+	unsigned int index = 0;
 
 	if(IS_ERR_OR_NULL(ldc)){
 		ISP_ERROR("The parameter is invalid!\n");
@@ -1066,19 +1052,30 @@ static int tx_isp_ldc_show(struct seq_file *m, void *v)
 	len += seq_printf(m ,"############## %s is %s ###############\n", module->name,
 					ldc->state == TX_ISP_MODULE_RUNNING ? "running" : "idle");
 	len += seq_printf(m ,"The version is %s\n", ldc_params_version);
+	if(ldc->fw_pending)
+		len += seq_printf(m ,"Loading %s\n", ldc->fw_name);
 	if(ldc->state != TX_ISP_MODULE_RUNNING)
 		return len;
 	if(ldc_user_params == NULL)
 		len += seq_printf(m ,"LDC is using default parameter!\n");
 	private_spin_lock_irqsave(&ldc->slock, flags);
-	tx_list_for_each_entry(pos, &ldc->infifo, entry){
+	tx_isp_fifo_for_each(&ldc->infifo, index, pos){
 		len += seq_printf(m ,"infifo addr: 0x%08x\n", pos->addr);
 	}
-	tx_list_for_each_entry(pos, &ldc->outfifo, entry){
+	tx_isp_fifo_for_each(&ldc->outfifo, index, pos){
 		len += seq_printf(m ,"outfifo addr: 0x%08x\n", pos->addr);
 	}
+	len += seq_printf(m ,"infifo high water = %d, underrun = %d\n",
+			ldc->infifo.high_water, ldc->infifo.underrun);
+	len += seq_printf(m ,"outfifo high water = %d, underrun = %d\n",
+			ldc->outfifo.high_water, ldc->outfifo.underrun);
 	len += seq_printf(m ,"current inbuf addr: 0x%08x\n", ldc->cur_inbuf ? ldc->cur_inbuf->addr : 0);
 	len += seq_printf(m ,"current outbuf addr: 0x%08x\n", ldc->cur_outbuf ? ldc->cur_outbuf->addr : 0);
+	len += seq_printf(m ,"staged inbuf addr: 0x%08x\n", ldc->next_inbuf ? ldc->next_inbuf->addr : 0);
+	len += seq_printf(m ,"staged outbuf addr: 0x%08x\n", ldc->next_outbuf ? ldc->next_outbuf->addr : 0);
+	len += seq_printf(m ,"missed slots = %d\n", ldc->missed_cnt);
+	len += seq_printf(m ,"idle gaps = %d, total %lld us, max %d us\n",
+			ldc->idle_gap_cnt, ldc->idle_gap_us, ldc->max_idle_gap_us);
 	len += seq_printf(m ,"start cnt = %lld done cnt = %lld\n", ldc->start_cnt, ldc->done_cnt);
 	len += seq_printf(m ,"reset cnt = %d\n", ldc->reset_cnt);
 	private_spin_unlock_irqrestore(&ldc->slock, flags);
@@ -1135,8 +1132,8 @@ static int tx_isp_ldc_probe(struct platform_device *pdev)
 			ldc_dev->inbufs[index].priv = (unsigned int)ldc_dev;
 		}
 	}
-	init_buffer_fifo(&ldc_dev->outfifo);
-	init_buffer_fifo(&ldc_dev->infifo);
+	tx_isp_fifo_init(&ldc_dev->outfifo);
+	tx_isp_fifo_init(&ldc_dev->infifo);
 	private_spin_lock_init(&ldc_dev->slock);
 	private_mutex_init(&ldc_dev->mlock);
 	ldc_dev->pdata = pdev->dev.platform_data;
@@ -1186,6 +1183,9 @@ static int __exit tx_isp_ldc_remove(struct platform_device *pdev)
 
 	g_ldc = NULL;
 	tx_isp_subdev_deinit(sd);
+	ldc_user_params = NULL;
+	ldc_params_nums = ARRAY_SIZE(ldc_default_params);
+	kfree(ldc->udata);
 	kfree(ldc);
 	return 0;
 }
@@ -7,6 +7,7 @@
 #include <linux/seq_file.h>
 
 #include <tx-isp-common.h>
+#include <tx-isp-fifo.h>
 #include <tx-ldc-regs.h>
 
 #define TX_ISP_LDC_MIN_WIDTH 640
@@ -82,12 +83,17 @@ struct tx_isp_ldc_device {
 	struct frame_channel_buffer *inbufs;
 	unsigned int buf_addr;
 	int num_inbufs;
-	struct list_head infifo;
+	struct tx_isp_fifo infifo;
 	struct frame_channel_buffer *cur_inbuf;
 
-	struct list_head outfifo;
+	struct tx_isp_fifo outfifo;
 	struct frame_channel_buffer *cur_outbuf;
 
+	/* the pair that will be started as soon as the engine is idle */
+	struct frame_channel_buffer *next_inbuf;
+	struct frame_channel_buffer *next_outbuf;
+	unsigned long long idle_since;
+
 	spinlock_t slock;
 	struct mutex mlock;
 
@@ -95,9 +101,15 @@ struct tx_isp_ldc_device {
 	unsigned long long start_cnt;
 	unsigned long long done_cnt;
 	unsigned int reset_cnt;
+	unsigned int missed_cnt;
+	unsigned int idle_gap_cnt;
+	unsigned long long idle_gap_us;
+	unsigned int max_idle_gap_us;
 
 	/* ldc algorithm data */
 	char *udata;
+	char fw_name[64];	/* the table that udata is loaded from */
+	bool fw_pending;
 
 	/* the private parameters */
 	struct task_struct *process_thread;
@@ -18,6 +18,7 @@
 #include "tx-isp-mscaler.h"
 #include "tx-isp-mscaler-coe.h"
 #include "tx-isp-frame-channel.h"
+#include <tx-isp-trace.h>
 
 unsigned int ispw = 0;
 module_param(ispw, int, S_IRUGO);
@@ -65,38 +66,6 @@ MODULE_PARM_DESC(ispscalerwh, "The size of isp's scaler");
    manager the buffer of frame channels
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
  */
-static inline void init_buffer_fifo(struct list_head *fifo)
-{
-	TX_INIT_LIST_HEAD(fifo);
-}
-
-static struct frame_channel_buffer *pop_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	if(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}else
-		buf = NULL;
-
-	return buf;
-}
-
-static void inline push_buffer_fifo(struct list_head *fifo, struct frame_channel_buffer *buf)
-{
-	//	printk("^@^ %s %d %p %p^-^\n",__func__,__LINE__, fifo, buf);
-	tx_list_add_tail(&(buf->entry), fifo);
-}
-
-static void inline cleanup_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	while(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}
-}
-
 static void channel_dma_buffer_done(struct isp_mscaler_output_channel *chan)
 {
 	struct tx_isp_mscaler_device *mscaler = chan->priv;
@@ -114,6 +83,7 @@ static void channel_dma_buffer_done(struct isp_mscaler_output_channel *chan)
 				buf.priv = tx_isp_sd_readl(&(mscaler->sd), CHx_DMAOUT_Y_LAST_STATS_NUM(chan->index));
 				break;
 		}
+		tx_isp_trace_stamp_chan(TX_ISP_TRACE_MSCALER, chan->index);
 		tx_isp_send_event_to_remote(chan->pad, TX_ISP_EVENT_FRAME_CHAN_DQUEUE_BUFFER, &buf);
 		chan->frame_cnt++;
 	}
@@ -125,10 +95,27 @@ static void configure_channel_dma_addr(struct isp_mscaler_output_channel *chan)
 	struct frame_image_format *fmt = &(chan->fmt);
 	struct frame_channel_buffer *buf;
 	unsigned int offset = 0;
-	while((tx_isp_sd_readl(&(mscaler->sd), CHx_Y_ADDR_FIFO_STA(chan->index)) & CH_ADDR_FIFO_FULL) == 0){
-		buf = pop_buffer_fifo(&chan->fifo);
-		if(buf == NULL)
+	unsigned int sta = 0;
+
+	/* a new rate takes effect between two frames of the channel */
+	if(chan->rate_pending){
+		tx_isp_sd_writel(&(mscaler->sd), CHx_FRA_CTRL_LOOP(chan->index), fmt->rate_bits);
+		tx_isp_sd_writel(&(mscaler->sd), CHx_FRA_CTRL_MASK(chan->index), fmt->rate_mask);
+		chan->rate_phase = 0;
+		chan->rate_pending = 0;
+	}
+
+	tx_isp_trace_fifo_depth(TX_ISP_TRACE_MSCALER, &chan->fifo);
+	while(((sta = tx_isp_sd_readl(&(mscaler->sd), CHx_Y_ADDR_FIFO_STA(chan->index))) & CH_ADDR_FIFO_FULL) == 0){
+		buf = tx_isp_fifo_pop(&chan->fifo);
+		if(buf == NULL){
+			/* the hardware has nothing to write the next frame into */
+			if(sta & CH_ADDR_FIFO_EMPTY){
+				tx_isp_fifo_underrun(&chan->fifo);
+				tx_isp_trace_drop_chan(TX_ISP_TRACE_MSCALER, chan->index, TX_ISP_DROP_NO_BUFFER);
+			}
 			break;
+		}
 		/*printk("## %s %d, chanid = %d buf->addr = 0x%08x ##\n", __func__,__LINE__,chan->index, buf->addr);*/
 		switch(fmt->pix.pixelformat){
 			case V4L2_PIX_FMT_NV12:
@@ -143,6 +130,51 @@ static void configure_channel_dma_addr(struct isp_mscaler_output_channel *chan)
 	}
 }
 
+/* the hardware never writes the frames masked out, just count them */
+static void channel_frame_rate_count(struct isp_mscaler_output_channel *chan)
+{
+	struct frame_image_format *fmt = &(chan->fmt);
+
+	if(chan->state != TX_ISP_MODULE_RUNNING)
+		return;
+	if(!(fmt->rate_mask & (1U << chan->rate_phase))){
+		chan->skipped_cnt++;
+		tx_isp_trace_skip_chan(TX_ISP_TRACE_MSCALER, chan->index);
+		tx_isp_trace_skip_chan(TX_ISP_TRACE_FRAME_CHAN, chan->index);
+	}
+	chan->rate_phase = chan->rate_phase >= fmt->rate_bits ? 0 : chan->rate_phase + 1;
+}
+
+static void mscaler_output_channel_config_window(struct isp_mscaler_output_channel *chan, struct frame_image_format *fmt);
+
+/*
+ * Move the window of the channel to the staged roi. Only the step, size
+ * and crop registers change, the resize coefficients are shared by all
+ * ratios and stay loaded, and the output size stays the size of the
+ * queued buffers.
+ */
+static void channel_apply_roi(struct isp_mscaler_output_channel *chan)
+{
+	struct frame_image_format *fmt = &(chan->fmt);
+	struct frame_image_roi *roi = &(chan->roi);
+
+	if(!chan->roi_pending)
+		return;
+
+	fmt->scaler_enable = roi->scaler_out_width ? true : false;
+	fmt->scaler_out_width = roi->scaler_out_width;
+	fmt->scaler_out_height = roi->scaler_out_height;
+	/* set_roi only lets a channel without crop keep its full window */
+	fmt->crop_enable = chan->has_crop;
+	fmt->crop_left = roi->crop_left;
+	fmt->crop_top = roi->crop_top;
+	fmt->crop_width = fmt->pix.width;
+	fmt->crop_height = fmt->pix.height;
+	mscaler_output_channel_config_window(chan, fmt);
+	chan->roi_pending = 0;
+	chan->roi_cnt++;
+}
+
 /*
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
    interrupt handler
@@ -166,6 +198,7 @@ static irqreturn_t mscaler_core_interrupt_service_routine(struct tx_isp_subdev *
 	struct tx_isp_mscaler_device *mscaler = tx_isp_get_subdevdata(sd);
 	volatile unsigned int pending, state, mask;
 	unsigned int index = 0;
+	unsigned int chan = 0;
 
 	state = tx_isp_sd_readl(&(mscaler->sd), MSCA_IRQ_STAT);
 	mask = tx_isp_sd_readl(&(mscaler->sd), MSCA_IRQ_MASK);
@@ -195,6 +228,11 @@ static irqreturn_t mscaler_core_interrupt_service_routine(struct tx_isp_subdev *
 				case MS_IRQ_CSC_BIT:
 					break;
 				case MS_IRQ_FRM_BIT:
+					for(chan = 0; chan < mscaler->num_outputs; chan++){
+						channel_frame_rate_count(&(mscaler->outputs[chan]));
+						channel_apply_roi(&(mscaler->outputs[chan]));
+					}
+					break;
 				case MS_IRQ_CH2_CROP_BIT:
 				case MS_IRQ_CH1_CROP_BIT:
 				case MS_IRQ_CH0_CROP_BIT:
@@ -224,13 +262,109 @@ static int mscaler_frame_channel_qbuf(struct tx_isp_subdev_pad *pad, void *data)
 	if(buf && chan){
 		/*printk("## %s %d, chanid = %d addr = 0x%08x ##\n", __func__,__LINE__,chan->index, buf->addr);*/
 		spin_lock_irqsave(&chan->slock, flags);
-		push_buffer_fifo(&chan->fifo, buf);
+		tx_isp_fifo_push(&chan->fifo, buf);
 		configure_channel_dma_addr(chan);
 		spin_unlock_irqrestore(&chan->slock, flags);
 	}
 	return 0;
 }
 
+static int mscaler_frame_channel_set_rate(struct tx_isp_subdev_pad *pad, void *data)
+{
+	struct isp_mscaler_output_channel *chan = pad->priv;
+	struct frame_image_rate *rate = data;
+	unsigned long flags = 0;
+	unsigned int mask = 0;
+	int i = 0;
+
+	if(pad->type != TX_ISP_PADTYPE_OUTPUT){
+		ISP_ERROR("The type of pad isn't OUTPUT!\n");
+		return -EINVAL;
+	}
+	if(rate->den == 0 || rate->den > 32 || rate->num == 0 || rate->num > rate->den){
+		ISP_ERROR("The chan%d can't output %d of %d frames!\n", chan->index, rate->num, rate->den);
+		return -EINVAL;
+	}
+
+	/* spread the output frames evenly over the loop */
+	for(i = 0; i < rate->den; i++){
+		if((i + 1) * rate->num / rate->den != i * rate->num / rate->den)
+			mask |= 1U << i;
+	}
+
+	private_spin_lock_irqsave(&chan->slock, flags);
+	chan->fmt.rate_bits = rate->den - 1;
+	chan->fmt.rate_mask = mask;
+	chan->rate_pending = 1;
+	/* kept to survive the next set_fmt */
+	chan->rate_runtime = 1;
+	chan->runtime_rate_bits = rate->den - 1;
+	chan->runtime_rate_mask = mask;
+	private_spin_unlock_irqrestore(&chan->slock, flags);
+	return 0;
+}
+
+static int mscaler_frame_channel_set_roi(struct tx_isp_subdev_pad *pad, void *data)
+{
+	struct isp_mscaler_output_channel *chan = pad->priv;
+	struct tx_isp_mscaler_device *mscaler = chan->priv;
+	struct isp_mscaler_input_channel *input = mscaler->inputs;
+	struct frame_image_roi *roi = data;
+	unsigned int width = 0, height = 0;
+	unsigned long flags = 0;
+
+	if(pad->type != TX_ISP_PADTYPE_OUTPUT){
+		ISP_ERROR("The type of pad isn't OUTPUT!\n");
+		return -EINVAL;
+	}
+	if(chan->fmt.pix.width == 0 || chan->fmt.pix.height == 0){
+		ISP_ERROR("Please set the format of chan%d firstly!\n", chan->index);
+		return -EPERM;
+	}
+
+	/* the size of the scaled image */
+	if(roi->scaler_out_width || roi->scaler_out_height){
+		if(roi->scaler_out_width == 0 || roi->scaler_out_height == 0){
+			ISP_ERROR("The chan%d out-scaler %d*%d!\n", chan->index, roi->scaler_out_width, roi->scaler_out_height);
+			return -EINVAL;
+		}
+		if(chan->has_scaler == false){
+			ISP_ERROR("Chan%d can't be scaler!\n", chan->index);
+			return -EINVAL;
+		}
+		if(roi->scaler_out_width > chan->max_width || roi->scaler_out_height > chan->max_height){
+			ISP_ERROR("The chan%d out-scaler %d*%d!\n", chan->index, roi->scaler_out_width, roi->scaler_out_height);
+			return -EINVAL;
+		}
+		width = roi->scaler_out_width;
+		height = roi->scaler_out_height;
+	}else{
+		width = input->fmt.pix.width > chan->max_width ? chan->max_width : input->fmt.pix.width;
+		height = input->fmt.pix.height > chan->max_height ? chan->max_height : input->fmt.pix.height;
+	}
+
+	/* the output keeps the size of the queued buffers */
+	if(chan->has_crop == false && (roi->crop_left || roi->crop_top
+				|| width != chan->fmt.pix.width || height != chan->fmt.pix.height)){
+		ISP_ERROR("Chan%d can't be cropped!\n", chan->index);
+		return -EINVAL;
+	}
+	if(roi->crop_left + chan->fmt.pix.width > width || roi->crop_top + chan->fmt.pix.height > height){
+		ISP_ERROR("The chan%d crop %d*%d, %d*%d!\n", chan->index, roi->crop_left, roi->crop_top,
+				chan->fmt.pix.width, chan->fmt.pix.height);
+		return -EINVAL;
+	}
+
+	private_spin_lock_irqsave(&chan->slock, flags);
+	chan->roi = *roi;
+	chan->roi_pending = 1;
+	/* a stopped channel has no frame boundary to wait for */
+	if(chan->state != TX_ISP_MODULE_RUNNING)
+		channel_apply_roi(chan);
+	private_spin_unlock_irqrestore(&chan->slock, flags);
+	return 0;
+}
+
 static int mscaler_frame_channel_freebufs(struct tx_isp_subdev_pad *pad, void *data)
 {
 	struct isp_mscaler_output_channel *chan = NULL;
@@ -243,7 +377,7 @@ static int mscaler_frame_channel_freebufs(struct tx_isp_subdev_pad *pad, void *d
 	chan = pad->priv;
 	if(chan){
 		private_spin_lock_irqsave(&chan->slock, flags);
-		cleanup_buffer_fifo(&chan->fifo);
+		tx_isp_fifo_flush(&chan->fifo);
 		private_spin_unlock_irqrestore(&chan->slock, flags);
 	}
 	return 0;
@@ -298,9 +432,13 @@ static int inline mscaler_video_streamon(struct tx_isp_mscaler_device *mscaler)
 	tx_isp_sd_writel(sd, CSC_OFFSET_PARA, (128 << 16)+ 16);
 	tx_isp_sd_writel(sd, CSC_GLO_ALPHA, 128);
 
-	/* set resize coefficients */
-	for (i = 0; i < 512; i++)
-		tx_isp_sd_writel(sd, GLO_RSZ_COEF_WR, mscaler_coefficient[i]);
+	/* set resize coefficients, they are shared by all channels and ratios */
+	if(!mscaler->coe_loaded){
+		for (i = 0; i < 512; i++)
+			tx_isp_sd_writel(sd, GLO_RSZ_COEF_WR, mscaler_coefficient[i]);
+		mscaler->coe_loaded = true;
+		mscaler->coe_loads++;
+	}
 
 
 	/* enable interrupt */
@@ -432,6 +570,8 @@ static int mscaler_frame_channel_streamon(struct tx_isp_subdev_pad *pad)
 	/* enable channel */
 	tx_isp_reg_set(&(mscaler->sd), MSCA_CH_EN, chan->index, chan->index, 1);
 	chan->frame_cnt = 0;
+	chan->skipped_cnt = 0;
+	tx_isp_trace_start_chan(chan->index);
 	chan->state = TX_ISP_MODULE_RUNNING;
 	pad->state = TX_ISP_PADSTATE_STREAM;
 	spin_unlock_irqrestore(&chan->slock, flags);
@@ -480,7 +620,7 @@ static int mscaler_frame_channel_streamoff(struct tx_isp_subdev_pad *pad)
 
 	/* streamoff */
 	pad->state = TX_ISP_PADSTATE_LINKED;
-	cleanup_buffer_fifo(&chan->fifo);
+	tx_isp_fifo_flush(&chan->fifo);
 	tx_isp_sd_writel(&(mscaler->sd), CHx_DMAOUT_Y_ADDR_CLR(chan->index), 1); // clear Y fifo
 	tx_isp_sd_writel(&(mscaler->sd), CHx_DMAOUT_UV_ADDR_CLR(chan->index), 1); // clear UV fifo
 	spin_unlock_irqrestore(&chan->slock, flags);
@@ -551,6 +691,11 @@ static int mscaler_core_ops_init(struct tx_isp_subdev *sd, int on)
 			ret = -EINVAL;
 			goto exit;
 		}
+		/* the reset cleared every cached setting */
+		mscaler->coe_loaded = false;
+		for(index = 0; index < mscaler->num_outputs; index++){
+			mscaler->outputs[index].win_valid = false;
+		}
 		private_spin_lock_irqsave(&mscaler->slock, flags);
 		if(mscaler->state != TX_ISP_MODULE_ACTIVATE){
 			private_spin_unlock_irqrestore(&mscaler->slock, flags);
@@ -732,6 +877,11 @@ static int mscaler_slake_module(struct tx_isp_subdev *sd)
 		mscaler->inputs[index].state = TX_ISP_MODULE_SLAKE;
 	}
 
+	mscaler->coe_loaded = false;
+	for(index = 0; index < mscaler->num_outputs; index++){
+		mscaler->outputs[index].win_valid = false;
+	}
+
 	/* clk ops */
 	mscaler_clks_ops(sd, 0);
 	private_spin_unlock_irqrestore(&mscaler->slock, flags);
@@ -811,13 +961,13 @@ static struct frame_channel_format mscaler_output_fmt[] = {
 	},
 };
 
-static void mscaler_output_channel_config(struct isp_mscaler_output_channel *chan, struct frame_image_format *fmt)
+static void mscaler_output_channel_config_window(struct isp_mscaler_output_channel *chan, struct frame_image_format *fmt)
 {
 	struct tx_isp_mscaler_device *mscaler = chan->priv;
-	struct frame_channel_format *cfmt = (struct frame_channel_format *)(fmt->pix.priv);
 	struct isp_mscaler_input_channel *input = mscaler->inputs;
 	unsigned int step_w, step_h;
 	unsigned int width = 0, height = 0;
+	unsigned int regs[4];
 
 	width = input->fmt.pix.width;
 	height = input->fmt.pix.height;
@@ -829,20 +979,43 @@ static void mscaler_output_channel_config(struct isp_mscaler_output_channel *cha
 		width = fmt->scaler_out_width;
 		height = fmt->scaler_out_height;
 	}else{
+		/* unscaled, the channel passes at most its maximum size, as validated */
+		width = width > chan->max_width ? chan->max_width : width;
+		height = height > chan->max_height ? chan->max_height : height;
 		step_w = 512;
 		step_h = 512;
 	}
-	tx_isp_sd_writel(&(mscaler->sd), CHx_RSZ_STEP(chan->index), step_w<<16|step_h);
-	tx_isp_sd_writel(&(mscaler->sd), CHx_RSZ_OSIZE(chan->index), width<<16|height);
+	regs[0] = step_w<<16|step_h;
+	regs[1] = width<<16|height;
 
 	/* set crop */
 	if(fmt->crop_enable){
-		tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OPOS(chan->index), fmt->crop_left << 16 | fmt->crop_top);
-		tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OSIZE(chan->index), fmt->crop_width << 16 | fmt->crop_height);
+		regs[2] = fmt->crop_left << 16 | fmt->crop_top;
+		regs[3] = fmt->crop_width << 16 | fmt->crop_height;
 	}else{
-		tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OPOS(chan->index), 0);
-		tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OSIZE(chan->index), width << 16 | height);
+		regs[2] = 0;
+		regs[3] = width << 16 | height;
+	}
+
+	/* the same input, scaler and crop as programmed, nothing to reload */
+	if(chan->win_valid && !memcmp(regs, chan->win_regs, sizeof(regs))){
+		chan->reconfig_skipped++;
+		return;
 	}
+	tx_isp_sd_writel(&(mscaler->sd), CHx_RSZ_STEP(chan->index), regs[0]);
+	tx_isp_sd_writel(&(mscaler->sd), CHx_RSZ_OSIZE(chan->index), regs[1]);
+	tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OPOS(chan->index), regs[2]);
+	tx_isp_sd_writel(&(mscaler->sd), CHx_CROP_OSIZE(chan->index), regs[3]);
+	memcpy(chan->win_regs, regs, sizeof(regs));
+	chan->win_valid = true;
+}
+
+static void mscaler_output_channel_config(struct isp_mscaler_output_channel *chan, struct frame_image_format *fmt)
+{
+	struct tx_isp_mscaler_device *mscaler = chan->priv;
+	struct frame_channel_format *cfmt = (struct frame_channel_format *)(fmt->pix.priv);
+
+	mscaler_output_channel_config_window(chan, fmt);
 
 	/* set rate */
 	fmt->rate_bits = fmt->rate_bits > 31 ? 31 : fmt->rate_bits;
@@ -864,6 +1037,8 @@ static int mscaler_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *da
 	struct frame_channel_format *cfmt = mscaler_output_fmt;
 	struct tx_isp_mscaler_device *mscaler = chan->priv;
 	struct isp_mscaler_input_channel *input = mscaler->inputs;
+	unsigned long long start = private_sched_clock();
+	unsigned long flags = 0;
 
 	if(pad->type == TX_ISP_PADTYPE_UNDEFINE)
 		return -EPERM;
@@ -955,8 +1130,20 @@ static int mscaler_frame_channel_set_fmt(struct tx_isp_subdev_pad *pad, void *da
 	fmt->pix.priv = (unsigned int)cfmt;
 	chan->lineoffset = fmt->pix.width * (cfmt->depth / 8);
 
+	/* a rate set at runtime wins over the one of the format */
+	private_spin_lock_irqsave(&chan->slock, flags);
+	if(chan->rate_runtime){
+		fmt->rate_bits = chan->runtime_rate_bits;
+		fmt->rate_mask = chan->runtime_rate_mask;
+		chan->rate_phase = 0;
+		chan->rate_pending = 0;
+	}
+	private_spin_unlock_irqrestore(&chan->slock, flags);
+
 	mscaler_output_channel_config(chan, fmt);
 	chan->fmt = *fmt;
+	chan->reconfig_cnt++;
+	chan->reconfig_us = div_u64(private_sched_clock() - start, 1000);
 	return 0;
 }
 
@@ -986,6 +1173,12 @@ static int mscaler_pad_event_handle(struct tx_isp_subdev_pad *pad, unsigned int
 		case TX_ISP_EVENT_FRAME_CHAN_FREE_BUFFER:
 			ret = mscaler_frame_channel_freebufs(pad, data);
 			break;
+		case TX_ISP_EVENT_FRAME_CHAN_SET_RATE:
+			ret = mscaler_frame_channel_set_rate(pad, data);
+			break;
+		case TX_ISP_EVENT_FRAME_CHAN_SET_ROI:
+			ret = mscaler_frame_channel_set_roi(pad, data);
+			break;
 		default:
 			break;
 	}
@@ -1042,7 +1235,7 @@ static int mscaler_output_channel_init(struct tx_isp_mscaler_device *mscaler)
 		chan->state = TX_ISP_MODULE_SLAKE;
 		chan->min_width = 128;
 		chan->min_height = 128;
-		init_buffer_fifo(&(chan->fifo));
+		tx_isp_fifo_init(&(chan->fifo));
 		private_spin_lock_init(&(chan->slock));
 		private_init_completion(&chan->stop_comp);
 		chan->priv = mscaler;
@@ -1130,6 +1323,7 @@ static int isp_mscaler_show(struct seq_file *m, void *v)
 		ISP_ERROR("The parameter is invalid!\n");
 		return 0;
 	}
+	len += seq_printf(m ,"coefficient loads: %d\n", mscaler->coe_loads);
 	for(index = 0; index < mscaler->num_outputs; index++){
 		len += seq_printf(m ,"############## chan %d ###############\n", index);
 		output = &(mscaler->outputs[index]);
@@ -1137,6 +1331,14 @@ static int isp_mscaler_show(struct seq_file *m, void *v)
 		if(output->state != TX_ISP_MODULE_RUNNING)
 			continue;
 		len += seq_printf(m ,"output frames: %d\n", output->frame_cnt);
+		len += seq_printf(m ,"output rate: %d of %d frames\n", hweight32(output->fmt.rate_mask),
+				output->fmt.rate_bits + 1);
+		len += seq_printf(m ,"skipped frames: %d\n", output->skipped_cnt);
+		len += seq_printf(m ,"roi changes: %d\n", output->roi_cnt);
+		len += seq_printf(m ,"fifo depth: %d, high water %d, underrun %d\n",
+				tx_isp_fifo_depth(&output->fifo), output->fifo.high_water, output->fifo.underrun);
+		len += seq_printf(m ,"reconfig: %d times, last %d us, %d window reloads skipped\n",
+				output->reconfig_cnt, output->reconfig_us, output->reconfig_skipped);
 		fmt = (char *)(&output->fmt.pix.pixelformat);
 		len += seq_printf(m ,"output pixformat: %c%c%c%c\n", fmt[0],fmt[1],fmt[2],fmt[3]);
 		len += seq_printf(m ,"output resolution: %d * %d\n", output->fmt.pix.width, output->fmt.pix.height);
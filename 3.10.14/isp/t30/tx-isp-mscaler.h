@@ -7,6 +7,7 @@
 /*#include <linux/seq_file.h>*/
 /*#include <jz_proc.h>*/
 #include <tx-isp-common.h>
+#include <tx-isp-fifo.h>
 
 enum isp_mscaler_output_id {
 	ISP_MSCALER_OUTPUT_0,
@@ -28,7 +29,7 @@ struct isp_mscaler_output_channel {
 	unsigned int min_height;
 	bool	has_crop;
 	bool	has_scaler;
-	struct list_head fifo;
+	struct tx_isp_fifo fifo;
 	spinlock_t slock;
 	/*unsigned char bank_flag[ISP_DMA_WRITE_MAXBASE_NUM];*/
 	/*unsigned char vflip_flag[ISP_DMA_WRITE_MAXBASE_NUM];*/
@@ -38,6 +39,24 @@ struct isp_mscaler_output_channel {
 	unsigned char vflip_state;
 	unsigned char usingbanks;
 	unsigned int frame_cnt;
+	/* frame rate control, the loop and mask live in fmt */
+	unsigned char rate_pending;
+	unsigned int rate_phase;
+	/* the rate of the last set_rate, reapplied by set_fmt */
+	unsigned char rate_runtime;
+	unsigned int runtime_rate_bits;
+	unsigned int runtime_rate_mask;
+	unsigned int skipped_cnt;
+	/* the window staged for the next frame */
+	struct frame_image_roi roi;
+	unsigned char roi_pending;
+	unsigned int roi_cnt;
+	/* the step, size and crop registers last programmed */
+	unsigned int win_regs[4];
+	bool	win_valid;
+	unsigned int reconfig_cnt;
+	unsigned int reconfig_skipped;
+	unsigned int reconfig_us;
 };
 
 struct isp_mscaler_input_channel {
@@ -61,6 +80,9 @@ struct tx_isp_mscaler_device {
 	struct isp_mscaler_output_channel *outputs;
 	unsigned int num_outputs;
 	int chan_rgb_flags;
+	/* the resize coefficients survive until the next reset */
+	bool	coe_loaded;
+	unsigned int coe_loads;
 	struct isp_mscaler_input_channel *inputs;
 	unsigned int num_inputs;
 };
@@ -14,53 +14,12 @@
 #include "tx-isp-ncu.h"
 #include "tx-isp-frame-channel.h"
 #include "tx-isp-videobuf.h"
+#include <tx-isp-trace.h>
 
 static int isp_m2_bufs = 2;
 module_param(isp_m2_bufs, int, S_IRUGO);
 MODULE_PARM_DESC(isp_m2_bufs, "isp inter buffers");
 
-/*
-   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
-   manager the buffer of frame channels
-   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
- */
-static inline void init_buffer_fifo(struct list_head *fifo)
-{
-	TX_INIT_LIST_HEAD(fifo);
-}
-
-static struct frame_channel_buffer *pop_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	if(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}else
-		buf = NULL;
-
-	return buf;
-}
-
-static void inline push_buffer_fifo(struct list_head *fifo, struct frame_channel_buffer *buf)
-{
-	//	printk("^@^ %s %d %p %p^-^\n",__func__,__LINE__, fifo, buf);
-	tx_list_add_tail(&(buf->entry), fifo);
-}
-
-static void inline cleanup_buffer_fifo(struct list_head *fifo)
-{
-	struct frame_channel_buffer *buf;
-	while(!tx_list_empty(fifo)){
-		buf = tx_list_first_entry(fifo, struct frame_channel_buffer, entry);
-		tx_list_del(&(buf->entry));
-	}
-}
-
-static int inline is_empty_fifo(struct list_head *fifo)
-{
-	return tx_list_empty(fifo);
-}
-
 /*
    @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
    interrupt handler
@@ -78,7 +37,7 @@ static irqreturn_t ncu_core_interrupt_service_routine(struct tx_isp_subdev *sd,
 			/*private_complete(&ncu->stop_comp);*/
 		if(ncu->state == TX_ISP_MODULE_RUNNING){
 			if(pad->link.flag & TX_ISP_PADLINK_DDR){
-				buf = pop_buffer_fifo(&ncu->infifo);
+				buf = tx_isp_fifo_pop(&ncu->infifo);
 				if(buf){
 					tx_isp_sd_writel(&ncu->sd, Y_CUR_ADDR, buf->addr);
 					tx_isp_sd_writel(&ncu->sd, UV_CUR_ADDR, buf->addr + ncu->uv_offset);
@@ -88,6 +47,12 @@ static irqreturn_t ncu_core_interrupt_service_routine(struct tx_isp_subdev *sd,
 		}
 	}
 #endif
+	struct tx_isp_ncu_device *ncu = tx_isp_get_subdevdata(sd);
+
+	/* the ncu went idle, it is done with the frame */
+	if(ncu->state == TX_ISP_MODULE_RUNNING &&
+			(tx_isp_sd_readl((&ncu->sd), NCU_START) & NCU_START_IDLE_MASK))
+		tx_isp_trace_stamp(TX_ISP_TRACE_NCU);
 	tx_isp_reg_set(sd, NCU_INT_CNTRL, 1, 1, 1); // clear interrupt
 
 	return IRQ_HANDLED;
@@ -100,6 +65,7 @@ static struct tx_isp_ncu_device *g_ncu = NULL;
 void tx_isp_sync_ncu(void)
 {
 	if(g_ncu && (g_ncu->state == TX_ISP_MODULE_RUNNING)){
+		tx_isp_trace_fifo_depth(TX_ISP_TRACE_NCU, &g_ncu->infifo);
 		if((last_ncu_start_cnt != g_ncu->start_cnt) || (g_ncu->start_cnt == g_ncu->done_cnt)){
 			last_ncu_start_cnt = g_ncu->start_cnt;
 			lost_cnt = 0;
@@ -114,6 +80,7 @@ void tx_isp_sync_ncu(void)
 			g_ncu->ms_flag = 1; // msclaer is busy
 			g_ncu->start_cnt++;
 			g_ncu->reset_cnt++;
+			tx_isp_trace_drop(TX_ISP_TRACE_NCU, TX_ISP_DROP_NCU_RESET);
 			/*printk("####### reset ncu and mscaler ######\n");*/
 		}
 	}
@@ -132,13 +99,13 @@ static int ncu_frame_channel_dqbuf(struct tx_isp_subdev_pad *pad, void *data)
 
 	spin_lock_irqsave(&ncu->slock, flags);
 	if(buf && ncu){
-		push_buffer_fifo(&ncu->infifo, buf);
+		tx_isp_fifo_push(&ncu->infifo, buf);
 	}
 
 	if(ncu->state == TX_ISP_MODULE_RUNNING){
 		if((tx_isp_sd_readl((&ncu->sd), NCU_START) & NCU_START_IDLE_MASK) &&
 				(ncu->ms_flag == 0)){	// when mscaler is idle state.
-			buf = pop_buffer_fifo(&ncu->infifo);
+			buf = tx_isp_fifo_pop(&ncu->infifo);
 			if(buf){
 				tx_isp_sd_writel(&ncu->sd, Y_CUR_ADDR, buf->addr);
 				tx_isp_sd_writel(&ncu->sd, UV_CUR_ADDR, buf->addr + ncu->uv_offset);
@@ -177,7 +144,7 @@ static int ncu_frame_channel_qbuf(struct tx_isp_subdev_pad *pad, void *data)
 	}
 	if(ncu->state == TX_ISP_MODULE_RUNNING){
 		if(tx_isp_sd_readl((&ncu->sd), NCU_START) & NCU_START_IDLE_MASK){
-			buf = pop_buffer_fifo(&ncu->infifo);
+			buf = tx_isp_fifo_pop(&ncu->infifo);
 			if(buf){
 				tx_isp_sd_writel(&ncu->sd, Y_CUR_ADDR, buf->addr);
 				tx_isp_sd_writel(&ncu->sd, UV_CUR_ADDR, buf->addr + ncu->uv_offset);
@@ -315,7 +282,7 @@ static int ncu_activate_module(struct tx_isp_subdev *sd)
 	private_spin_lock_irqsave(&ncu->slock, flags);
 	/* clk ops */
 	ncu_clks_ops(sd, 1);
-	init_buffer_fifo(&ncu->infifo);
+	tx_isp_fifo_init(&ncu->infifo);
 	ncu->state = TX_ISP_MODULE_ACTIVATE;
 	private_spin_unlock_irqrestore(&ncu->slock, flags);
 	return 0;
@@ -651,6 +618,7 @@ static int tx_isp_ncu_show(struct seq_file *m, void *v)
 	struct tx_isp_subdev_pad *inpad = IS_ERR_OR_NULL(sd) ? NULL : sd->inpads;
 	struct frame_channel_buffer *pos = NULL;
 	unsigned long flags = 0;
+	unsigned int index = 0;
 
 	if(IS_ERR_OR_NULL(ncu)){
 		ISP_ERROR("The parameter is invalid!\n");
@@ -664,9 +632,10 @@ static int tx_isp_ncu_show(struct seq_file *m, void *v)
 	if(inpad->link.flag & TX_ISP_PADLINK_LFB)
 		return len;
 	private_spin_lock_irqsave(&ncu->slock, flags);
-	tx_list_for_each_entry(pos, &ncu->infifo, entry){
+	tx_isp_fifo_for_each(&ncu->infifo, index, pos){
 		len += seq_printf(m ,"infifo addr: 0x%08x\n", pos->addr);
 	}
+	len += seq_printf(m ,"infifo high water = %d\n", ncu->infifo.high_water);
 	len += seq_printf(m ,"current inbuf addr: 0x%08x\n", ncu->current_inbuf ? ncu->current_inbuf->addr : 0);
 	len += seq_printf(m ,"ms_flag = %d\n", ncu->ms_flag);
 	len += seq_printf(m ,"start cnt = %lld, done_cnt = %lld\n", ncu->start_cnt, ncu->done_cnt);
@@ -724,7 +693,7 @@ static int tx_isp_ncu_probe(struct platform_device *pdev)
 			ncu_dev->inbufs[index].priv = (unsigned int)ncu_dev;
 		}
 	}
-	init_buffer_fifo(&ncu_dev->infifo);
+	tx_isp_fifo_init(&ncu_dev->infifo);
 	private_spin_lock_init(&ncu_dev->slock);
 	private_mutex_init(&ncu_dev->mlock);
 	ncu_dev->pdata = pdev->dev.platform_data;
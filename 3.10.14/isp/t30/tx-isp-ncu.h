@@ -7,6 +7,7 @@
 #include <linux/seq_file.h>
 
 #include <tx-isp-common.h>
+#include <tx-isp-fifo.h>
 #include <tx-ncu-regs.h>
 
 struct tx_isp_ncu_device {
@@ -23,7 +24,7 @@ struct tx_isp_ncu_device {
 	struct frame_channel_buffer *inbufs;
 	unsigned int buf_addr;
 	int num_inbufs;
-	struct list_head infifo;
+	struct tx_isp_fifo infifo;
 	struct frame_channel_buffer *current_inbuf;
 	int ms_flag;
 
@@ -0,0 +1,413 @@
+/*
+ * Video Class definitions of Tomahawk series SoC.
+ *
+ * Copyright 2017, <xianghui.shen@ingenic.com>
+ *
+ * This program is licensed "as is" without any
+ * warranty of any kind, whether express or implied.
+ */
+#include <linux/module.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <txx-funcs.h>
+#include <tx-isp-common.h>
+#include <tx-isp-list.h>
+#include <tx-isp-debug.h>
+#include <tx-isp-trace.h>
+
+static int isp_trace = 1;
+module_param(isp_trace, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(isp_trace, "isp pipeline trace, 0: off, 1: on");
+
+#define TX_ISP_TRACE_RING_MASK	(TX_ISP_TRACE_RING_SIZE - 1)
+#define TX_ISP_TRACE_DUMP_RECORDS	8
+
+struct tx_isp_trace_record {
+	unsigned int seq;
+	unsigned long long ts[TX_ISP_TRACE_STAGE_MAX];
+};
+
+struct tx_isp_trace_stat {
+	unsigned int count;
+	unsigned int extra;	/* stamps with no pending frame */
+	unsigned int lost;	/* frames overwritten before the stage saw them */
+	unsigned int max_us;
+	unsigned long long sum_us;
+	unsigned int hist[TX_ISP_TRACE_HIST_BUCKETS];
+	unsigned int depth;
+	unsigned int max_depth;
+	unsigned int drops[TX_ISP_DROP_CAUSE_MAX];
+};
+
+struct tx_isp_trace {
+	spinlock_t slock;
+	unsigned int head;	/* seq of the newest record, 0 means none */
+	unsigned int next[TX_ISP_TRACE_STAGE_MAX];
+	/* the output stages see every frame once per channel */
+	unsigned int chan_next[TX_ISP_TRACE_STAGE_MAX][TX_ISP_TRACE_CHANS];
+	struct tx_isp_trace_record ring[TX_ISP_TRACE_RING_SIZE];
+	struct tx_isp_trace_stat stats[TX_ISP_TRACE_STAGE_MAX];
+};
+
+static struct tx_isp_trace isp_trace_data = {
+	.slock = __SPIN_LOCK_UNLOCKED(isp_trace_data.slock),
+};
+
+static const char *stage_names[TX_ISP_TRACE_STAGE_MAX] = {
+	"vic", "core", "ldc", "ncu", "mscaler", "framechan",
+};
+
+static const char *drop_names[TX_ISP_DROP_CAUSE_MAX] = {
+	"vic error", "no buffer", "ldc reset", "ncu reset", "unmatched buffer",
+};
+
+static inline unsigned int trace_delta_us(unsigned long long now, unsigned long long then)
+{
+	unsigned long long delta = now - then;
+
+	/* anything beyond 4s is clamped, it lands in the last bucket anyway */
+	if(delta > 0xffffffffULL)
+		return 0xffffffff / 1000;
+	return (unsigned int)delta / 1000;
+}
+
+static inline void trace_account(struct tx_isp_trace_stat *stat, unsigned int us)
+{
+	int bucket = fls(us);
+
+	if(bucket >= TX_ISP_TRACE_HIST_BUCKETS)
+		bucket = TX_ISP_TRACE_HIST_BUCKETS - 1;
+	stat->hist[bucket]++;
+	stat->sum_us += us;
+	if(us > stat->max_us)
+		stat->max_us = us;
+}
+
+/*
+ * Find the oldest record a cursor still owes a stamp to and step the
+ * cursor past it, must hold slock.
+ */
+static struct tx_isp_trace_record *trace_pending_record(struct tx_isp_trace *trace,
+		struct tx_isp_trace_stat *stat, unsigned int *cursor)
+{
+	unsigned int seq = *cursor;
+
+	if(seq == 0 || seq > trace->head){
+		stat->extra++;
+		return NULL;
+	}
+	if(trace->head - seq >= TX_ISP_TRACE_RING_SIZE){
+		stat->lost += trace->head - seq - TX_ISP_TRACE_RING_SIZE + 1;
+		seq = trace->head - TX_ISP_TRACE_RING_SIZE + 1;
+	}
+	*cursor = seq + 1;
+	return &trace->ring[seq & TX_ISP_TRACE_RING_MASK];
+}
+
+/* a channel that starts late begins with the newest frame, must hold slock */
+static unsigned int *trace_chan_cursor(struct tx_isp_trace *trace,
+		enum tx_isp_trace_stage stage, unsigned int chan)
+{
+	unsigned int *cursor = &trace->chan_next[stage][chan];
+
+	if(*cursor == 0)
+		*cursor = trace->head;
+	return cursor;
+}
+
+void tx_isp_trace_stamp(enum tx_isp_trace_stage stage)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	struct tx_isp_trace_record *rec = NULL;
+	struct tx_isp_trace_stat *stat = NULL;
+	unsigned long long now = 0;
+	unsigned long long prev = 0;
+	unsigned long flags = 0;
+	int i = 0;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX)
+		return;
+
+	now = private_sched_clock();
+	stat = &trace->stats[stage];
+	private_spin_lock_irqsave(&trace->slock, flags);
+	if(stage == TX_ISP_TRACE_VIC){
+		/* vic latency is the frame interval */
+		if(trace->head){
+			prev = trace->ring[trace->head & TX_ISP_TRACE_RING_MASK].ts[TX_ISP_TRACE_VIC];
+			trace_account(stat, trace_delta_us(now, prev));
+		}
+		trace->head++;
+		rec = &trace->ring[trace->head & TX_ISP_TRACE_RING_MASK];
+		rec->seq = trace->head;
+		for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++)
+			rec->ts[i] = 0;
+		rec->ts[TX_ISP_TRACE_VIC] = now;
+		/* the first frame also starts the other stages' cursors */
+		for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++){
+			if(trace->next[i] == 0)
+				trace->next[i] = trace->head;
+		}
+		stat->count++;
+	}else{
+		rec = trace_pending_record(trace, stat, &trace->next[stage]);
+		if(rec){
+			rec->ts[stage] = now;
+			trace_account(stat, trace_delta_us(now, rec->ts[TX_ISP_TRACE_VIC]));
+			stat->count++;
+		}
+	}
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+/*
+ * Stamp of an output stage for one of its channels. Every channel keeps
+ * its own cursor, the record holds the stamp of the last channel done
+ * with the frame and every channel is accounted in the latencies.
+ */
+void tx_isp_trace_stamp_chan(enum tx_isp_trace_stage stage, unsigned int chan)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	struct tx_isp_trace_record *rec = NULL;
+	struct tx_isp_trace_stat *stat = NULL;
+	unsigned long long now = 0;
+	unsigned long flags = 0;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX || chan >= TX_ISP_TRACE_CHANS)
+		return;
+
+	now = private_sched_clock();
+	stat = &trace->stats[stage];
+	private_spin_lock_irqsave(&trace->slock, flags);
+	if(trace->head){
+		rec = trace_pending_record(trace, stat, trace_chan_cursor(trace, stage, chan));
+		if(rec){
+			rec->ts[stage] = now;
+			trace_account(stat, trace_delta_us(now, rec->ts[TX_ISP_TRACE_VIC]));
+			stat->count++;
+		}
+	}
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+/* the channel leaves the oldest pending frame out on purpose, e.g. its frame rate */
+void tx_isp_trace_skip_chan(enum tx_isp_trace_stage stage, unsigned int chan)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	unsigned int *cursor = NULL;
+	unsigned long flags = 0;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX || chan >= TX_ISP_TRACE_CHANS)
+		return;
+
+	private_spin_lock_irqsave(&trace->slock, flags);
+	if(trace->head){
+		cursor = trace_chan_cursor(trace, stage, chan);
+		if(*cursor <= trace->head)
+			(*cursor)++;
+	}
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+/* the channel starts streaming, it owes nothing to the frames before */
+void tx_isp_trace_start_chan(unsigned int chan)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	unsigned long flags = 0;
+	int i = 0;
+
+	if(chan >= TX_ISP_TRACE_CHANS)
+		return;
+
+	private_spin_lock_irqsave(&trace->slock, flags);
+	for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++)
+		trace->chan_next[i][chan] = 0;
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+void tx_isp_trace_depth(enum tx_isp_trace_stage stage, unsigned int depth)
+{
+	struct tx_isp_trace_stat *stat = NULL;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX)
+		return;
+	stat = &isp_trace_data.stats[stage];
+	stat->depth = depth;
+	if(depth > stat->max_depth)
+		stat->max_depth = depth;
+}
+
+void tx_isp_trace_fifo_depth(enum tx_isp_trace_stage stage, struct tx_isp_fifo *fifo)
+{
+	tx_isp_trace_depth(stage, tx_isp_fifo_depth(fifo));
+}
+
+void tx_isp_trace_drop(enum tx_isp_trace_stage stage, enum tx_isp_trace_drop cause)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	unsigned long flags = 0;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX || cause >= TX_ISP_DROP_CAUSE_MAX)
+		return;
+
+	private_spin_lock_irqsave(&trace->slock, flags);
+	trace->stats[stage].drops[cause]++;
+	/*
+	 * A dropped frame is done as far as this stage is concerned. Only
+	 * step over it when the stage is behind, several output channels may
+	 * report a drop for the same frame.
+	 */
+	if(stage != TX_ISP_TRACE_VIC && trace->next[stage] && trace->next[stage] < trace->head)
+		trace->next[stage]++;
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+/* a channel of an output stage dropped its frame, it won't be stamped */
+void tx_isp_trace_drop_chan(enum tx_isp_trace_stage stage, unsigned int chan,
+		enum tx_isp_trace_drop cause)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	unsigned int *cursor = NULL;
+	unsigned long flags = 0;
+
+	if(!isp_trace || stage >= TX_ISP_TRACE_STAGE_MAX || chan >= TX_ISP_TRACE_CHANS
+			|| cause >= TX_ISP_DROP_CAUSE_MAX)
+		return;
+
+	private_spin_lock_irqsave(&trace->slock, flags);
+	trace->stats[stage].drops[cause]++;
+	if(trace->head){
+		cursor = trace_chan_cursor(trace, stage, chan);
+		if(*cursor < trace->head)
+			(*cursor)++;
+	}
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+static void tx_isp_trace_reset(void)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	unsigned long flags = 0;
+
+	private_spin_lock_irqsave(&trace->slock, flags);
+	trace->head = 0;
+	memset(trace->next, 0, sizeof(trace->next));
+	memset(trace->chan_next, 0, sizeof(trace->chan_next));
+	memset(trace->ring, 0, sizeof(trace->ring));
+	memset(trace->stats, 0, sizeof(trace->stats));
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+}
+
+static int isp_trace_show(struct seq_file *m, void *v)
+{
+	struct tx_isp_trace *trace = &isp_trace_data;
+	struct tx_isp_trace_stat *stats = NULL;
+	struct tx_isp_trace_record *recs = NULL;
+	struct tx_isp_trace_record *rec = NULL;
+	unsigned long long avg = 0;
+	unsigned long flags = 0;
+	unsigned int head = 0;
+	unsigned int nrecs = 0;
+	int len = 0;
+	int i = 0, j = 0;
+
+	/* take a snapshot so the interrupt path is never held up by seq_printf */
+	stats = kmalloc(sizeof(trace->stats) + sizeof(trace->ring), GFP_KERNEL);
+	if(!stats)
+		return -ENOMEM;
+	recs = (struct tx_isp_trace_record *)((char *)stats + sizeof(trace->stats));
+	private_spin_lock_irqsave(&trace->slock, flags);
+	memcpy(stats, trace->stats, sizeof(trace->stats));
+	memcpy(recs, trace->ring, sizeof(trace->ring));
+	head = trace->head;
+	private_spin_unlock_irqrestore(&trace->slock, flags);
+
+	len += seq_printf(m, "trace: %s, frames: %u\n", isp_trace ? "on" : "off", head);
+	len += seq_printf(m, "%-10s %10s %8s %8s %8s %6s %6s %6s\n",
+			"stage", "count", "avg(us)", "max(us)", "lost", "extra", "depth", "maxdep");
+	for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++){
+		avg = stats[i].sum_us;
+		if(stats[i].count)
+			do_div(avg, stats[i].count);
+		len += seq_printf(m, "%-10s %10u %8u %8u %8u %6u %6u %6u\n", stage_names[i],
+				stats[i].count, (unsigned int)avg, stats[i].max_us, stats[i].lost,
+				stats[i].extra, stats[i].depth, stats[i].max_depth);
+	}
+
+	len += seq_printf(m, "\nlatency histogram (us from vic frame done, vic is frame interval)\n");
+	for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++){
+		if(stats[i].count == 0)
+			continue;
+		len += seq_printf(m, "%s:", stage_names[i]);
+		for(j = 0; j < TX_ISP_TRACE_HIST_BUCKETS; j++){
+			if(stats[i].hist[j] == 0)
+				continue;
+			if(j == TX_ISP_TRACE_HIST_BUCKETS - 1)
+				len += seq_printf(m, " >=%u:%u", 1 << (j - 1), stats[i].hist[j]);
+			else
+				len += seq_printf(m, " <%u:%u", 1 << j, stats[i].hist[j]);
+		}
+		len += seq_printf(m, "\n");
+	}
+
+	len += seq_printf(m, "\ndrops\n");
+	for(i = 0; i < TX_ISP_TRACE_STAGE_MAX; i++){
+		for(j = 0; j < TX_ISP_DROP_CAUSE_MAX; j++){
+			if(stats[i].drops[j])
+				len += seq_printf(m, "%s: %s %u\n", stage_names[i], drop_names[j], stats[i].drops[j]);
+		}
+	}
+
+	nrecs = head < TX_ISP_TRACE_DUMP_RECORDS ? head : TX_ISP_TRACE_DUMP_RECORDS;
+	len += seq_printf(m, "\nrecent frames (us from vic frame done, - not reached)\n");
+	for(i = nrecs - 1; i >= 0; i--){
+		rec = &recs[(head - i) & TX_ISP_TRACE_RING_MASK];
+		len += seq_printf(m, "%u:", rec->seq);
+		for(j = TX_ISP_TRACE_CORE; j < TX_ISP_TRACE_STAGE_MAX; j++){
+			if(rec->ts[j])
+				len += seq_printf(m, " %s %u", stage_names[j],
+						trace_delta_us(rec->ts[j], rec->ts[TX_ISP_TRACE_VIC]));
+			else
+				len += seq_printf(m, " %s -", stage_names[j]);
+		}
+		len += seq_printf(m, "\n");
+	}
+
+	kfree(stats);
+	return len;
+}
+
+static ssize_t isp_trace_write(struct file *file, const char __user *buffer, size_t count, loff_t *f_pos)
+{
+	char cmd[8] = {0};
+
+	if(copy_from_user(cmd, buffer, count < sizeof(cmd) - 1 ? count : sizeof(cmd) - 1))
+		return -EFAULT;
+	if(!strncmp(cmd, "clear", 5))
+		tx_isp_trace_reset();
+	else
+		ISP_WRANING("isp-trace: only \"clear\" is supported\n");
+	return count;
+}
+
+static int dump_isp_trace_open(struct inode *inode, struct file *file)
+{
+	return private_single_open_size(file, isp_trace_show, PDE_DATA(inode), 4096);
+}
+
+static struct file_operations isp_trace_fops ={
+	.read = private_seq_read,
+	.open = dump_isp_trace_open,
+	.llseek = private_seq_lseek,
+	.release = private_single_release,
+	.write = isp_trace_write,
+};
+
+int tx_isp_trace_proc_init(struct proc_dir_entry *parent)
+{
+	if(!private_proc_create_data("isp-trace", S_IRUGO | S_IWUSR, parent, &isp_trace_fops, NULL)){
+		ISP_ERROR("Failed to create isp-trace node!\n");
+		return -ENOMEM;
+	}
+	return ISP_SUCCESS;
+}
@@ -1,6 +1,8 @@
 #include <linux/delay.h>
+#include <linux/ratelimit.h>
 #include "../tx-isp-videobuf.h"
 #include "tx-isp-vic.h"
+#include <tx-isp-trace.h>
 
 void dump_vic_reg(struct tx_isp_vic_device *vsd)
 {
@@ -426,10 +428,57 @@ static int vic_sensor_ops_sync_sensor_attr(struct tx_isp_subdev *sd, void *arg)
 
 
 
+extern void tx_isp_core_drop_frame(void);
+static DEFINE_RATELIMIT_STATE(vic_recovery_rs, 5 * HZ, 1);
+
+/*
+ * VIC error recovery.
+ *
+ * An error resets the VIC and restarts it right away, so it picks the
+ * stream up again at the next frame start without touching the sensor
+ * or the downstream modules. The ISP core is told to keep the buffers of
+ * the broken frame in their banks, they are written again by the next
+ * frame instead of going to userspace. Recovery ends at the first good
+ * frame; errors during resync reset the VIC again but are charged to the
+ * same recovery. Only a rate-limited summary is printed.
+ */
+static void vic_error_recover(struct tx_isp_vic_device *vd, unsigned int pending)
+{
+	unsigned int tmp = 0;
+	int i = 0;
+
+	for(i = 0; i < VIC_ERROR_TYPES; i++){
+		if(pending & (1 << (VIC_ERROR_SHIFT + i)))
+			vd->err_cnt[i]++;
+	}
+	tx_isp_trace_drop(TX_ISP_TRACE_VIC, TX_ISP_DROP_VIC_ERROR);
+
+	tmp = tx_isp_vic_readl(vd, VIC_CONTROL);
+	tmp |= VIC_RESET;
+	tx_isp_vic_writel(vd, VIC_CONTROL, tmp);
+	tx_isp_vic_writel(vd, VIC_CONTROL, VIC_SRART);
+
+	if(vd->recovery == TX_ISP_VIC_RECOVERY_IDLE){
+		vd->recovery_start = private_sched_clock();
+		vd->recovery = TX_ISP_VIC_RECOVERY_RESYNC;
+	}
+	tx_isp_core_drop_frame();
+}
+
+static void vic_error_resynced(struct tx_isp_vic_device *vd)
+{
+	vd->recovery_us = div_u64(private_sched_clock() - vd->recovery_start, 1000);
+	if(vd->recovery_us > vd->max_recovery_us)
+		vd->max_recovery_us = vd->recovery_us;
+	vd->recovery_cnt++;
+	vd->recovery = TX_ISP_VIC_RECOVERY_IDLE;
+	if(__ratelimit(&vic_recovery_rs))
+		ISP_WRANING("VIC recovered in %d us (%d recoveries)\n", vd->recovery_us, vd->recovery_cnt);
+}
+
 static irqreturn_t isp_vic_interrupt_service_routine(struct tx_isp_subdev *sd, u32 status, bool *handled)
 {
 	struct tx_isp_vic_device *vd = IS_ERR_OR_NULL(sd) ? NULL : tx_isp_get_subdevdata(sd);
-	unsigned int tmp = 0;
 	volatile unsigned int state, pending, mask;
 
 	if(IS_ERR_OR_NULL(vd))
@@ -439,23 +488,10 @@ static irqreturn_t isp_vic_interrupt_service_routine(struct tx_isp_subdev *sd, u
 	state = tx_isp_sd_readl(sd, TX_ISP_TOP_IRQ_STA);
 	pending = state & (~mask);
 	tx_isp_sd_writel(sd, TX_ISP_TOP_IRQ_CLR_1, pending);
-#ifdef CONFIG_SOC_T10
-	if((0x3 << 19) & pending){
-		tmp = tx_isp_vic_readl(vd, VIC_CONTROL);
-		tmp |= VIC_RESET;
-		tx_isp_vic_writel(vd, VIC_CONTROL, tmp);
-		printk("## VIC ERROR status = 0x%08x\n", pending);
-		tx_isp_vic_writel(vd, VIC_CONTROL, VIC_SRART);
-	}
-#else
 	/*printk("pending=0x%08x, mask = 0x%08x state = 0x%08x\n",pending,mask,state);*/
-	if((0x3 << 20) & pending){
-		tmp = tx_isp_vic_readl(vd, VIC_CONTROL);
-		tmp |= VIC_RESET;
-		tx_isp_vic_writel(vd, VIC_CONTROL, tmp);
-		printk("## VIC ERROR status = 0x%08x\n", pending);
+	if(VIC_ERROR_MASK & pending){
+		vic_error_recover(vd, pending);
 	}
-#endif
 
 	if ((0x1<<24) & pending){
 		ISP_INFO("## [0x%08x] = 0x%08x ##\n",0xb330024c,*(volatile unsigned int*)(0xb330024c));
@@ -476,6 +512,9 @@ static irqreturn_t isp_vic_interrupt_service_routine(struct tx_isp_subdev *sd, u
 	/*vic frd interrupt */
 	if (0x10000 & pending) {
 		vd->vic_frd_c++;
+		tx_isp_trace_stamp(TX_ISP_TRACE_VIC);
+		if(vd->recovery == TX_ISP_VIC_RECOVERY_RESYNC && !(VIC_ERROR_MASK & pending))
+			vic_error_resynced(vd);
 		/*printk("## vic %d ##\n", vd->vic_frd_c);*/
 	}
 
@@ -577,6 +616,7 @@ static int vic_core_s_stream(struct tx_isp_subdev *sd, int enable)
 
 	if (enable) {
 		ret = tx_isp_vic_start(vd);
+		vd->recovery = TX_ISP_VIC_RECOVERY_IDLE;
 		vd->state = TX_ISP_MODULE_RUNNING;
 		/*printk("vic------------start 0x%08x\n", tx_isp_sd_readl(sd, TX_ISP_TOP_IRQ_ENABLE));*/
 	}else {
@@ -758,12 +798,18 @@ static int isp_vic_frd_show(struct seq_file *m, void *v)
 	struct tx_isp_module *module = (void *)(m->private);
 	struct tx_isp_subdev *sd = IS_ERR_OR_NULL(module) ? NULL : module_to_subdev(module);
 	struct tx_isp_vic_device *vd = IS_ERR_OR_NULL(sd) ? NULL : tx_isp_get_subdevdata(sd);
+	int i = 0;
 
 	if(IS_ERR_OR_NULL(vd)){
 		ISP_ERROR("The parameter is invalid!\n");
 		return 0;
 	}
 	len += seq_printf(m ," %d\n", vd->vic_frd_c);
+	for(i = 0; i < VIC_ERROR_TYPES; i++)
+		len += seq_printf(m ,"error(bit%d): %d\n", VIC_ERROR_SHIFT + i, vd->err_cnt[i]);
+	len += seq_printf(m ,"recoveries: %d%s\n", vd->recovery_cnt,
+			vd->recovery == TX_ISP_VIC_RECOVERY_RESYNC ? " (resyncing)" : "");
+	len += seq_printf(m ,"recovery time: last %d us, max %d us\n", vd->recovery_us, vd->max_recovery_us);
 	return len;
 }
 static int dump_isp_vic_frd_open(struct inode *inode, struct file *file)
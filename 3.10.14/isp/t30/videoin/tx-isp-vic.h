@@ -7,6 +7,20 @@
 /*#include <linux/seq_file.h>*/
 #include <linux/proc_fs.h>
 /*#include <jz_proc.h>*/
+
+#ifdef CONFIG_SOC_T10
+#define VIC_ERROR_SHIFT		19
+#else
+#define VIC_ERROR_SHIFT		20
+#endif
+#define VIC_ERROR_TYPES		2
+#define VIC_ERROR_MASK		(((1 << VIC_ERROR_TYPES) - 1) << VIC_ERROR_SHIFT)
+
+enum tx_isp_vic_recovery_state {
+	TX_ISP_VIC_RECOVERY_IDLE,
+	TX_ISP_VIC_RECOVERY_RESYNC,	/* VIC was reset, waiting for a good frame */
+};
+
 struct tx_isp_vic_device {
 	struct tx_isp_subdev sd;
 	struct tx_isp_video_in vin;
@@ -22,6 +36,13 @@ struct tx_isp_vic_device {
 	struct mutex snap_mlock;
 	unsigned int vic_frd_c;
 
+	/* error recovery */
+	int recovery;
+	unsigned long long recovery_start;
+	unsigned int err_cnt[VIC_ERROR_TYPES];
+	unsigned int recovery_cnt;
+	unsigned int recovery_us;
+	unsigned int max_recovery_us;
 };
 
 #define tx_isp_vic_readl(port,reg)						\
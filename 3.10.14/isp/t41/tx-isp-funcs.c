@@ -373,12 +373,17 @@ void private_iounmap(const volatile void __iomem *addr)
 	iounmap(addr);
 }
 
-/* interrupt interfaces */
+/* interrupt interfaces, the frame sync groups take the vic timestamps on the way */
+extern int isp_fsync_request_irq(unsigned int irq, irq_handler_t handler,
+				 irq_handler_t thread_fn, unsigned long irqflags,
+				 const char *devname, void *dev_id);
+extern void isp_fsync_free_irq(unsigned int irq, void *dev_id);
+
 int private_request_threaded_irq(unsigned int irq, irq_handler_t handler,
 				 irq_handler_t thread_fn, unsigned long irqflags,
 				 const char *devname, void *dev_id)
 {
-	return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+	return isp_fsync_request_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
 }
 
 void private_enable_irq(unsigned int irq)
@@ -393,7 +398,7 @@ void private_disable_irq(unsigned int irq)
 
 void private_free_irq(unsigned int irq, void *dev_id)
 {
-	free_irq(irq, dev_id);
+	isp_fsync_free_irq(irq, dev_id);
 }
 
 /* lock and mutex interfaces */
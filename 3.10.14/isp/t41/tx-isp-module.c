@@ -13,15 +13,30 @@
 
 extern int tx_isp_init(void);
 extern void tx_isp_exit(void);
+extern int isp_fsync_init(void);
+extern void isp_fsync_exit(void);
 
 static int __init tx_isp_module_init(void)
 {
-	return tx_isp_init();
+	int ret = 0;
+
+	ret = isp_fsync_init();
+	if(ret)
+		return ret;
+	ret = tx_isp_init();
+	if(ret)
+		goto err_fsync;
+	return 0;
+
+err_fsync:
+	isp_fsync_exit();
+	return ret;
 }
 
 static void __exit tx_isp_module_exit(void)
 {
 	tx_isp_exit();
+	isp_fsync_exit();
 }
 
 module_init(tx_isp_module_init);
@@ -0,0 +1,730 @@
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
+#include <linux/sched.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+#include <sensor-core.h>
+
+#if defined(CONFIG_SOC_T10) || defined(CONFIG_SOC_T20)
+#define sensor_core_i2c_transfer i2c_transfer
+#define sensor_core_msleep msleep
+#else
+#include <txx-funcs.h>
+#define sensor_core_i2c_transfer private_i2c_transfer
+#define sensor_core_msleep private_msleep
+#endif
+
+#define SENSOR_BURST_MAX 32	/* values per message */
+#define SENSOR_GROUP_MSGS 16	/* messages per group write */
+#define SENSOR_GROUP_BYTES 64
+
+static int i2c_burst = 1;
+module_param(i2c_burst, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_burst, "write consecutive sensor registers in one i2c message");
+
+static int i2c_shadow = 1;
+module_param(i2c_shadow, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_shadow, "skip writes of sensor registers that already hold the value");
+
+static int i2c_profile = 0;
+module_param(i2c_profile, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_profile, "account the sensor i2c traffic per operation");
+
+static int i2c_retries = 0;
+module_param(i2c_retries, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_retries, "times a failed sensor i2c transfer is tried again");
+
+static int async_powerup = 0;
+module_param(async_powerup, int, S_IRUGO);
+MODULE_PARM_DESC(async_powerup, "power up and detect the sensor at probe time in the background");
+
+static const char *sensor_op_names[SENSOR_OP_NUMS] = {
+	[SENSOR_OP_OTHER] = "other",
+	[SENSOR_OP_INIT] = "init",
+	[SENSOR_OP_EXPO] = "expo",
+	[SENSOR_OP_FPS] = "fps",
+	[SENSOR_OP_FLIP] = "flip",
+};
+
+/* the op state and the statistics of every burst of the module */
+static DEFINE_SPINLOCK(sensor_profile_lock);
+
+const char *sensor_op_name(enum sensor_op op)
+{
+	return op < SENSOR_OP_NUMS ? sensor_op_names[op] : "?";
+}
+
+/*
+ * The op belongs to the task that began it. Another task running into it,
+ * an ioctl next to the isp's per frame updates, neither nests in it nor
+ * is timed; its transfers are accounted to "other".
+ */
+void sensor_profile_begin(struct sensor_burst *burst, enum sensor_op op)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&sensor_profile_lock, flags);
+	if (!burst->op_depth) {
+		burst->op = op;
+		burst->op_owner = current;
+		burst->op_start = ktime_get();
+	}
+	if (burst->op_owner == current)
+		burst->op_depth++;
+	spin_unlock_irqrestore(&sensor_profile_lock, flags);
+}
+
+void sensor_profile_end(struct sensor_burst *burst)
+{
+	struct sensor_op_stat *stat;
+	unsigned long flags;
+	unsigned int us;
+	unsigned int bucket;
+
+	spin_lock_irqsave(&sensor_profile_lock, flags);
+	if (!burst->op_depth || burst->op_owner != current || --burst->op_depth)
+		goto unlock;
+	if (i2c_profile) {
+		stat = &burst->ops[burst->op];
+		us = ktime_us_delta(ktime_get(), burst->op_start);
+		bucket = min_t(unsigned int, fls(us), SENSOR_PROFILE_HIST - 1);
+		stat->ops++;
+		stat->us += us;
+		stat->max_us = max(stat->max_us, us);
+		stat->hist[bucket]++;
+	}
+	burst->op = SENSOR_OP_OTHER;
+	burst->op_owner = NULL;
+unlock:
+	spin_unlock_irqrestore(&sensor_profile_lock, flags);
+}
+
+void sensor_profile_clear(struct sensor_burst *burst)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&sensor_profile_lock, flags);
+	memset(burst->ops, 0, sizeof(burst->ops));
+	burst->profile_since = ktime_get();
+	spin_unlock_irqrestore(&sensor_profile_lock, flags);
+}
+
+/* i2c_transfer with the retries and the accounting of the caller's op */
+static int sensor_core_transfer(struct i2c_client *client, struct sensor_burst *burst,
+				struct i2c_msg *msgs, int num)
+{
+	struct sensor_op_stat *stat;
+	unsigned long flags;
+	int tries = 0;
+	int ret, i;
+
+	while ((ret = sensor_core_i2c_transfer(client->adapter, msgs, num)) < 0
+	       && tries < i2c_retries)
+		tries++;
+	if (!i2c_profile)
+		return ret;
+	spin_lock_irqsave(&sensor_profile_lock, flags);
+	stat = &burst->ops[burst->op_owner == current ? burst->op : SENSOR_OP_OTHER];
+	stat->retries += tries;
+	if (ret < 0) {
+		stat->errors++;
+		goto unlock;
+	}
+	if (msgs[num - 1].flags & I2C_M_RD)
+		stat->reads++;
+	for (i = 0; i < num; i++) {
+		if (!(msgs[i].flags & I2C_M_RD))
+			stat->writes++;
+		stat->bytes += msgs[i].len;
+	}
+unlock:
+	spin_unlock_irqrestore(&sensor_profile_lock, flags);
+	return ret;
+}
+
+static bool sensor_burst_barrier(struct sensor_burst *burst, uint16_t reg)
+{
+	unsigned int i;
+
+	for (i = 0; i < burst->barrier_nums; i++) {
+		if (burst->barriers[i] == reg)
+			return true;
+	}
+	return false;
+}
+
+static inline void sensor_shadow_clear(struct sensor_burst *burst)
+{
+	memset(burst->shadow, 0, sizeof(burst->shadow));
+}
+
+/* the entry of reg, or the free one it would take; NULL when full */
+static struct sensor_shadow_reg *sensor_shadow_find(struct sensor_burst *burst, uint16_t reg)
+{
+	struct sensor_shadow_reg *e;
+	unsigned int i;
+
+	for (i = 0; i < SENSOR_SHADOW_NUMS; i++) {
+		e = &burst->shadow[(reg + i) % SENSOR_SHADOW_NUMS];
+		if (!e->valid || e->reg_num == reg)
+			return e;
+	}
+	return NULL;
+}
+
+/* a barrier always reaches the sensor, whatever the shadow holds */
+static bool sensor_shadow_same(struct sensor_burst *burst, uint16_t reg, unsigned char value)
+{
+	struct sensor_shadow_reg *e;
+
+	if (!i2c_shadow || sensor_burst_barrier(burst, reg))
+		return false;
+	e = sensor_shadow_find(burst, reg);
+	return e && e->valid && e->value == value;
+}
+
+static void sensor_shadow_store(struct sensor_burst *burst, uint16_t reg, unsigned char value)
+{
+	struct sensor_shadow_reg *e = sensor_shadow_find(burst, reg);
+
+	if (sensor_burst_barrier(burst, reg) && !(e && e->valid && e->value == value)) {
+		sensor_shadow_clear(burst);
+		e = sensor_shadow_find(burst, reg);
+	}
+	if (!e)
+		return;
+	e->reg_num = reg;
+	e->value = value;
+	e->valid = 1;
+}
+
+/* how many entries from vals can go out in one message */
+static int sensor_burst_run(struct sensor_burst *burst, const struct sensor_regval *vals)
+{
+	int run = 1;
+
+	if (!i2c_burst || burst->no_auto_inc || sensor_burst_barrier(burst, vals[0].reg_num))
+		return 1;
+	while (run < SENSOR_BURST_MAX) {
+		uint16_t reg = vals[run].reg_num;
+
+		if (reg == burst->reg_end || reg == burst->reg_delay
+		    || reg != vals[run - 1].reg_num + 1 || sensor_burst_barrier(burst, reg))
+			break;
+		run++;
+	}
+	return run;
+}
+
+/*
+ * Write a register table the way the drivers' sensor_write_array() does,
+ * delays included, with runs of consecutive registers sent as a single
+ * auto-increment message.
+ */
+static int sensor_burst_write_vals(struct i2c_client *client, struct sensor_burst *burst,
+				   const struct sensor_regval *vals)
+{
+	unsigned char buf[2 + SENSOR_BURST_MAX];
+	struct i2c_msg msg = {
+		.addr = client->addr,
+		.flags = 0,
+		.buf = buf,
+	};
+	unsigned int regs = 0;
+	unsigned int transfers = 0;
+	ktime_t start = ktime_get();
+	int head, run, i;
+	int ret;
+
+	sensor_shadow_clear(burst);
+	while (vals->reg_num != burst->reg_end) {
+		if (vals->reg_num == burst->reg_delay) {
+			sensor_core_msleep(vals->value);
+			vals++;
+			continue;
+		}
+		head = 0;
+		if (burst->reg_bytes == 2)
+			buf[head++] = (vals->reg_num >> 8) & 0xff;
+		buf[head++] = vals->reg_num & 0xff;
+		run = sensor_burst_run(burst, vals);
+		for (i = 0; i < run; i++)
+			buf[head + i] = vals[i].value;
+		msg.len = head + run;
+		ret = sensor_core_transfer(client, burst, &msg, 1);
+		if (ret < 0)
+			return ret;
+		regs += run;
+		transfers++;
+		vals += run;
+	}
+
+	burst->last_regs = regs;
+	burst->last_transfers = transfers;
+	burst->last_us = ktime_us_delta(ktime_get(), start);
+	burst->total_regs += regs;
+	burst->total_transfers += transfers;
+	return 0;
+}
+
+int sensor_burst_write_array(struct i2c_client *client, struct sensor_burst *burst,
+			     const struct sensor_regval *vals)
+{
+	int ret;
+
+	sensor_profile_begin(burst, SENSOR_OP_INIT);
+	ret = sensor_burst_write_vals(client, burst, vals);
+	sensor_profile_end(burst);
+	return ret;
+}
+
+static int sensor_core_put_reg(struct sensor_burst *burst, unsigned char *buf, uint16_t reg)
+{
+	int head = 0;
+
+	if (burst->reg_bytes == 2)
+		buf[head++] = (reg >> 8) & 0xff;
+	buf[head++] = reg & 0xff;
+	return head;
+}
+
+/* how many of the n values at reg can go out in one message */
+static int sensor_packed_run(struct sensor_burst *burst, uint16_t reg, int n)
+{
+	int run = 1;
+
+	if (!i2c_burst || burst->no_auto_inc || sensor_burst_barrier(burst, reg))
+		return 1;
+	while (run < n && run < SENSOR_BURST_MAX && !sensor_burst_barrier(burst, reg + run))
+		run++;
+	return run;
+}
+
+static int sensor_burst_write_bytes(struct i2c_client *client, struct sensor_burst *burst,
+				    const unsigned char *p)
+{
+	unsigned char buf[2 + SENSOR_BURST_MAX];
+	struct i2c_msg msg = {
+		.addr = client->addr,
+		.flags = 0,
+		.buf = buf,
+	};
+	unsigned int regs = 0;
+	unsigned int transfers = 0;
+	ktime_t start = ktime_get();
+	uint16_t reg = 0;
+	int head, n, run;
+	int ret;
+
+	sensor_shadow_clear(burst);
+	while (*p != SENSOR_PACKED_END) {
+		if (*p == SENSOR_PACKED_ADDR) {
+			reg = p[1];
+			if (burst->reg_bytes == 2)
+				reg = (reg << 8) | p[2];
+			p += 1 + burst->reg_bytes;
+			continue;
+		}
+		if (*p == SENSOR_PACKED_DELAY) {
+			sensor_core_msleep(p[1]);
+			p += 2;
+			continue;
+		}
+		if (*p & SENSOR_PACKED_ADDR)
+			return -EINVAL;
+		if (*p & SENSOR_PACKED_SKIP) {
+			reg += (*p & SENSOR_PACKED_LEN_MASK) + 1;
+			p++;
+			continue;
+		}
+		n = (*p++ & SENSOR_PACKED_LEN_MASK) + 1;
+		while (n) {
+			run = sensor_packed_run(burst, reg, n);
+			head = sensor_core_put_reg(burst, buf, reg);
+			memcpy(buf + head, p, run);
+			msg.len = head + run;
+			ret = sensor_core_transfer(client, burst, &msg, 1);
+			if (ret < 0)
+				return ret;
+			regs += run;
+			transfers++;
+			reg += run;
+			p += run;
+			n -= run;
+		}
+	}
+
+	burst->last_regs = regs;
+	burst->last_transfers = transfers;
+	burst->last_us = ktime_us_delta(ktime_get(), start);
+	burst->total_regs += regs;
+	burst->total_transfers += transfers;
+	return 0;
+}
+
+/*
+ * Write a packed table. Its runs are already the auto-increment messages,
+ * they are only cut at SENSOR_BURST_MAX and before a barrier register.
+ */
+int sensor_burst_write_packed(struct i2c_client *client, struct sensor_burst *burst,
+			      const unsigned char *p)
+{
+	int ret;
+
+	sensor_profile_begin(burst, SENSOR_OP_INIT);
+	ret = sensor_burst_write_bytes(client, burst, p);
+	sensor_profile_end(burst);
+	return ret;
+}
+
+/*
+ * A single register write that always reaches the sensor and updates the
+ * shadow, for debug and ioctl writes whose value the driver doesn't track.
+ */
+int sensor_shadow_write_through(struct i2c_client *client, struct sensor_burst *burst,
+				uint16_t reg, unsigned char value)
+{
+	unsigned char buf[3];
+	struct i2c_msg msg = {
+		.addr = client->addr,
+		.flags = 0,
+		.buf = buf,
+	};
+	int ret;
+
+	msg.len = sensor_core_put_reg(burst, buf, reg);
+	buf[msg.len++] = value;
+	ret = sensor_core_transfer(client, burst, &msg, 1);
+	if (ret < 0)
+		return ret;
+	sensor_shadow_store(burst, reg, value);
+	burst->shadow_issued++;
+	return 0;
+}
+
+/* a single register write that is dropped when the sensor already holds value */
+int sensor_shadow_write(struct i2c_client *client, struct sensor_burst *burst,
+			uint16_t reg, unsigned char value)
+{
+	if (sensor_shadow_same(burst, reg, value)) {
+		burst->shadow_suppressed++;
+		return 0;
+	}
+	return sensor_shadow_write_through(client, burst, reg, value);
+}
+
+/* read a register from the sensor, past the shadow and without storing it */
+int sensor_core_read(struct i2c_client *client, struct sensor_burst *burst,
+		     uint16_t reg, unsigned char *value)
+{
+	unsigned char buf[2];
+	struct i2c_msg msg[2] = {
+		[0] = {
+			.addr = client->addr,
+			.flags = 0,
+			.buf = buf,
+		},
+		[1] = {
+			.addr = client->addr,
+			.flags = I2C_M_RD,
+			.len = 1,
+			.buf = value,
+		}
+	};
+	int ret;
+
+	msg[0].len = sensor_core_put_reg(burst, buf, reg);
+	ret = sensor_core_transfer(client, burst, msg, 2);
+	return ret < 0 ? ret : 0;
+}
+
+/*
+ * Read a register, from the shadow when it is there. Only for registers
+ * the sensor doesn't change by itself, such as the timing set up by the
+ * init table.
+ */
+int sensor_shadow_read(struct i2c_client *client, struct sensor_burst *burst,
+		       uint16_t reg, unsigned char *value)
+{
+	struct sensor_shadow_reg *e = sensor_shadow_find(burst, reg);
+	int ret;
+
+	if (i2c_shadow && e && e->valid) {
+		*value = e->value;
+		burst->shadow_hits++;
+		return 0;
+	}
+	ret = sensor_core_read(client, burst, reg, value);
+	if (ret)
+		return ret;
+	sensor_shadow_store(burst, reg, *value);
+	return 0;
+}
+
+/* the value the table leaves in reg, -1 when it doesn't write it */
+static int sensor_handoff_expect(struct sensor_burst *burst, const struct sensor_regval *vals,
+				 uint16_t reg)
+{
+	int value = -1;
+
+	for (; vals->reg_num != burst->reg_end; vals++) {
+		if (vals->reg_num == reg)
+			value = vals->value;
+	}
+	return value;
+}
+
+/*
+ * 1 when the running sensor was adopted, 0 when mode has to be written.
+ * The registers read stay in the shadow of an adopted sensor.
+ */
+int sensor_handoff_check(struct i2c_client *client, struct sensor_burst *burst,
+			 struct sensor_handoff *handoff, const struct sensor_regval *mode)
+{
+	const struct sensor_regval *vals;
+	ktime_t start = ktime_get();
+	unsigned int reads = 0;
+	unsigned int table_us;
+	unsigned char value;
+	int expect;
+	unsigned int i;
+	int ret;
+
+	handoff->adopted = 0;
+	handoff->skipped_regs = 0;
+	handoff->skipped_ms = 0;
+	handoff->saved_us = 0;
+	sensor_shadow_clear(burst);
+
+	for (vals = handoff->id; vals->reg_num != burst->reg_end; vals++) {
+		ret = sensor_shadow_read(client, burst, vals->reg_num, &value);
+		reads++;
+		if (ret < 0 || value != vals->value)
+			goto mismatch;
+	}
+	for (i = 0; i < handoff->sig_nums; i++) {
+		expect = sensor_handoff_expect(burst, mode, handoff->sig[i]);
+		if (expect < 0)
+			continue;
+		ret = sensor_shadow_read(client, burst, handoff->sig[i], &value);
+		reads++;
+		if (ret < 0 || value != expect)
+			goto mismatch;
+	}
+	handoff->check_us = ktime_us_delta(ktime_get(), start);
+
+	for (vals = mode; vals->reg_num != burst->reg_end; vals++) {
+		if (vals->reg_num == burst->reg_delay)
+			handoff->skipped_ms += vals->value;
+		else
+			handoff->skipped_regs++;
+	}
+	/* a register read costs about what a single register write does */
+	table_us = handoff->skipped_regs * (handoff->check_us / max(reads, 1U))
+		+ handoff->skipped_ms * 1000;
+	if (table_us > handoff->check_us)
+		handoff->saved_us = table_us - handoff->check_us;
+	handoff->adopted = 1;
+	return 1;
+
+mismatch:
+	handoff->check_us = ktime_us_delta(ktime_get(), start);
+	sensor_shadow_clear(burst);
+	return 0;
+}
+
+struct sensor_group {
+	struct i2c_msg msgs[SENSOR_GROUP_MSGS];
+	unsigned char buf[SENSOR_GROUP_BYTES];
+	int msg_nums;
+	int used;
+};
+
+static int sensor_group_add(struct i2c_client *client, struct sensor_burst *burst,
+			    struct sensor_group *group, const struct sensor_regval *vals, int run)
+{
+	unsigned char *buf = group->buf + group->used;
+	struct i2c_msg *msg = &group->msgs[group->msg_nums];
+	int head;
+	int i;
+
+	if (group->msg_nums == SENSOR_GROUP_MSGS
+	    || group->used + burst->reg_bytes + run > SENSOR_GROUP_BYTES)
+		return -ENOSPC;
+	head = sensor_core_put_reg(burst, buf, vals->reg_num);
+	for (i = 0; i < run; i++)
+		buf[head + i] = vals[i].value;
+
+	msg->addr = client->addr;
+	msg->flags = 0;
+	msg->len = head + run;
+	msg->buf = buf;
+	group->msg_nums++;
+	group->used += msg->len;
+	return 0;
+}
+
+static int sensor_group_add_hold(struct i2c_client *client, struct sensor_burst *burst,
+				 struct sensor_group *group, const struct sensor_regval *vals)
+{
+	int ret = 0;
+
+	for (; vals && vals->reg_num != burst->reg_end && !ret; vals++)
+		ret = sensor_group_add(client, burst, group, vals, 1);
+	return ret;
+}
+
+/*
+ * Write a short table, the per frame exposure and gain registers, in a
+ * single i2c_transfer wrapped in the sensor's group hold, so that all of
+ * it takes effect on the same frame. Delays are not allowed here. Runs
+ * the sensor already holds are left out, and if nothing is left there is
+ * no transfer at all.
+ */
+static int sensor_group_write_vals(struct i2c_client *client, struct sensor_burst *burst,
+				   const struct sensor_regval *vals)
+{
+	const struct sensor_regval *first = vals;
+	struct sensor_group group;
+	unsigned int issued = 0;
+	unsigned int suppressed = 0;
+	int run, i;
+	int ret;
+
+	group.msg_nums = 0;
+	group.used = 0;
+	ret = sensor_group_add_hold(client, burst, &group, burst->hold_begin);
+	while (!ret && vals->reg_num != burst->reg_end) {
+		if (vals->reg_num == burst->reg_delay)
+			return -EINVAL;
+		run = sensor_burst_run(burst, vals);
+		for (i = 0; i < run && sensor_shadow_same(burst, vals[i].reg_num, vals[i].value); i++)
+			;
+		if (i == run) {
+			suppressed += run;
+		} else {
+			ret = sensor_group_add(client, burst, &group, vals, run);
+			issued += run;
+		}
+		vals += run;
+	}
+	if (!ret)
+		ret = sensor_group_add_hold(client, burst, &group, burst->hold_end);
+	if (ret < 0) {
+		pr_err("%s: group write of %d messages overflows\n", __func__, group.msg_nums);
+		return ret;
+	}
+
+	burst->shadow_suppressed += suppressed;
+	if (!issued)
+		return 0;
+	ret = sensor_core_transfer(client, burst, group.msgs, group.msg_nums);
+	if (ret < 0)
+		return ret;
+	for (vals = first; vals->reg_num != burst->reg_end; vals++)
+		sensor_shadow_store(burst, vals->reg_num, vals->value);
+	burst->shadow_issued += issued;
+	return 0;
+}
+
+int sensor_group_write_array(struct i2c_client *client, struct sensor_burst *burst,
+			     const struct sensor_regval *vals)
+{
+	int ret;
+
+	sensor_profile_begin(burst, SENSOR_OP_EXPO);
+	ret = sensor_group_write_vals(client, burst, vals);
+	sensor_profile_end(burst);
+	return ret;
+}
+
+static inline unsigned int sensor_gain_at(const void *lut, size_t size, size_t gain_off, unsigned int i)
+{
+	return *(const unsigned int *)((const char *)lut + i * size + gain_off);
+}
+
+/* first entry in [0, nums) whose gain is above gain, or nums */
+static unsigned int sensor_gain_upper(const void *lut, size_t size, unsigned int nums,
+				      size_t gain_off, unsigned int gain)
+{
+	unsigned int lo = 0, hi = nums, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (sensor_gain_at(lut, size, gain_off, mid) > gain)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+/*
+ * Binary search version of the walk each driver had: entries above
+ * max_gain are out, isp_gain 0 takes the first entry, a gain below the
+ * top takes the largest entry not above it, and a gain at or past
+ * max_gain takes the first entry equal to max_gain.
+ */
+int sensor_gain_lut_find(const void *lut, size_t size, unsigned int nums, size_t gain_off,
+			 unsigned int isp_gain, unsigned int max_gain)
+{
+	unsigned int top = sensor_gain_upper(lut, size, nums, gain_off, max_gain);
+	unsigned int i;
+
+	if (top == 0)
+		return -1;
+	if (isp_gain == 0)
+		return 0;
+	i = sensor_gain_upper(lut, size, top, gain_off, isp_gain);
+	if (i < top)
+		return (int)i - 1;
+	if (sensor_gain_at(lut, size, gain_off, top - 1) != max_gain)
+		return -1;
+	/* the first of equal entries, as the walk would have stopped there */
+	for (i = top - 1; i > 0 && sensor_gain_at(lut, size, gain_off, i - 1) == max_gain; i--)
+		;
+	return i;
+}
+
+/* power up from probe, see struct sensor_powerup */
+
+static void sensor_powerup_work(struct work_struct *work)
+{
+	struct sensor_powerup *powerup = container_of(work, struct sensor_powerup, work);
+	ktime_t start = ktime_get();
+
+	powerup->ret = powerup->power_on(powerup->data);
+	powerup->us = ktime_us_delta(ktime_get(), start);
+	complete(&powerup->done);
+}
+
+/* false with async_powerup off, the driver then powers up in g_chip_ident as before */
+bool sensor_powerup_start(struct sensor_powerup *powerup, int (*power_on)(void *data),
+			  void *data)
+{
+	powerup->started = 0;
+	if (!async_powerup)
+		return false;
+	powerup->power_on = power_on;
+	powerup->data = data;
+	init_completion(&powerup->done);
+	INIT_WORK(&powerup->work, sensor_powerup_work);
+	powerup->started = 1;
+	schedule_work(&powerup->work);
+	return true;
+}
+
+/*
+ * Wait for the power up started from probe and return what power_on did.
+ * The result is handed out once; -ENODATA when there is none to take.
+ */
+int sensor_powerup_wait(struct sensor_powerup *powerup)
+{
+	if (!powerup->started)
+		return -ENODATA;
+	wait_for_completion(&powerup->done);
+	powerup->started = 0;
+	return powerup->ret;
+}
@@ -1,6 +1,8 @@
 #include <linux/proc_fs.h>
 #include <linux/slab.h>
+#include <linux/math64.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 /* Per-sensor proc context for multi-sensor support */
 struct sensor_proc_ctx {
@@ -19,6 +21,9 @@ static ssize_t sensor_actual_fps_read(struct file *file, char __user *buf, size_
 static ssize_t sensor_i2c_addr_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_width_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_height_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_stats_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_profile_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_profile_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos);
 
 // File operations for the proc entries
 static const struct file_operations name_fops = {
@@ -66,6 +71,17 @@ static const struct file_operations height_fops = {
 	.owner = THIS_MODULE,
 };
 
+static const struct file_operations i2c_stats_fops = {
+	.read = sensor_i2c_stats_read,
+	.owner = THIS_MODULE,
+};
+
+static const struct file_operations i2c_profile_fops = {
+	.read = sensor_i2c_profile_read,
+	.write = sensor_i2c_profile_write,
+	.owner = THIS_MODULE,
+};
+
 /* Track if legacy flat paths have been created (for backward compatibility) */
 static int legacy_paths_created = 0;
 
@@ -115,6 +131,14 @@ void sensor_common_init(struct sensor_info *info) {
 	snprintf(path, sizeof(path), "%s/width", ctx->dir_path);
 	proc_create_data(path, 0444, NULL, &width_fops, ctx);
 
+	if (info->burst) {
+		snprintf(path, sizeof(path), "%s/i2c_stats", ctx->dir_path);
+		proc_create_data(path, 0444, NULL, &i2c_stats_fops, ctx);
+		snprintf(path, sizeof(path), "%s/i2c_profile", ctx->dir_path);
+		proc_create_data(path, 0644, NULL, &i2c_profile_fops, ctx);
+		sensor_profile_clear(info->burst);
+	}
+
 	/* Create legacy flat paths for backward compatibility (first sensor only) */
 	if (!legacy_paths_created) {
 		legacy_paths_created = 1;
@@ -201,3 +225,68 @@ static ssize_t sensor_height_read(struct file *file, char __user *buf, size_t co
 	int len = snprintf(buffer, sizeof(buffer), "%d\n", ctx->info->height);
 	return simple_read_from_buffer(buf, count, ppos, buffer, len);
 }
+
+static ssize_t sensor_i2c_stats_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+	struct sensor_burst *burst = ctx->info->burst;
+	char buffer[256];
+	int len = snprintf(buffer, sizeof(buffer),
+			   "last table: %u regs in %u transfers, %u us\ntotal: %u regs in %u transfers\n"
+			   "shadow: %u regs issued, %u suppressed, %u reads cached\n",
+			   burst->last_regs, burst->last_transfers, burst->last_us,
+			   burst->total_regs, burst->total_transfers,
+			   burst->shadow_issued, burst->shadow_suppressed, burst->shadow_hits);
+	return simple_read_from_buffer(buf, count, ppos, buffer, len);
+}
+
+/* frames are counted by the expo updates, the isp core sends one per frame */
+static ssize_t sensor_i2c_profile_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+	struct sensor_burst *burst = ctx->info->burst;
+	struct sensor_op_stat *stat;
+	unsigned int writes = 0;
+	unsigned int frames = burst->ops[SENSOR_OP_EXPO].ops;
+	char *buffer;
+	ssize_t ret;
+	int len = 0;
+	int i, j;
+
+	buffer = kmalloc(2048, GFP_KERNEL);
+	if (!buffer)
+		return -ENOMEM;
+	len += scnprintf(buffer + len, 2048 - len, "%lld ms profiled\n",
+			 ktime_to_ms(ktime_sub(ktime_get(), burst->profile_since)));
+	len += scnprintf(buffer + len, 2048 - len, "%-6s %8s %8s %8s %10s %6s %7s %8s %8s\n",
+			 "op", "ops", "reads", "writes", "bytes", "errors", "retries", "avg us", "max us");
+	for (i = 0; i < SENSOR_OP_NUMS; i++) {
+		stat = &burst->ops[i];
+		writes += stat->writes;
+		len += scnprintf(buffer + len, 2048 - len, "%-6s %8u %8u %8u %10llu %6u %7u %8llu %8u\n",
+				 sensor_op_name(i), stat->ops, stat->reads, stat->writes, stat->bytes,
+				 stat->errors, stat->retries,
+				 stat->ops ? div_u64(stat->us, stat->ops) : 0, stat->max_us);
+	}
+	if (frames)
+		len += scnprintf(buffer + len, 2048 - len, "writes per frame: %u.%02u over %u frames\n",
+				 writes / frames, writes % frames * 100 / frames, frames);
+	len += scnprintf(buffer + len, 2048 - len, "\n%-6s %6s", "us", "<1");
+	for (j = 1; j < SENSOR_PROFILE_HIST; j++)
+		len += scnprintf(buffer + len, 2048 - len, " %6u", 1 << (j - 1));
+	for (i = 0; i < SENSOR_OP_NUMS; i++) {
+		len += scnprintf(buffer + len, 2048 - len, "\n%-6s", sensor_op_name(i));
+		for (j = 0; j < SENSOR_PROFILE_HIST; j++)
+			len += scnprintf(buffer + len, 2048 - len, " %6u", burst->ops[i].hist[j]);
+	}
+	len += scnprintf(buffer + len, 2048 - len, "\n");
+	ret = simple_read_from_buffer(buf, count, ppos, buffer, len);
+	kfree(buffer);
+	return ret;
+}
+
+/* any write starts the profile over */
+static ssize_t sensor_i2c_profile_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+
+	sensor_profile_clear(ctx->info->burst);
+	return count;
+}
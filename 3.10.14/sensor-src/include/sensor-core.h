@@ -0,0 +1,195 @@
+#ifndef SENSOR_CORE_H
+#define SENSOR_CORE_H
+
+#include <linux/i2c.h>
+#include <linux/types.h>
+#include <linux/kernel.h>
+#include <linux/stddef.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/ktime.h>
+
+/* Same layout as the regval_list of the sensor drivers */
+struct sensor_regval {
+	uint16_t reg_num;
+	unsigned char value;
+};
+
+#define SENSOR_BURST_BARRIERS 4
+#define SENSOR_SHADOW_NUMS 64
+
+/* what the i2c traffic of a sensor is accounted to, see sensor_profile_begin() */
+enum sensor_op {
+	SENSOR_OP_OTHER,
+	SENSOR_OP_INIT,			/* register tables */
+	SENSOR_OP_EXPO,
+	SENSOR_OP_FPS,
+	SENSOR_OP_FLIP,
+	SENSOR_OP_NUMS,
+};
+
+#define SENSOR_PROFILE_HIST 12		/* log2 buckets of us, the last one is open */
+
+struct sensor_op_stat {
+	unsigned int ops;		/* operations done, their times are in hist */
+	unsigned int reads;		/* transfers that read */
+	unsigned int writes;		/* write messages */
+	unsigned long long bytes;
+	unsigned int errors;
+	unsigned int retries;
+	unsigned long long us;
+	unsigned int max_us;
+	unsigned int hist[SENSOR_PROFILE_HIST];
+};
+
+struct sensor_shadow_reg {
+	uint16_t reg_num;
+	unsigned char value;
+	unsigned char valid;
+};
+
+/*
+ * How a driver's register tables are written. Runs of consecutive
+ * registers go out as one auto-increment message unless no_auto_inc is
+ * set; a barrier register (reset, stream on, page select) is always
+ * written on its own. hold_begin and hold_end are the writes that open
+ * and launch the sensor's group hold, if it has one.
+ *
+ * The shadow keeps the last value written to each register so that the
+ * per frame writes of an unchanged value can be dropped. Barriers are
+ * never dropped. Every table write forgets the shadow, and so does a
+ * barrier written with a new value, since a reset or a page switch
+ * changes what the registers hold.
+ */
+struct sensor_burst {
+	unsigned int reg_bytes;		/* width of the register address, 1 or 2 */
+	uint16_t reg_end;		/* SENSOR_REG_END of the driver */
+	uint16_t reg_delay;		/* SENSOR_REG_DELAY of the driver */
+	int no_auto_inc;
+	uint16_t barriers[SENSOR_BURST_BARRIERS];
+	unsigned int barrier_nums;
+	const struct sensor_regval *hold_begin;	/* ended by reg_end */
+	const struct sensor_regval *hold_end;
+	struct sensor_shadow_reg shadow[SENSOR_SHADOW_NUMS];
+
+	/* statistics */
+	unsigned int last_regs;		/* of the last table written */
+	unsigned int last_transfers;
+	unsigned int last_us;
+	unsigned int total_regs;
+	unsigned int total_transfers;
+	unsigned int shadow_issued;	/* regs written past the shadow */
+	unsigned int shadow_suppressed;
+	unsigned int shadow_hits;	/* reads served from the shadow */
+
+	/* profile, kept with i2c_profile=1 */
+	enum sensor_op op;
+	struct task_struct *op_owner;	/* the task op is accounted for */
+	unsigned int op_depth;
+	ktime_t op_start;
+	ktime_t profile_since;
+	struct sensor_op_stat ops[SENSOR_OP_NUMS];
+};
+
+int sensor_burst_write_array(struct i2c_client *client, struct sensor_burst *burst,
+			     const struct sensor_regval *vals);
+
+/*
+ * The transfers between begin and end are accounted to op, and the time
+ * it took goes into its histogram. Nested calls count for the outermost
+ * one; table writes are INIT and group writes EXPO on their own. The op
+ * is the calling task's, other tasks' transfers meanwhile count as other.
+ */
+void sensor_profile_begin(struct sensor_burst *burst, enum sensor_op op);
+void sensor_profile_end(struct sensor_burst *burst);
+void sensor_profile_clear(struct sensor_burst *burst);
+const char *sensor_op_name(enum sensor_op op);
+
+/*
+ * Packed register tables, as made by tools/pack_regvals.sh from the
+ * regval_list arrays of a driver. A table is a byte stream of opcodes:
+ *
+ *   0x00-0x3f  run of op + 1 values written from the current address on
+ *   0x40-0x7f  move the current address forward by (op & 0x3f) + 1
+ *   0x80       set the current address, reg_bytes bytes, big endian
+ *   0x81       delay, one byte of ms
+ *   0xff       end of table
+ */
+#define SENSOR_PACKED_RUN	0x00
+#define SENSOR_PACKED_SKIP	0x40
+#define SENSOR_PACKED_ADDR	0x80
+#define SENSOR_PACKED_DELAY	0x81
+#define SENSOR_PACKED_END	0xff
+#define SENSOR_PACKED_LEN_MASK	0x3f
+
+int sensor_burst_write_packed(struct i2c_client *client, struct sensor_burst *burst,
+			      const unsigned char *p);
+int sensor_shadow_write(struct i2c_client *client, struct sensor_burst *burst,
+			uint16_t reg, unsigned char value);
+int sensor_shadow_write_through(struct i2c_client *client, struct sensor_burst *burst,
+				uint16_t reg, unsigned char value);
+int sensor_shadow_read(struct i2c_client *client, struct sensor_burst *burst,
+		       uint16_t reg, unsigned char *value);
+int sensor_core_read(struct i2c_client *client, struct sensor_burst *burst,
+		     uint16_t reg, unsigned char *value);
+int sensor_group_write_array(struct i2c_client *client, struct sensor_burst *burst,
+			     const struct sensor_regval *vals);
+
+/*
+ * Warm handoff from a boot stage that already set the sensor up. The
+ * sensor is adopted as it runs when the id registers read back as the
+ * chip id and every signature register holds what the mode table leaves
+ * in it; otherwise the table has to be written as usual.
+ */
+struct sensor_handoff {
+	const struct sensor_regval *id;	/* chip id, ended by reg_end */
+	const uint16_t *sig;		/* registers that identify the mode */
+	unsigned int sig_nums;
+
+	/* result of the last check */
+	int adopted;
+	unsigned int skipped_regs;	/* table writes not done */
+	unsigned int skipped_ms;	/* table delays not waited */
+	unsigned int check_us;
+	unsigned int saved_us;		/* estimate, from the cost of the reads */
+};
+
+int sensor_handoff_check(struct i2c_client *client, struct sensor_burst *burst,
+			 struct sensor_handoff *handoff, const struct sensor_regval *mode);
+
+/*
+ * Power up and detection started from probe on a work item, so that the
+ * reset and clock delays of the sensors overlap each other and the rest
+ * of the boot instead of adding up in g_chip_ident. The driver's power_on
+ * runs once; g_chip_ident takes its result with sensor_powerup_wait().
+ */
+struct sensor_powerup {
+	struct work_struct work;
+	struct completion done;
+	int (*power_on)(void *data);
+	void *data;
+	int started;
+	int ret;
+	unsigned int us;		/* time power_on took */
+};
+
+bool sensor_powerup_start(struct sensor_powerup *powerup, int (*power_on)(void *data),
+			  void *data);
+int sensor_powerup_wait(struct sensor_powerup *powerup);
+
+/*
+ * Index of the entry of a gain LUT that sensor_alloc_again() picks for
+ * isp_gain: the largest gain not above it, or the first entry at
+ * max_gain once isp_gain reaches it. -1 when the old linear walk would
+ * have found nothing. The gains must be ascending.
+ */
+int sensor_gain_lut_find(const void *lut, size_t size, unsigned int nums, size_t gain_off,
+			 unsigned int isp_gain, unsigned int max_gain);
+
+#define SENSOR_GAIN_LUT_FIND(lut, isp_gain, max_gain)					\
+	sensor_gain_lut_find(lut, sizeof((lut)[0]), ARRAY_SIZE(lut),			\
+			     offsetof(typeof((lut)[0]), gain)					\
+			     + BUILD_BUG_ON_ZERO(sizeof((lut)[0].gain) != sizeof(unsigned int)),	\
+			     isp_gain, max_gain)
+
+#endif // SENSOR_CORE_H
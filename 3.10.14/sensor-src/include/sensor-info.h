@@ -1,6 +1,8 @@
 #ifndef SENSOR_INFO_H
 #define SENSOR_INFO_H
 
+struct sensor_burst;
+
 struct sensor_info {
 	const char *name;
 	unsigned int chip_id;
@@ -11,6 +13,7 @@ struct sensor_info {
 	unsigned int chip_i2c_addr;
 	int width;
 	int height;
+	struct sensor_burst *burst;  /* register table writes, may be NULL */
 	void *priv;  /* Private data for proc context */
 };
 
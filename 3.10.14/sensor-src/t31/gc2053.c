@@ -15,6 +15,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -84,6 +85,14 @@ static int shvflip = 0;
 module_param(shvflip, int, S_IRUGO);
 MODULE_PARM_DESC(shvflip, "Sensor HV Flip Enable interface");
 
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 1,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+	.barriers = { 0xfe },	/* page select */
+	.barrier_nums = 1,
+};
+
 static struct sensor_info sensor_info = {
 	.name = SENSOR_NAME,
 	.chip_id = SENSOR_CHIP_ID,
@@ -94,6 +103,7 @@ static struct sensor_info sensor_info = {
 	.chip_i2c_addr = SENSOR_I2C_ADDRESS,
 	.width = SENSOR_MAX_WIDTH,
 	.height = SENSOR_MAX_HEIGHT,
+	.burst = &sensor_burst,
 };
 
 struct regval_list {
@@ -147,22 +157,12 @@ struct tx_isp_sensor_attribute sensor_attr;
 
 unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
 	struct again_lut *lut = sensor_again_lut;
-	while (lut->gain <= sensor_attr.max_again) {
-		if (isp_gain == 0) {
-			*sensor_again = lut[0].index;
-			return lut[0].gain;
-		} else if (isp_gain < lut->gain) {
-			*sensor_again = (lut - 1)->index;
-			return (lut - 1)->gain;
-		} else {
-			if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
-				*sensor_again = lut->index;
-				return lut->gain;
-			}
-		}
-		lut++;
-	}
-	return isp_gain;
+	int i = SENSOR_GAIN_LUT_FIND(sensor_again_lut, isp_gain, sensor_attr.max_again);
+
+	if (i < 0)
+		return isp_gain;
+	*sensor_again = lut[i].index;
+	return lut[i].gain;
 }
 
 unsigned int sensor_alloc_dgain(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_dgain) {
@@ -1270,20 +1270,12 @@ int sensor_read(struct tx_isp_subdev *sd, unsigned char reg, unsigned char *valu
 }
 
 int sensor_write(struct tx_isp_subdev *sd, unsigned char reg, unsigned char value) {
-	struct i2c_client *client = tx_isp_get_subdevdata(sd);
-	unsigned char buf[2] = {reg, value};
-	struct i2c_msg msg = {
-		.addr = client->addr,
-		.flags = 0,
-		.len = 2,
-		.buf = buf,
-	};
-	int ret;
-	ret = private_i2c_transfer(client->adapter, &msg, 1);
-	if (ret > 0)
-		ret = 0;
+	return sensor_shadow_write(tx_isp_get_subdevdata(sd), &sensor_burst, reg, value);
+}
 
-	return ret;
+/* for registers only the init tables change */
+static int sensor_read_cached(struct tx_isp_subdev *sd, unsigned char reg, unsigned char *value) {
+	return sensor_shadow_read(tx_isp_get_subdevdata(sd), &sensor_burst, reg, value);
 }
 
 #if 0
@@ -1305,18 +1297,14 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 #endif
 
 static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals) {
-	int ret;
-	while (vals->reg_num != SENSOR_REG_END) {
-		if (vals->reg_num == SENSOR_REG_DELAY) {
-			private_msleep(vals->value);
-		} else {
-			ret = sensor_write(sd, vals->reg_num, vals->value);
-			if (ret < 0)
-				return ret;
-		}
-		vals++;
-	}
-	return 0;
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
+}
+
+static int sensor_write_group(struct tx_isp_subdev *sd, struct regval_list *vals) {
+	return sensor_group_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, int val) {
@@ -1351,29 +1339,35 @@ static int sensor_set_expo(struct tx_isp_subdev *sd, int value) {
 	int it = (value & 0xffff);
 	int again = (value & 0xffff0000) >> 16;
 	struct again_lut *val_lut = sensor_again_lut;
+	struct regval_list vals[12];
+	int n = 0;
 
 	/* sensor reg page */
-	ret = sensor_write(sd, 0xfe, 0x00);
+	vals[n++] = (struct regval_list){0xfe, 0x00};
 
 	/* vts */
 	if (vtsn0 != vts0) {
 		vts0 = vtsn0;
-		ret += sensor_write(sd, 0x41, vtsn0);
+		vals[n++] = (struct regval_list){0x41, vtsn0};
 	}
 	if (vtsn1 != vts1) {
 		vts1 = vtsn1;
-		ret += sensor_write(sd, 0x42, vtsn1);
+		vals[n++] = (struct regval_list){0x42, vtsn1};
 	}
 
 	/* integration time */
-	ret += sensor_write(sd, 0x04, it & 0xff);
-	ret += sensor_write(sd, 0x03, (it & 0x3f00) >> 8);
+	vals[n++] = (struct regval_list){0x04, it & 0xff};
+	vals[n++] = (struct regval_list){0x03, (it & 0x3f00) >> 8};
 
 	/* analog gain */
-	ret += sensor_write(sd, 0xb4, val_lut[again].regb4);
-	ret += sensor_write(sd, 0xb3, val_lut[again].regb3);
-	ret += sensor_write(sd, 0xb8, val_lut[again].dpc);
-	ret += sensor_write(sd, 0xb9, val_lut[again].blc);
+	vals[n++] = (struct regval_list){0xb4, val_lut[again].regb4};
+	vals[n++] = (struct regval_list){0xb3, val_lut[again].regb3};
+	vals[n++] = (struct regval_list){0xb8, val_lut[again].dpc};
+	vals[n++] = (struct regval_list){0xb9, val_lut[again].blc};
+	vals[n++] = (struct regval_list){SENSOR_REG_END, 0x00};
+
+	/* the gc2053 has no group hold, one transaction is the best we can do */
+	ret = sensor_write_group(sd, vals);
 	if (ret < 0) {
 		ISP_ERROR("sensor_write error  %d\n", __LINE__);
 		return ret;
@@ -1503,9 +1497,9 @@ static int sensor_set_fps(struct tx_isp_subdev *sd, int fps) {
 	}
 
 	ret = sensor_write(sd, 0xfe, 0x0);
-	ret += sensor_read(sd, 0x05, &val);
+	ret += sensor_read_cached(sd, 0x05, &val);
 	hts = val;
-	ret += sensor_read(sd, 0x06, &val);
+	ret += sensor_read_cached(sd, 0x06, &val);
 	if (ret < 0)
 		return -1;
 
@@ -1705,8 +1699,9 @@ static int sensor_s_register(struct tx_isp_subdev *sd, const struct tx_isp_dbg_r
 	if (!private_capable(CAP_SYS_ADMIN))
 		return -EPERM;
 
-	sensor_write(sd, reg->reg & 0xffff, reg->val & 0xff);
-	return 0;
+	/* past the shadow, a debug write must reach the sensor */
+	return sensor_shadow_write_through(tx_isp_get_subdevdata(sd), &sensor_burst,
+					   reg->reg & 0xff, reg->val & 0xff);
 }
 
 static struct tx_isp_subdev_core_ops sensor_core_ops = {
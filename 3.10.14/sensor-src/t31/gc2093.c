@@ -20,6 +20,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -189,42 +190,27 @@ unsigned int sensor_alloc_integration_time_short(unsigned int it, unsigned char
 
 unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
 	struct again_lut *lut = sensor_again_lut;
-	while (lut->gain <= sensor_attr.max_again) {
-		if (isp_gain == 0) {
-			*sensor_again = 0;
-			return lut[0].gain;
-		} else if (isp_gain < lut->gain) {
-			*sensor_again = (lut - 1)->index;
-			return (lut - 1)->gain;
-		} else {
-			if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
-				*sensor_again = lut->index;
-				return lut->gain;
-			}
-		}
-		lut++;
-	}
-	return 0;
+	int i = SENSOR_GAIN_LUT_FIND(sensor_again_lut, isp_gain, sensor_attr.max_again);
+
+	if (i < 0)
+		return 0;
+	*sensor_again = lut[i].index;
+	return lut[i].gain;
 }
 
 unsigned int sensor_alloc_again_short(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
 	struct again_lut *lut = sensor_again_lut;
-	while (lut->gain <= sensor_attr.max_again_short) {
-		if (isp_gain == 0) {
-			*sensor_again = 0;
-			return 0;
-		} else if (isp_gain < lut->gain) {
-			*sensor_again = (lut - 1)->gain;
-			return (lut - 1)->gain;
-		} else {
-			if ((lut->gain == sensor_attr.max_again_short) && (isp_gain >= lut->gain)) {
-				*sensor_again = lut->index;
-				return lut->gain;
-			}
-		}
-		lut++;
+	int i = SENSOR_GAIN_LUT_FIND(sensor_again_lut, isp_gain, sensor_attr.max_again_short);
+
+	if (i < 0)
+		return isp_gain;
+	if (isp_gain == 0) {
+		*sensor_again = 0;
+		return 0;
 	}
-	return isp_gain;
+	/* below the top the short frame has always been handed the gain, not the index */
+	*sensor_again = isp_gain < sensor_attr.max_again_short ? lut[i].gain : lut[i].index;
+	return lut[i].gain;
 }
 
 unsigned int sensor_alloc_dgain(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_dgain) {
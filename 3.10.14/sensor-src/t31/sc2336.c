@@ -15,6 +15,8 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
+#include <sc2336-packed.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -66,6 +68,26 @@ static int shvflip = 0;
 module_param(shvflip, int, S_IRUGO);
 MODULE_PARM_DESC(shvflip, "Sensor HV Flip Enable interface");
 
+static struct regval_list sensor_group_hold_begin[] = {
+    {0x3812, 0x00},
+    {SENSOR_REG_END, 0x00},
+};
+
+static struct regval_list sensor_group_hold_end[] = {
+    {0x3812, 0x30},
+    {SENSOR_REG_END, 0x00},
+};
+
+static struct sensor_burst sensor_burst = {
+    .reg_bytes = 2,
+    .reg_end = SENSOR_REG_END,
+    .reg_delay = SENSOR_REG_DELAY,
+    .barriers = { 0x0103, 0x0100 },	/* reset, stream on */
+    .barrier_nums = 2,
+    .hold_begin = (struct sensor_regval *)sensor_group_hold_begin,
+    .hold_end = (struct sensor_regval *)sensor_group_hold_end,
+};
+
 static struct sensor_info sensor_info = {
     .name = SENSOR_NAME,
     .chip_id = SENSOR_CHIP_ID,
@@ -76,6 +98,7 @@ static struct sensor_info sensor_info = {
     .chip_i2c_addr = SENSOR_I2C_ADDRESS,
     .width = SENSOR_MAX_WIDTH,
     .height = SENSOR_MAX_HEIGHT,
+    .burst = &sensor_burst,
 };
 
 struct regval_list {
@@ -258,23 +281,13 @@ struct tx_isp_sensor_attribute sensor_attr;
 unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again)
 {
     struct again_lut *lut = sensor_again_lut;
-    while (lut->gain <= sensor_attr.max_again) {
-        if (isp_gain == 0) {
-            *sensor_again = lut[0].value;
-            return 0;
-        } else if (isp_gain < lut->gain) {
-            *sensor_again = (lut - 1)->value;
-            return (lut - 1)->gain;
-        } else {
-            if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
-                *sensor_again = lut->value;
-                return lut->gain;
-            }
-        }
+    int i = SENSOR_GAIN_LUT_FIND(sensor_again_lut, isp_gain, sensor_attr.max_again);
 
-        lut++;
+    if (i < 0) {
+        return isp_gain;
     }
-    return isp_gain;
+    *sensor_again = lut[i].value;
+    return lut[i].gain;
 }
 
 unsigned int sensor_alloc_dgain(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_dgain)
@@ -335,7 +348,8 @@ struct tx_isp_sensor_attribute sensor_attr = {
     .sensor_ctrl.alloc_dgain = sensor_alloc_dgain,
 };
 
-static struct regval_list sensor_init_regs_1920_1080_30fps_mipi[] = {
+/* only the source of the packed table, see sc2336-packed.h */
+static struct regval_list sensor_init_regs_1920_1080_30fps_mipi[] __maybe_unused = {
     /*
      * cleaned 0x02 24Mmclk 2lane 405Mbps 10bit 1080p@30fps
      */
@@ -499,10 +513,16 @@ static struct tx_isp_sensor_win_setting sensor_win_sizes[] = {
         .fps = 25 << 16 | 1,
         .mbus_code = V4L2_MBUS_FMT_SBGGR10_1X10,
         .colorspace = V4L2_COLORSPACE_SRGB,
-        .regs = sensor_init_regs_1920_1080_30fps_mipi,
+        /* no regval_list is linked for this mode, see sensor_win_packed */
+        .regs = NULL,
     },
 };
 
+/* the packed init table of each entry of sensor_win_sizes */
+static const unsigned char *const sensor_win_packed[] = {
+    sensor_init_regs_1920_1080_30fps_mipi_packed,
+};
+
 struct tx_isp_sensor_win_setting *wsize = &sensor_win_sizes[0];
 
 static struct regval_list sensor_stream_on_mipi[] = {
@@ -517,48 +537,18 @@ static struct regval_list sensor_stream_off_mipi[] = {
 
 int sensor_read(struct tx_isp_subdev *sd, uint16_t reg, unsigned char *value)
 {
-    struct i2c_client *client = tx_isp_get_subdevdata(sd);
-    unsigned char buf[2] = {reg >> 8, reg & 0xff};
-    struct i2c_msg msg[2] = {
-        [0] = {
-            .addr = client->addr,
-            .flags = 0,
-            .len = 2,
-            .buf = buf,
-        },
-        [1] = {
-            .addr = client->addr,
-            .flags = I2C_M_RD,
-            .len = 1,
-            .buf = value,
-        }
-    };
-    int ret;
-    ret = private_i2c_transfer(client->adapter, msg, 2);
-    if (ret > 0) {
-        ret = 0;
-    }
-
-    return ret;
+    return sensor_core_read(tx_isp_get_subdevdata(sd), &sensor_burst, reg, value);
 }
 
 int sensor_write(struct tx_isp_subdev *sd, uint16_t reg, unsigned char value)
 {
-    struct i2c_client *client = tx_isp_get_subdevdata(sd);
-    uint8_t buf[3] = {(reg >> 8) & 0xff, reg & 0xff, value};
-    struct i2c_msg msg = {
-        .addr = client->addr,
-        .flags = 0,
-        .len = 3,
-        .buf = buf,
-    };
-    int ret;
-    ret = private_i2c_transfer(client->adapter, &msg, 1);
-    if (ret > 0) {
-        ret = 0;
-    }
+    return sensor_shadow_write(tx_isp_get_subdevdata(sd), &sensor_burst, reg, value);
+}
 
-    return ret;
+/* for registers only the init tables change */
+static int sensor_read_cached(struct tx_isp_subdev *sd, uint16_t reg, unsigned char *value)
+{
+    return sensor_shadow_read(tx_isp_get_subdevdata(sd), &sensor_burst, reg, value);
 }
 
 static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
@@ -582,20 +572,20 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 
 static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 {
-    int ret;
-    while (vals->reg_num != SENSOR_REG_END) {
-        if (vals->reg_num == SENSOR_REG_DELAY) {
-            private_msleep(vals->value);
-        } else {
-            ret = sensor_write(sd, vals->reg_num, vals->value);
-            if (ret < 0) {
-                return ret;
-            }
-        }
-        vals++;
-    }
+    BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+    return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+                                    (struct sensor_regval *)vals);
+}
 
-    return 0;
+static int sensor_write_group(struct tx_isp_subdev *sd, struct regval_list *vals)
+{
+    return sensor_group_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+                                    (struct sensor_regval *)vals);
+}
+
+static int sensor_write_packed(struct tx_isp_subdev *sd, const unsigned char *packed)
+{
+    return sensor_burst_write_packed(tx_isp_get_subdevdata(sd), &sensor_burst, packed);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, int val)
@@ -640,16 +630,19 @@ static int sensor_set_expo(struct tx_isp_subdev *sd, int value)
     int ret = 0;
     int it = (value & 0xffff);
     int again = (value & 0xffff0000) >> 16;
+    struct regval_list vals[] = {
+        //integration time
+        {0x3e00, (unsigned char) ((it >> 12) & 0xf)},
+        {0x3e01, (unsigned char) ((it >> 4) & 0xff)},
+        {0x3e02, (unsigned char) ((it & 0x0f) << 4)},
+        //sensor dig fine gain
+        {0x3e07, (unsigned char) (again & 0xff)},
+        //sensor analog gain
+        {0x3e09, (unsigned char) (((again >> 8) & 0xff))},
+        {SENSOR_REG_END, 0x00},
+    };
 
-    //integration time
-    ret += sensor_write(sd, 0x3e00, (unsigned char) ((it >> 12) & 0xf));
-    ret += sensor_write(sd, 0x3e01, (unsigned char) ((it >> 4) & 0xff));
-    ret += sensor_write(sd, 0x3e02, (unsigned char) ((it & 0x0f) << 4));
-
-    //sensor analog gain
-    ret += sensor_write(sd, 0x3e09, (unsigned char) (((again >> 8) & 0xff)));
-    //sensor dig fine gain
-    ret += sensor_write(sd, 0x3e07, (unsigned char) (again & 0xff));
+    ret = sensor_write_group(sd, vals);
     if (ret < 0) {
         return ret;
     }
@@ -722,7 +715,8 @@ static int sensor_init(struct tx_isp_subdev *sd, int enable)
 
     sensor_update_actual_fps((wsize->fps >> 16) & 0xffff);
 
-    ret = sensor_write_array(sd, wsize->regs);
+    BUILD_BUG_ON(ARRAY_SIZE(sensor_win_packed) != ARRAY_SIZE(sensor_win_sizes));
+    ret = sensor_write_packed(sd, sensor_win_packed[wsize - sensor_win_sizes]);
     if (ret) {
         return ret;
     }
@@ -773,9 +767,9 @@ static int sensor_set_fps(struct tx_isp_subdev *sd, int fps)
     }
 
     clk = SENSOR_SUPPORT_30FPS_SCLK;
-    ret = sensor_read(sd, 0x320c, &val);
+    ret = sensor_read_cached(sd, 0x320c, &val);
     hts = val;
-    ret += sensor_read(sd, 0x320d, &val);
+    ret += sensor_read_cached(sd, 0x320d, &val);
     if (0 != ret) {
         ISP_ERROR("err: %s read err\n", SENSOR_NAME);
         return ret;
@@ -950,12 +944,16 @@ static int sensor_sensor_ops_ioctl(struct tx_isp_subdev *sd, unsigned int cmd, v
             break;
         case TX_ISP_EVENT_SENSOR_FPS:
             if (arg) {
+                sensor_profile_begin(&sensor_burst, SENSOR_OP_FPS);
                 ret = sensor_set_fps(sd, *(int *) arg);
+                sensor_profile_end(&sensor_burst);
             }
             break;
         case TX_ISP_EVENT_SENSOR_VFLIP:
             if (arg) {
+                sensor_profile_begin(&sensor_burst, SENSOR_OP_FLIP);
                 ret = sensor_set_vflip(sd, *(int *) arg);
+                sensor_profile_end(&sensor_burst);
             }
             break;
         case TX_ISP_EVENT_SENSOR_LOGIC:
@@ -1004,9 +1002,9 @@ static int sensor_s_register(struct tx_isp_subdev *sd, const struct tx_isp_dbg_r
         return -EPERM;
     }
 
-    sensor_write(sd, reg->reg & 0xffff, reg->val & 0xff);
-
-    return 0;
+    /* past the shadow, a debug write must reach the sensor */
+    return sensor_shadow_write_through(tx_isp_get_subdevdata(sd), &sensor_burst,
+                                       reg->reg & 0xffff, reg->val & 0xff);
 }
 
 static struct tx_isp_subdev_core_ops sensor_core_ops = {
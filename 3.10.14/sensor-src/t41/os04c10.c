@@ -21,6 +21,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -1289,21 +1290,36 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 }
 #endif
 
-static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals) {
-	int ret;
+static struct regval_list sensor_group_hold_begin[] = {
+	{0x3208, 0x00},
+	{SENSOR_REG_END, 0x00},
+};
 
-	while (vals->reg_num != SENSOR_REG_END) {
-		if (vals->reg_num == SENSOR_REG_DELAY) {
-			msleep(vals->value);
-		} else {
-			ret = sensor_write(sd, vals->reg_num, vals->value);
-			if (ret < 0)
-				return ret;
-		}
-		vals++;
-	}
+static struct regval_list sensor_group_hold_end[] = {
+	{0x3208, 0x10},
+	{0x3208, 0xa0},
+	{SENSOR_REG_END, 0x00},
+};
 
-	return 0;
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 2,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+	.barriers = { 0x0103, 0x0100 },	/* reset, stream on */
+	.barrier_nums = 2,
+	.hold_begin = (struct sensor_regval *)sensor_group_hold_begin,
+	.hold_end = (struct sensor_regval *)sensor_group_hold_end,
+};
+
+static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals) {
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
+}
+
+static int sensor_write_group(struct tx_isp_subdev *sd, struct regval_list *vals) {
+	return sensor_group_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, struct tx_isp_initarg *init) {
@@ -1339,6 +1355,7 @@ static int sensor_set_expo(struct tx_isp_subdev *sd, int value) {
 	int ret = 0;
 	int expo = value & 0xffff;
 	int again = (value & 0xffff0000) >> 16;
+	struct regval_list vals[5];
 
 	if (info->default_boot == 1) {
 		if (expo > 1405) expo = 1405;
@@ -1346,12 +1363,13 @@ static int sensor_set_expo(struct tx_isp_subdev *sd, int value) {
 		if (expo > 2247) expo = 2247;
 	}
 
-	ret += sensor_write(sd, 0x3502, (unsigned char) (expo & 0xff));
-	ret += sensor_write(sd, 0x3501, (unsigned char) ((expo >> 8) & 0xff));
-
-	ret += sensor_write(sd, 0x3509, (unsigned char) ((again & 0xff)));
-	ret += sensor_write(sd, 0x3508, (unsigned char) ((again >> 8) & 0xff));
+	vals[0] = (struct regval_list){0x3501, (unsigned char) ((expo >> 8) & 0xff)};
+	vals[1] = (struct regval_list){0x3502, (unsigned char) (expo & 0xff)};
+	vals[2] = (struct regval_list){0x3508, (unsigned char) ((again >> 8) & 0xff)};
+	vals[3] = (struct regval_list){0x3509, (unsigned char) ((again & 0xff))};
+	vals[4] = (struct regval_list){SENSOR_REG_END, 0x00};
 
+	ret = sensor_write_group(sd, vals);
 	if (ret < 0) {
 		ISP_ERROR("sensor_write error  %d\n", __LINE__);
 		return ret;
@@ -21,6 +21,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -2678,22 +2679,19 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 }
 #endif
 
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 2,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+	.barriers = { 0x0103, 0x0100 },	/* reset, stream on */
+	.barrier_nums = 2,
+};
+
 static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 {
-	int ret;
-
-	while (vals->reg_num != SENSOR_REG_END) {
-		if (vals->reg_num == SENSOR_REG_DELAY) {
-			msleep(vals->value);
-		} else {
-			ret = sensor_write(sd, vals->reg_num, vals->value);
-			if (ret < 0)
-				return ret;
-		}
-		vals++;
-	}
-
-	return 0;
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
@@ -19,6 +19,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 // ============================================================================
 // SENSOR IDENTIFICATION
@@ -46,7 +47,11 @@
 #define SENSOR_OUTPUT_MAX_FPS 25
 #define SENSOR_OUTPUT_MIN_FPS 5
 
-static int reset_gpio = GPIO_PA(17);
+/*
+ * The board info passed at registration sets both gpios. Given at load
+ * time they also let the power up start from probe, see sensor_probe().
+ */
+static int reset_gpio = -1;
 module_param(reset_gpio, int, S_IRUGO);
 MODULE_PARM_DESC(reset_gpio, "Reset GPIO NUM");
 
@@ -562,20 +567,35 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 }
 #endif
 
+static struct regval_list sensor_group_hold_begin[] = {
+	{0x3812, 0x00},
+	{SENSOR_REG_END, 0x00},
+};
+
+static struct regval_list sensor_group_hold_end[] = {
+	{0x3812, 0x30},
+	{SENSOR_REG_END, 0x00},
+};
+
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 2,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+	.barriers = { 0x0103, 0x0100 },	/* reset, stream on */
+	.barrier_nums = 2,
+	.hold_begin = (struct sensor_regval *)sensor_group_hold_begin,
+	.hold_end = (struct sensor_regval *)sensor_group_hold_end,
+};
+
 static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals) {
-	int ret;
-	while (vals->reg_num != SENSOR_REG_END) {
-		if (vals->reg_num == SENSOR_REG_DELAY) {
-			msleep(vals->value);
-		} else {
-			ret = sensor_write(sd, vals->reg_num, vals->value);
-			if (ret < 0)
-				return ret;
-		}
-		vals++;
-	}
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
+}
 
-	return 0;
+static int sensor_write_group(struct tx_isp_subdev *sd, struct regval_list *vals) {
+	return sensor_group_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, struct tx_isp_initarg *init) {
@@ -606,15 +626,21 @@ static int sensor_detect(struct tx_isp_subdev *sd, unsigned int *ident) {
 }
 
 static int sensor_set_expo(struct tx_isp_subdev *sd, int value) {
-	int ret = -1;
+	int ret = 0;
 	int it = (value & 0xffff) * 2;
 	int again = (value & 0xffff0000) >> 16;
+	struct regval_list vals[] = {
+		{0x3e00, (unsigned char) ((it >> 12) & 0xf)},
+		{0x3e01, (unsigned char) ((it >> 4) & 0xff)},
+		{0x3e02, (unsigned char) ((it & 0x0f) << 4)},
+		{0x3e07, (unsigned char) (again & 0xff)},
+		{0x3e09, (unsigned char) (((again >> 8) & 0xff))},
+		{SENSOR_REG_END, 0x00},
+	};
 
-	ret += sensor_write(sd, 0x3e00, (unsigned char) ((it >> 12) & 0xf));
-	ret += sensor_write(sd, 0x3e01, (unsigned char) ((it >> 4) & 0xff));
-	ret += sensor_write(sd, 0x3e02, (unsigned char) ((it & 0x0f) << 4));
-	ret = sensor_write(sd, 0x3e07, (unsigned char) (again & 0xff));
-	ret += sensor_write(sd, 0x3e09, (unsigned char) (((again >> 8) & 0xff)));
+	ret = sensor_write_group(sd, vals);
+	if (ret < 0)
+		return ret;
 
 	//expo_val = value;
 
@@ -794,12 +820,29 @@ static int sensor_set_vflip(struct tx_isp_subdev *sd, int enable) {
 	return ret;
 }
 
-static int sensor_attr_check(struct tx_isp_subdev *sd) {
+static struct sensor_powerup sensor_powerup;
+static unsigned int sensor_ident;
+static int reset_requested = -1;
+static int pwdn_requested = -1;
+
+/* the clock may already run, started by the power up from probe */
+static void sensor_mclk_enable(struct tx_isp_subdev *sd) {
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
-	struct tx_isp_sensor_register_info *info = &sensor->info;
 	struct i2c_client *client = tx_isp_get_subdevdata(sd);
 	struct clk *sclka;
-	unsigned long rate;
+
+	if (sensor->mclk)
+		return;
+	sclka = private_devm_clk_get(&client->dev, SEN_MCLK);
+	sensor->mclk = private_devm_clk_get(sensor->dev, SEN_BCLK);
+	set_sensor_mclk_function(0);
+	private_clk_set_rate(sensor->mclk, 24000000);
+	private_clk_prepare_enable(sensor->mclk);
+}
+
+static int sensor_attr_check(struct tx_isp_subdev *sd) {
+	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
+	struct tx_isp_sensor_register_info *info = &sensor->info;
 
 	switch (info->default_boot) {
 		case 0:
@@ -831,17 +874,12 @@ static int sensor_attr_check(struct tx_isp_subdev *sd) {
 		case TISP_SENSOR_MCLK0:
 		case TISP_SENSOR_MCLK1:
 		case TISP_SENSOR_MCLK2:
-			sclka = private_devm_clk_get(&client->dev, SEN_MCLK);
-			sensor->mclk = private_devm_clk_get(sensor->dev, SEN_BCLK);
-			set_sensor_mclk_function(0);
+			sensor_mclk_enable(sd);
 			break;
 		default:
 			ISP_ERROR("Have no this MCLK Source!!!\n");
 	}
 
-	rate = private_clk_get_rate(sensor->mclk);
-	private_clk_set_rate(sensor->mclk, 24000000);
-	private_clk_prepare_enable(sensor->mclk);
 	reset_gpio = info->rst_gpio;
 	pwdn_gpio = info->pwdn_gpio;
 
@@ -855,16 +893,16 @@ static int sensor_attr_check(struct tx_isp_subdev *sd) {
 
 }
 
-static int sensor_g_chip_ident(struct tx_isp_subdev *sd,
-			       struct tx_isp_chip_ident *chip) {
-	struct i2c_client *client = tx_isp_get_subdevdata(sd);
-	unsigned int ident = 0;
+/* mclk, the reset and pwdn sequence and detection, from probe or g_chip_ident */
+static int sensor_power_on(void *data) {
+	struct tx_isp_subdev *sd = data;
 	int ret = ISP_SUCCESS;
 
-	sensor_attr_check(sd);
+	sensor_mclk_enable(sd);
 	if (reset_gpio != -1) {
 		ret = private_gpio_request(reset_gpio, "sensor_reset");
 		if (!ret) {
+			reset_requested = reset_gpio;
 			private_gpio_direction_output(reset_gpio, 1);
 			private_msleep(10);
 			private_gpio_direction_output(reset_gpio, 0);
@@ -878,6 +916,7 @@ static int sensor_g_chip_ident(struct tx_isp_subdev *sd,
 	if (pwdn_gpio != -1) {
 		ret = private_gpio_request(pwdn_gpio, "sensor_pwdn");
 		if (!ret) {
+			pwdn_requested = pwdn_gpio;
 			private_gpio_direction_output(pwdn_gpio, 0);
 			private_msleep(10);
 			private_gpio_direction_output(pwdn_gpio, 1);
@@ -886,7 +925,40 @@ static int sensor_g_chip_ident(struct tx_isp_subdev *sd,
 			ISP_ERROR("gpio request fail %d\n", pwdn_gpio);
 		}
 	}
-	ret = sensor_detect(sd, &ident);
+	return sensor_detect(sd, &sensor_ident);
+}
+
+static void sensor_gpio_free(void) {
+	if (reset_requested != -1)
+		private_gpio_free(reset_requested);
+	if (pwdn_requested != -1)
+		private_gpio_free(pwdn_requested);
+	reset_requested = -1;
+	pwdn_requested = -1;
+}
+
+static int sensor_g_chip_ident(struct tx_isp_subdev *sd,
+			       struct tx_isp_chip_ident *chip) {
+	struct i2c_client *client = tx_isp_get_subdevdata(sd);
+	int early_reset = reset_gpio;
+	int early_pwdn = pwdn_gpio;
+	unsigned int ident = 0;
+	int ret = ISP_SUCCESS;
+
+	ret = sensor_powerup_wait(&sensor_powerup);
+	sensor_attr_check(sd);
+	/* the early power up used the module parameters, the board info may differ */
+	if (!ret && reset_gpio == early_reset && pwdn_gpio == early_pwdn) {
+		ISP_WARNING("%s powered up from probe in %u us\n", SENSOR_NAME, sensor_powerup.us);
+	} else {
+		if (ret != -ENODATA) {
+			ISP_WARNING("%s power up from probe not usable (%d), doing it again\n",
+				    SENSOR_NAME, ret);
+			sensor_gpio_free();
+		}
+		ret = sensor_power_on(sd);
+	}
+	ident = sensor_ident;
 	if (ret) {
 		ISP_ERROR("chip found @ 0x%x (%s) is not an %s chip.\n",
 			  client->addr, client->adapter->name, SENSOR_NAME);
@@ -1048,6 +1120,12 @@ static int sensor_probe(struct i2c_client *client,
 	tx_isp_set_subdevdata(sd, client);
 	tx_isp_set_subdev_hostdata(sd, sensor);
 	private_i2c_set_clientdata(client, sd);
+	/*
+	 * Without gpios from the module parameters the board is not known
+	 * yet; don't drive pins or the clock before g_chip_ident says so.
+	 */
+	if (reset_gpio != -1 || pwdn_gpio != -1)
+		sensor_powerup_start(&sensor_powerup, sensor_power_on, sd);
 
 	pr_debug("probe ok ------->%s\n", SENSOR_NAME);
 
@@ -1058,10 +1136,8 @@ static int sensor_remove(struct i2c_client *client) {
 	struct tx_isp_subdev *sd = private_i2c_get_clientdata(client);
 	struct tx_isp_sensor *sensor = tx_isp_get_subdev_hostdata(sd);
 
-	if (reset_gpio != -1)
-		private_gpio_free(reset_gpio);
-	if (pwdn_gpio != -1)
-		private_gpio_free(pwdn_gpio);
+	sensor_powerup_wait(&sensor_powerup);
+	sensor_gpio_free();
 
 	private_clk_disable_unprepare(sensor->mclk);
 	private_devm_clk_put(&client->dev, sensor->mclk);
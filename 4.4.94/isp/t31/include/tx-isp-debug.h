@@ -38,4 +38,52 @@ bool private_schedule_work(struct work_struct *work);
 void private_do_gettimeofday(struct timeval *tv);
 void private_dma_sync_single_for_device(struct device *dev,
 							      dma_addr_t addr, size_t size, enum dma_data_direction dir);
+
+/* =================== shim trace ================== */
+enum isp_shim_call {
+	ISP_SHIM_I2C,
+	ISP_SHIM_KMALLOC,
+	ISP_SHIM_VMALLOC,
+	ISP_SHIM_SPINLOCK,
+	ISP_SHIM_MUTEX,
+	ISP_SHIM_COMPLETION,
+	ISP_SHIM_DMA_SYNC,
+	ISP_SHIM_CALL_NUMS,
+};
+
+extern int isp_shim_trace;
+void isp_shim_trace_account(enum isp_shim_call call, void *caller,
+			    unsigned long long start, size_t bytes);
+void isp_shim_trace_lock(spinlock_t *lock, void *caller);
+void isp_shim_trace_unlock(spinlock_t *lock);
+int isp_shim_trace_init(void);
+void isp_shim_trace_exit(void);
+extern struct proc_dir_entry *isp_shim_proc;
+
+/* =================== memory arena ================== */
+void *isp_alloc_kmalloc(size_t size, gfp_t gfp, void *caller);
+void isp_alloc_kfree(void *p);
+void *isp_alloc_vmalloc(unsigned long size, void *caller);
+void isp_alloc_vfree(const void *addr);
+int isp_alloc_init(void);
+void isp_alloc_exit(void);
+
+/* =================== async i2c ================== */
+int isp_i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num);
+void isp_i2c_async_add_task(struct task_struct *task);
+void isp_i2c_async_del_task(struct task_struct *task);
+int isp_i2c_async_request_irq(unsigned int irq, irq_handler_t handler,
+			      irq_handler_t thread_fn, unsigned long irqflags,
+			      const char *devname, void *dev_id);
+void isp_i2c_async_free_irq(unsigned int irq, void *dev_id);
+int isp_i2c_async_set_fences(struct i2c_client *client, const unsigned short *regs,
+			     unsigned int nums);
+int isp_i2c_async_init(void);
+void isp_i2c_async_exit(void);
+extern volatile unsigned int isp_irq_seq;
+
+/* =================== dma sync ================== */
+void isp_dma_sync_for_device(struct device *dev, dma_addr_t addr, size_t size,
+			     enum dma_data_direction dir);
+int isp_dma_sync_init(void);
 #endif /* _ISP_DEBUG_H_ */
@@ -106,6 +106,8 @@ void private_clk_disable_unprepare(struct clk *clk);
 struct i2c_adapter* private_i2c_get_adapter(int nr);
 void private_i2c_put_adapter(struct i2c_adapter *adap);
 int private_i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num);
+/* registers whose queued writes are never coalesced, see tx-isp-i2c-async.c */
+int private_i2c_set_fences(struct i2c_client *client, const unsigned short *regs, unsigned int nums);
 int private_i2c_register_driver(struct module *, struct i2c_driver *);
 void private_i2c_del_driver(struct i2c_driver *drv);
 struct i2c_client *private_i2c_new_device(struct i2c_adapter *adap, struct i2c_board_info const *info);
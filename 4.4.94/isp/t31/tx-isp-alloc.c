@@ -0,0 +1,373 @@
+/*
+ * Memory arena behind private_kmalloc/private_vmalloc.
+ *
+ * The isp core allocates in bursts on tuning reloads and mode switches.
+ * Going straight to the kernel allocators fragments memory on the small
+ * parts and sometimes makes vmalloc fail, so the module keeps its own:
+ *
+ * - small objects come from per-module size-class slabs, each object is
+ *   preceded by a header so it can be accounted and reported;
+ * - large buffers come from a region reserved at load time, handed out
+ *   in pages, and only fall back to vmalloc when the region is full.
+ *
+ * Everything still allocated when the module goes away is reported with
+ * the address that allocated it, then released.
+ */
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/mm.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/bitmap.h>
+#include <linux/list.h>
+#include <linux/spinlock.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <tx-isp-debug.h>
+
+static int isp_arena_kb = 512;
+module_param(isp_arena_kb, int, S_IRUGO);
+MODULE_PARM_DESC(isp_arena_kb, "memory reserved for large isp buffers, unit KB");
+
+#define ISP_ALLOC_MAGIC		0x49535041	/* "ISPA" */
+#define ISP_ALLOC_CLASS_NUMS	7		/* 32 bytes .. 2 KB */
+#define ISP_ALLOC_CLASS_LARGE	ISP_ALLOC_CLASS_NUMS
+
+/* keep the kmalloc alignment, the core may hand these buffers to dma */
+struct isp_alloc_hdr {
+	struct list_head entry;
+	void *caller;
+	unsigned int size;
+	unsigned int class;
+	unsigned long magic;
+} __aligned(ARCH_KMALLOC_MINALIGN);
+
+/* large buffers are few, so they are tracked out of line */
+struct isp_alloc_block {
+	struct list_head entry;
+	void *addr;
+	unsigned long size;
+	void *caller;
+	bool in_arena;
+};
+
+struct isp_alloc_stat {
+	unsigned int live;
+	unsigned int peak;
+};
+
+static struct kmem_cache *isp_alloc_caches[ISP_ALLOC_CLASS_NUMS];
+static char isp_alloc_names[ISP_ALLOC_CLASS_NUMS][16];
+static struct isp_alloc_stat isp_alloc_classes[ISP_ALLOC_CLASS_NUMS + 1];
+static LIST_HEAD(isp_alloc_objects);
+static LIST_HEAD(isp_alloc_large);	/* objects above the classes, from kmalloc */
+static LIST_HEAD(isp_alloc_blocks);
+static DEFINE_SPINLOCK(isp_alloc_lock);
+
+static void *isp_arena;
+static unsigned long *isp_arena_map;
+static unsigned int isp_arena_pages;
+static unsigned int isp_arena_used;
+static unsigned int isp_arena_peak;
+
+static unsigned long isp_alloc_live;	/* bytes asked for by the core */
+static unsigned long isp_alloc_peak;
+static unsigned int isp_alloc_fails;
+static unsigned int isp_vmalloc_fallbacks;
+
+static inline unsigned int isp_alloc_class_size(unsigned int class)
+{
+	return 32 << class;
+}
+
+static void isp_alloc_account(unsigned int class, long bytes)
+{
+	struct isp_alloc_stat *stat = &isp_alloc_classes[class];
+
+	if(bytes > 0){
+		if(++stat->live > stat->peak)
+			stat->peak = stat->live;
+	}else
+		stat->live--;
+	isp_alloc_live += bytes;
+	if(isp_alloc_live > isp_alloc_peak)
+		isp_alloc_peak = isp_alloc_live;
+}
+
+void *isp_alloc_kmalloc(size_t size, gfp_t gfp, void *caller)
+{
+	struct isp_alloc_hdr *hdr = NULL;
+	size_t total = size + sizeof(*hdr);
+	unsigned long flags = 0;
+	unsigned int class = 0;
+
+	while(class < ISP_ALLOC_CLASS_NUMS && size > isp_alloc_class_size(class))
+		class++;
+	if(class < ISP_ALLOC_CLASS_NUMS && isp_alloc_caches[class])
+		hdr = kmem_cache_alloc(isp_alloc_caches[class], gfp);
+	else{
+		class = ISP_ALLOC_CLASS_LARGE;
+		hdr = kmalloc(total, gfp);
+	}
+	if(!hdr){
+		isp_alloc_fails++;
+		return NULL;
+	}
+	hdr->caller = caller;
+	hdr->size = size;
+	hdr->class = class;
+	hdr->magic = ISP_ALLOC_MAGIC ^ (unsigned long)hdr;
+
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	list_add_tail(&hdr->entry, class == ISP_ALLOC_CLASS_LARGE ?
+		      &isp_alloc_large : &isp_alloc_objects);
+	isp_alloc_account(class, size);
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+	return hdr + 1;
+}
+
+static void isp_alloc_release(struct isp_alloc_hdr *hdr)
+{
+	hdr->magic = 0;
+	if(hdr->class < ISP_ALLOC_CLASS_NUMS)
+		kmem_cache_free(isp_alloc_caches[hdr->class], hdr);
+	else
+		kfree(hdr);
+}
+
+/*
+ * Whether p came from isp_alloc_kmalloc(), found without reading the
+ * memory in front of it: the class objects sit in slabs of our caches,
+ * the larger ones are on isp_alloc_large. Called with isp_alloc_lock held.
+ */
+static bool isp_alloc_owns(const void *p)
+{
+	struct isp_alloc_hdr *hdr = NULL;
+	struct page *page = NULL;
+	unsigned int class = 0;
+
+	if(virt_addr_valid(p)){
+		page = virt_to_head_page(p);
+		for(class = 0; PageSlab(page) && class < ISP_ALLOC_CLASS_NUMS; class++){
+			if(isp_alloc_caches[class] && page->slab_cache == isp_alloc_caches[class])
+				return true;
+		}
+	}
+	list_for_each_entry(hdr, &isp_alloc_large, entry){
+		if(hdr + 1 == p)
+			return true;
+	}
+	return false;
+}
+
+void isp_alloc_kfree(void *p)
+{
+	struct isp_alloc_hdr *hdr = NULL;
+	unsigned long flags = 0;
+
+	if(p == NULL)
+		return;
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	/* memory the core got from somewhere else goes back to the kernel */
+	if(!isp_alloc_owns(p)){
+		spin_unlock_irqrestore(&isp_alloc_lock, flags);
+		kfree(p);
+		return;
+	}
+	hdr = (struct isp_alloc_hdr *)p - 1;
+	if(hdr->magic != (ISP_ALLOC_MAGIC ^ (unsigned long)hdr)){
+		spin_unlock_irqrestore(&isp_alloc_lock, flags);
+		ISP_WARNING("isp freed %p twice or not from its start, %pS\n",
+			    p, __builtin_return_address(0));
+		return;
+	}
+	list_del(&hdr->entry);
+	isp_alloc_account(hdr->class, -(long)hdr->size);
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+	isp_alloc_release(hdr);
+}
+
+void *isp_alloc_vmalloc(unsigned long size, void *caller)
+{
+	struct isp_alloc_block *block = NULL;
+	unsigned int pages = PAGE_ALIGN(size) >> PAGE_SHIFT;
+	unsigned long flags = 0;
+	unsigned long start = 0;
+
+	block = kmalloc(sizeof(*block), GFP_KERNEL);
+	if(!block){
+		isp_alloc_fails++;
+		return NULL;
+	}
+	block->size = size;
+	block->caller = caller;
+	block->in_arena = false;
+
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	if(isp_arena && pages){
+		start = bitmap_find_next_zero_area(isp_arena_map, isp_arena_pages, 0, pages, 0);
+		if(start < isp_arena_pages){
+			bitmap_set(isp_arena_map, start, pages);
+			isp_arena_used += pages;
+			if(isp_arena_used > isp_arena_peak)
+				isp_arena_peak = isp_arena_used;
+			block->addr = isp_arena + (start << PAGE_SHIFT);
+			block->in_arena = true;
+		}
+	}
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+
+	if(!block->in_arena){
+		block->addr = vmalloc(size);
+		if(!block->addr){
+			kfree(block);
+			isp_alloc_fails++;
+			return NULL;
+		}
+	}
+
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	if(!block->in_arena)
+		isp_vmalloc_fallbacks++;
+	list_add_tail(&block->entry, &isp_alloc_blocks);
+	isp_alloc_account(ISP_ALLOC_CLASS_LARGE, size);
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+	return block->addr;
+}
+
+static void isp_alloc_drop_block(struct isp_alloc_block *block)
+{
+	unsigned int pages = PAGE_ALIGN(block->size) >> PAGE_SHIFT;
+
+	list_del(&block->entry);
+	isp_alloc_account(ISP_ALLOC_CLASS_LARGE, -(long)block->size);
+	if(block->in_arena){
+		bitmap_clear(isp_arena_map, (block->addr - isp_arena) >> PAGE_SHIFT, pages);
+		isp_arena_used -= pages;
+	}
+}
+
+void isp_alloc_vfree(const void *addr)
+{
+	struct isp_alloc_block *block = NULL;
+	unsigned long flags = 0;
+	bool found = false;
+
+	if(addr == NULL)
+		return;
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	list_for_each_entry(block, &isp_alloc_blocks, entry){
+		if(block->addr == addr){
+			isp_alloc_drop_block(block);
+			found = true;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+
+	if(!found){
+		vfree(addr);
+		return;
+	}
+	if(!block->in_arena)
+		vfree(addr);
+	kfree(block);
+}
+
+static int isp_alloc_show(struct seq_file *m, void *v)
+{
+	unsigned long flags = 0;
+	int i = 0;
+
+	spin_lock_irqsave(&isp_alloc_lock, flags);
+	seq_printf(m, "live %lu bytes, peak %lu bytes, %u failures\n",
+		   isp_alloc_live, isp_alloc_peak, isp_alloc_fails);
+	for(i = 0; i < ISP_ALLOC_CLASS_NUMS; i++)
+		seq_printf(m, "class %4u: live %u, peak %u%s\n", isp_alloc_class_size(i),
+			   isp_alloc_classes[i].live, isp_alloc_classes[i].peak,
+			   isp_alloc_caches[i] ? "" : " (no slab)");
+	seq_printf(m, "large     : live %u, peak %u\n",
+		   isp_alloc_classes[ISP_ALLOC_CLASS_LARGE].live,
+		   isp_alloc_classes[ISP_ALLOC_CLASS_LARGE].peak);
+	seq_printf(m, "arena     : %u/%u pages used, peak %u, %u vmalloc fallbacks\n",
+		   isp_arena_used, isp_arena_pages, isp_arena_peak, isp_vmalloc_fallbacks);
+	spin_unlock_irqrestore(&isp_alloc_lock, flags);
+	return 0;
+}
+
+static int isp_alloc_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, isp_alloc_show, PDE_DATA(inode), 2048);
+}
+
+static const struct file_operations isp_alloc_fops = {
+	.read = seq_read,
+	.open = isp_alloc_open,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+int isp_alloc_init(void)
+{
+	unsigned int class = 0;
+
+	for(class = 0; class < ISP_ALLOC_CLASS_NUMS; class++){
+		snprintf(isp_alloc_names[class], sizeof(isp_alloc_names[class]),
+			 "isp-%u", isp_alloc_class_size(class));
+		isp_alloc_caches[class] = kmem_cache_create(isp_alloc_names[class],
+						sizeof(struct isp_alloc_hdr) + isp_alloc_class_size(class),
+						ARCH_KMALLOC_MINALIGN, 0, NULL);
+		/* the class just goes through kmalloc without its slab */
+		if(!isp_alloc_caches[class])
+			ISP_WARNING("Failed to create the %s slab\n", isp_alloc_names[class]);
+	}
+
+	if(isp_arena_kb > 0){
+		isp_arena_pages = (isp_arena_kb * 1024) >> PAGE_SHIFT;
+		isp_arena_map = kzalloc(BITS_TO_LONGS(isp_arena_pages) * sizeof(long), GFP_KERNEL);
+		isp_arena = vmalloc(isp_arena_pages << PAGE_SHIFT);
+		if(!isp_arena || !isp_arena_map){
+			ISP_WARNING("Failed to reserve %d KB for isp buffers\n", isp_arena_kb);
+			vfree(isp_arena);
+			kfree(isp_arena_map);
+			isp_arena = NULL;
+			isp_arena_map = NULL;
+			isp_arena_pages = 0;
+		}
+	}
+
+	if(isp_shim_proc && !proc_create_data("alloc", S_IRUGO, isp_shim_proc, &isp_alloc_fops, NULL))
+		ISP_WARNING("Failed to create the isp-shim alloc node\n");
+	return 0;
+}
+
+void isp_alloc_exit(void)
+{
+	struct isp_alloc_hdr *hdr = NULL, *tmp = NULL;
+	struct isp_alloc_block *block = NULL, *btmp = NULL;
+	unsigned int class = 0;
+
+	list_splice_init(&isp_alloc_large, &isp_alloc_objects);
+	list_for_each_entry_safe(hdr, tmp, &isp_alloc_objects, entry){
+		ISP_WARNING("isp leaked %u bytes from %pS\n", hdr->size, hdr->caller);
+		list_del(&hdr->entry);
+		isp_alloc_release(hdr);
+	}
+	list_for_each_entry_safe(block, btmp, &isp_alloc_blocks, entry){
+		ISP_WARNING("isp leaked %lu bytes from %pS\n", block->size, block->caller);
+		isp_alloc_drop_block(block);
+		if(!block->in_arena)
+			vfree(block->addr);
+		kfree(block);
+	}
+
+	vfree(isp_arena);
+	kfree(isp_arena_map);
+	isp_arena = NULL;
+	isp_arena_map = NULL;
+	for(class = 0; class < ISP_ALLOC_CLASS_NUMS; class++){
+		if(isp_alloc_caches[class])
+			kmem_cache_destroy(isp_alloc_caches[class]);
+		isp_alloc_caches[class] = NULL;
+	}
+}
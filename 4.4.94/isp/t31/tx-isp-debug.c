@@ -149,7 +149,15 @@ void private_do_gettimeofday(struct timeval *tv)
 void private_dma_sync_single_for_device(struct device *dev,
 							      dma_addr_t addr, size_t size, enum dma_data_direction dir)
 {
-	dma_sync_single_for_device(dev, addr, size, dir);
+	unsigned long long start = 0;
+
+	if(!isp_shim_trace){
+		isp_dma_sync_for_device(dev, addr, size, dir);
+		return;
+	}
+	start = sched_clock();
+	isp_dma_sync_for_device(dev, addr, size, dir);
+	isp_shim_trace_account(ISP_SHIM_DMA_SYNC, __builtin_return_address(0), start, size);
 	return;
 }
 
@@ -233,7 +241,7 @@ int private_request_threaded_irq(unsigned int irq, irq_handler_t handler,
 				 irq_handler_t thread_fn, unsigned long irqflags,
 				 const char *devname, void *dev_id)
 {
-	return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+	return isp_i2c_async_request_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
 }
 
 void private_enable_irq(unsigned int irq)
@@ -248,17 +256,21 @@ void private_disable_irq(unsigned int irq)
 
 void private_free_irq(unsigned int irq, void *dev_id)
 {
-	free_irq(irq, dev_id);
+	isp_i2c_async_free_irq(irq, dev_id);
 }
 
 /* lock and mutex interfaces */
 void __private_spin_lock_irqsave(spinlock_t *lock, unsigned long *flags)
 {
 	raw_spin_lock_irqsave(spinlock_check(lock), *flags);
+	if(isp_shim_trace)
+		isp_shim_trace_lock(lock, __builtin_return_address(0));
 }
 
 void private_spin_unlock_irqrestore(spinlock_t *lock, unsigned long flags)
 {
+	/* always look, the trace may have been turned off while it was held */
+	isp_shim_trace_unlock(lock);
 	spin_unlock_irqrestore(lock, flags);
 }
 
@@ -269,7 +281,15 @@ void private_spin_lock_init(spinlock_t *lock)
 
 void private_mutex_lock(struct mutex *lock)
 {
+	unsigned long long start = 0;
+
+	if(!isp_shim_trace){
+		mutex_lock(lock);
+		return;
+	}
+	start = sched_clock();
 	mutex_lock(lock);
+	isp_shim_trace_account(ISP_SHIM_MUTEX, __builtin_return_address(0), start, 0);
 }
 
 void private_mutex_unlock(struct mutex *lock)
@@ -363,10 +383,28 @@ void private_i2c_put_adapter(struct i2c_adapter *adap)
 
 int private_i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
 {
-	return i2c_transfer(adap, msgs, num);
+	unsigned long long start = 0;
+	size_t bytes = 0;
+	int ret = 0;
+	int i = 0;
+
+	if(!isp_shim_trace)
+		return isp_i2c_transfer(adap, msgs, num);
+	start = sched_clock();
+	ret = isp_i2c_transfer(adap, msgs, num);
+	for(i = 0; i < num; i++)
+		bytes += msgs[i].len;
+	isp_shim_trace_account(ISP_SHIM_I2C, __builtin_return_address(0), start, bytes);
+	return ret;
 }
 EXPORT_SYMBOL(private_i2c_transfer);
 
+int private_i2c_set_fences(struct i2c_client *client, const unsigned short *regs, unsigned int nums)
+{
+	return isp_i2c_async_set_fences(client, regs, nums);
+}
+EXPORT_SYMBOL(private_i2c_set_fences);
+
 int private_i2c_register_driver(struct module *owner, struct i2c_driver *driver)
 {
 	return i2c_register_driver(owner, driver);
@@ -509,12 +547,28 @@ void private_complete(struct completion *x)
 
 int private_wait_for_completion_interruptible(struct completion *x)
 {
-	return wait_for_completion_interruptible(x);
+	unsigned long long start = 0;
+	int ret = 0;
+
+	if(!isp_shim_trace)
+		return wait_for_completion_interruptible(x);
+	start = sched_clock();
+	ret = wait_for_completion_interruptible(x);
+	isp_shim_trace_account(ISP_SHIM_COMPLETION, __builtin_return_address(0), start, 0);
+	return ret;
 }
 
 unsigned long private_wait_for_completion_timeout(struct completion *x, unsigned long timeover)
 {
-	return wait_for_completion_timeout(x, timeover);
+	unsigned long long start = 0;
+	unsigned long ret = 0;
+
+	if(!isp_shim_trace)
+		return wait_for_completion_timeout(x, timeover);
+	start = sched_clock();
+	ret = wait_for_completion_timeout(x, timeover);
+	isp_shim_trace_account(ISP_SHIM_COMPLETION, __builtin_return_address(0), start, 0);
+	return ret;
 }
 
 int private_wait_event_interruptible(wait_queue_head_t *q, int (*state)(void *), void *data)
@@ -562,27 +616,33 @@ struct proc_dir_entry *private_proc_create_data(const char *name, umode_t mode,
 //malloc
 void *private_vmalloc(unsigned long size)
 {
-	void *addr = vmalloc(size);
+	unsigned long long start = isp_shim_trace ? sched_clock() : 0;
+	void *addr = isp_alloc_vmalloc(size, __builtin_return_address(0));
 	if (!addr)
 		pr_err("%s: vmalloc(%lu) failed\n", __func__, size);
+	if (start)
+		isp_shim_trace_account(ISP_SHIM_VMALLOC, __builtin_return_address(0), start, size);
 	return addr;
 }
 
 void private_vfree(const void *addr)
 {
-	vfree(addr);
+	isp_alloc_vfree(addr);
 }
 
 void *private_kmalloc(size_t s, gfp_t gfp)
 {
-	void *addr = kmalloc(s, gfp);
+	unsigned long long start = isp_shim_trace ? sched_clock() : 0;
+	void *addr = isp_alloc_kmalloc(s, gfp, __builtin_return_address(0));
 	if (!addr)
 		pr_err("%s: kmalloc(%zu) failed\n", __func__, s);
+	if (start)
+		isp_shim_trace_account(ISP_SHIM_KMALLOC, __builtin_return_address(0), start, s);
 	return addr;
 }
 
 void private_kfree(void *p){
-	kfree(p);
+	isp_alloc_kfree(p);
 }
 
 //copy user
@@ -634,7 +694,15 @@ void private_set_fs(mm_segment_t val)
 void private_dma_cache_sync(struct device *dev, void *vaddr, size_t size,
 			    enum dma_data_direction direction)
 {
+	unsigned long long start = 0;
+
+	if(!isp_shim_trace){
+		dma_cache_sync(dev, vaddr, size, direction);
+		return;
+	}
+	start = sched_clock();
 	dma_cache_sync(dev, vaddr, size, direction);
+	isp_shim_trace_account(ISP_SHIM_DMA_SYNC, __builtin_return_address(0), start, size);
 }
 
 void private_getrawmonotonic(struct timespec *ts)
@@ -651,11 +719,15 @@ bool private_kthread_should_stop(void)
 
 struct task_struct* private_kthread_run(int (*threadfn)(void *data), void *data, const char namefmt[])
 {
-	return kthread_run(threadfn, data, namefmt);
+	struct task_struct *task = kthread_run(threadfn, data, namefmt);
+
+	isp_i2c_async_add_task(task);
+	return task;
 }
 
 int private_kthread_stop(struct task_struct *k)
 {
+	isp_i2c_async_del_task(k);
 	return kthread_stop(k);
 }
 
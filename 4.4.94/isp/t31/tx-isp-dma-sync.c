@@ -0,0 +1,184 @@
+/*
+ * Redundant cache maintenance elimination for private_dma_sync_single_for_device.
+ *
+ * The isp core syncs its statistics and tuning buffers every frame, and
+ * often issues the same range again before the frame is over without
+ * touching it from the cpu in between. With "dma_sync_merge=1" the ranges
+ * synced since the last isp interrupt are remembered, merged when they
+ * overlap or touch, and any part of a new request they already cover is
+ * not synced again. The isp interrupt is the frame clock, the ranges are
+ * forgotten on every one of them.
+ *
+ * This relies on the core not writing a buffer it already synced within
+ * the same frame, so it is off by default. With merging on, syncs for
+ * coherent devices are skipped too, the kernel would do nothing for them
+ * anyway. With it off every sync goes to the kernel as it is, unaccounted.
+ */
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/spinlock.h>
+#include <linux/dma-mapping.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <dma-coherence.h>
+#include <tx-isp-debug.h>
+
+static int isp_dma_sync_merge = 0;
+module_param_named(dma_sync_merge, isp_dma_sync_merge, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(dma_sync_merge, "skip dma syncs of ranges already synced in the frame");
+
+#define ISP_DMA_RANGE_NUMS	32
+
+struct isp_dma_range {
+	struct device *dev;
+	dma_addr_t start;
+	dma_addr_t end;
+	enum dma_data_direction dir;
+};
+
+static struct isp_dma_range isp_dma_ranges[ISP_DMA_RANGE_NUMS];
+static unsigned int isp_dma_range_nums;
+static unsigned int isp_dma_epoch;
+static DEFINE_SPINLOCK(isp_dma_lock);
+
+/* statistics, under isp_dma_lock */
+static unsigned int isp_dma_calls;
+static unsigned int isp_dma_skipped;
+static unsigned int isp_dma_coherent;
+static unsigned long long isp_dma_synced_bytes;
+static unsigned long long isp_dma_elided_bytes;
+
+static inline bool isp_dma_same(struct isp_dma_range *r, struct device *dev,
+				enum dma_data_direction dir)
+{
+	return r->dev == dev && r->dir == dir;
+}
+
+/* merge [start, end) into the ranges of the frame, touching ones included */
+static void isp_dma_remember(struct device *dev, dma_addr_t start, dma_addr_t end,
+			     enum dma_data_direction dir)
+{
+	struct isp_dma_range *r = NULL;
+	int i = 0;
+
+	for(i = 0; i < isp_dma_range_nums; ){
+		r = &isp_dma_ranges[i];
+		if(isp_dma_same(r, dev, dir) && r->start <= end && start <= r->end){
+			start = min(start, r->start);
+			end = max(end, r->end);
+			*r = isp_dma_ranges[--isp_dma_range_nums];
+			continue;
+		}
+		i++;
+	}
+	/* nothing more is remembered once full, that only costs syncs */
+	if(isp_dma_range_nums == ISP_DMA_RANGE_NUMS)
+		return;
+	r = &isp_dma_ranges[isp_dma_range_nums++];
+	r->dev = dev;
+	r->start = start;
+	r->end = end;
+	r->dir = dir;
+}
+
+/*
+ * Cut the parts already synced off both ends of [*start, *end). The
+ * ranges never overlap each other, so one that covers the start can be
+ * followed by one that covers the end; a range in the middle of the
+ * request doesn't shorten it.
+ */
+static void isp_dma_trim(struct device *dev, dma_addr_t *start, dma_addr_t *end,
+			 enum dma_data_direction dir)
+{
+	struct isp_dma_range *r = NULL;
+	bool trimmed = true;
+	int i = 0;
+
+	while(trimmed && *start < *end){
+		trimmed = false;
+		for(i = 0; i < isp_dma_range_nums && *start < *end; i++){
+			r = &isp_dma_ranges[i];
+			if(!isp_dma_same(r, dev, dir))
+				continue;
+			if(r->start <= *start && *start < r->end){
+				*start = min(r->end, *end);
+				trimmed = true;
+			}else if(r->start < *end && *end <= r->end){
+				*end = max(r->start, *start);
+				trimmed = true;
+			}
+		}
+	}
+}
+
+void isp_dma_sync_for_device(struct device *dev, dma_addr_t addr, size_t size,
+			     enum dma_data_direction dir)
+{
+	dma_addr_t start = addr;
+	dma_addr_t end = addr + size;
+	unsigned long flags = 0;
+
+	if(!isp_dma_sync_merge){
+		dma_sync_single_for_device(dev, addr, size, dir);
+		return;
+	}
+	if(dev && plat_device_is_coherent(dev)){
+		spin_lock_irqsave(&isp_dma_lock, flags);
+		isp_dma_calls++;
+		isp_dma_coherent++;
+		isp_dma_elided_bytes += size;
+		spin_unlock_irqrestore(&isp_dma_lock, flags);
+		return;
+	}
+
+	spin_lock_irqsave(&isp_dma_lock, flags);
+	isp_dma_calls++;
+	if(isp_dma_epoch != isp_irq_seq){
+		isp_dma_epoch = isp_irq_seq;
+		isp_dma_range_nums = 0;
+	}
+	isp_dma_trim(dev, &start, &end, dir);
+	isp_dma_remember(dev, addr, addr + size, dir);
+	isp_dma_synced_bytes += end - start;
+	isp_dma_elided_bytes += size - (end - start);
+	if(start == end)
+		isp_dma_skipped++;
+	spin_unlock_irqrestore(&isp_dma_lock, flags);
+
+	if(start < end)
+		dma_sync_single_for_device(dev, start, end - start, dir);
+}
+
+static int isp_dma_show(struct seq_file *m, void *v)
+{
+	unsigned long flags = 0;
+
+	spin_lock_irqsave(&isp_dma_lock, flags);
+	seq_printf(m, "merge %s, %u ranges in this frame\n",
+		   isp_dma_sync_merge ? "on" : "off", isp_dma_range_nums);
+	seq_printf(m, "calls %u, skipped %u, coherent %u\n",
+		   isp_dma_calls, isp_dma_skipped, isp_dma_coherent);
+	seq_printf(m, "synced %llu bytes, elided %llu bytes\n",
+		   isp_dma_synced_bytes, isp_dma_elided_bytes);
+	spin_unlock_irqrestore(&isp_dma_lock, flags);
+	return 0;
+}
+
+static int isp_dma_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, isp_dma_show, PDE_DATA(inode), 512);
+}
+
+static const struct file_operations isp_dma_fops = {
+	.read = seq_read,
+	.open = isp_dma_open,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+int isp_dma_sync_init(void)
+{
+	if(isp_shim_proc && !proc_create_data("dma", S_IRUGO, isp_shim_proc, &isp_dma_fops, NULL))
+		ISP_WARNING("Failed to create the isp-shim dma node\n");
+	return 0;
+}
@@ -0,0 +1,459 @@
+/*
+ * Asynchronous sensor writes behind private_i2c_transfer.
+ *
+ * AE/AWB of the isp core write the sensor from the isp threads, and each
+ * write blocks on the i2c controller for hundreds of microseconds. With
+ * "i2c_async=1" the single-message writes made from those threads are
+ * queued instead and applied by a realtime worker after the next isp
+ * interrupt, so they land in the vertical blanking rather than delaying
+ * the statistics.
+ *
+ * A write replaces the queued value in place only when the queued entry
+ * is the last write to that sensor, so coalescing never reorders two
+ * registers. Registers are told apart by everything but the last byte of
+ * the message. The registers a sensor driver declares as fences with
+ * private_i2c_set_fences(), e.g. the group hold 0x3208 of the OmniVision
+ * sensors, are never coalesced: 0x3208=0x12 followed by 0x3208=0xe2 must
+ * both reach the sensor. Reads and any other transfer flush the queue
+ * first and stay synchronous, and so does everything from outside the isp
+ * threads, e.g. the sensor init tables.
+ */
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/sched.h>
+#include <linux/kthread.h>
+#include <linux/interrupt.h>
+#include <linux/i2c.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+#include <linux/math64.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <tx-isp-debug.h>
+
+static int isp_i2c_async = 0;
+module_param_named(i2c_async, isp_i2c_async, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_async, "queue sensor writes of the isp threads");
+
+static int isp_i2c_async_hold_ms = 10;
+module_param_named(i2c_async_hold_ms, isp_i2c_async_hold_ms, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(i2c_async_hold_ms, "longest wait for an isp interrupt before applying writes");
+
+#define ISP_I2C_QUEUE_SIZE	64
+#define ISP_I2C_WRITE_MAX	8	/* longer writes stay synchronous */
+#define ISP_I2C_TASK_NUMS	8
+#define ISP_I2C_IRQ_NUMS	4
+#define ISP_I2C_FENCE_CLIENTS	4
+#define ISP_I2C_FENCE_REGS	4
+
+struct isp_i2c_write {
+	struct i2c_adapter *adap;
+	unsigned short addr;
+	unsigned short flags;
+	unsigned short len;
+	unsigned char buf[ISP_I2C_WRITE_MAX];
+	unsigned long long queued;
+};
+
+struct isp_i2c_fence {
+	struct i2c_adapter *adap;
+	unsigned short addr;
+	unsigned int nums;
+	unsigned short regs[ISP_I2C_FENCE_REGS];
+};
+
+struct isp_i2c_irq {
+	unsigned int irq;
+	irq_handler_t handler;
+	irq_handler_t thread_fn;
+	void *dev_id;
+};
+
+static struct isp_i2c_write isp_i2c_queue[ISP_I2C_QUEUE_SIZE];
+static struct isp_i2c_write isp_i2c_drain[ISP_I2C_QUEUE_SIZE];	/* under isp_i2c_mutex */
+static unsigned int isp_i2c_depth;
+static DEFINE_SPINLOCK(isp_i2c_lock);
+static DEFINE_MUTEX(isp_i2c_mutex);		/* keeps the bus in program order */
+static DECLARE_WAIT_QUEUE_HEAD(isp_i2c_wq);
+static struct task_struct *isp_i2c_worker;
+/* counts the isp interrupts, the other shims use it as the frame clock */
+volatile unsigned int isp_irq_seq;
+
+static struct task_struct *isp_i2c_tasks[ISP_I2C_TASK_NUMS];
+static struct isp_i2c_irq isp_i2c_irqs[ISP_I2C_IRQ_NUMS];
+static struct isp_i2c_fence isp_i2c_fences[ISP_I2C_FENCE_CLIENTS];	/* under isp_i2c_lock */
+static DEFINE_SPINLOCK(isp_i2c_table_lock);
+
+/* statistics, under isp_i2c_lock */
+static unsigned int isp_i2c_queued;
+static unsigned int isp_i2c_coalesced;
+static unsigned int isp_i2c_applied;
+static unsigned int isp_i2c_errors;
+static unsigned int isp_i2c_sync_flushes;
+static unsigned int isp_i2c_max_depth;
+static unsigned long long isp_i2c_latency_ns;
+static unsigned long long isp_i2c_max_latency_ns;
+
+static bool isp_i2c_from_isp_thread(void)
+{
+	int i = 0;
+
+	for(i = 0; i < ISP_I2C_TASK_NUMS; i++){
+		if(isp_i2c_tasks[i] == current)
+			return true;
+	}
+	return false;
+}
+
+static inline bool isp_i2c_same_reg(struct isp_i2c_write *w, struct i2c_adapter *adap,
+				    struct i2c_msg *msg)
+{
+	return w->adap == adap && w->addr == msg->addr && w->flags == msg->flags
+		&& w->len == msg->len && !memcmp(w->buf, msg->buf, msg->len - 1);
+}
+
+/* under isp_i2c_lock */
+static bool isp_i2c_is_fence(struct i2c_adapter *adap, struct i2c_msg *msg)
+{
+	struct isp_i2c_fence *f = NULL;
+	unsigned short reg = 0;
+	int i = 0;
+	int j = 0;
+
+	if(msg->len > 3)
+		return false;
+	reg = msg->len == 3 ? (msg->buf[0] << 8) | msg->buf[1] : msg->buf[0];
+	for(i = 0; i < ISP_I2C_FENCE_CLIENTS; i++){
+		f = &isp_i2c_fences[i];
+		if(f->adap != adap || f->addr != msg->addr)
+			continue;
+		for(j = 0; j < f->nums; j++){
+			if(f->regs[j] == reg)
+				return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * The registers of a sensor whose writes must reach it one by one, in
+ * order: group hold, stream on, page select. nums 0 forgets the sensor.
+ */
+int isp_i2c_async_set_fences(struct i2c_client *client, const unsigned short *regs,
+			     unsigned int nums)
+{
+	struct isp_i2c_fence *f = NULL;
+	unsigned long flags = 0;
+	int i = 0;
+
+	if(client == NULL || nums > ISP_I2C_FENCE_REGS)
+		return -EINVAL;
+	spin_lock_irqsave(&isp_i2c_lock, flags);
+	for(i = 0; i < ISP_I2C_FENCE_CLIENTS; i++){
+		if(isp_i2c_fences[i].adap == client->adapter
+		   && isp_i2c_fences[i].addr == client->addr){
+			f = &isp_i2c_fences[i];
+			break;
+		}
+		if(f == NULL && isp_i2c_fences[i].adap == NULL)
+			f = &isp_i2c_fences[i];
+	}
+	if(f){
+		f->adap = nums ? client->adapter : NULL;
+		f->addr = client->addr;
+		f->nums = nums;
+		if(nums)
+			memcpy(f->regs, regs, nums * sizeof(regs[0]));
+	}
+	spin_unlock_irqrestore(&isp_i2c_lock, flags);
+	return f || nums == 0 ? 0 : -ENOSPC;
+}
+
+static int isp_i2c_flush_locked(void)
+{
+	struct isp_i2c_write *w = NULL;
+	struct i2c_msg msg;
+	unsigned long long now = 0;
+	unsigned long flags = 0;
+	unsigned int depth = 0;
+	int ret = 0;
+	int i = 0;
+
+	spin_lock_irqsave(&isp_i2c_lock, flags);
+	depth = isp_i2c_depth;
+	memcpy(isp_i2c_drain, isp_i2c_queue, depth * sizeof(isp_i2c_queue[0]));
+	isp_i2c_depth = 0;
+	spin_unlock_irqrestore(&isp_i2c_lock, flags);
+
+	for(i = 0; i < depth; i++){
+		w = &isp_i2c_drain[i];
+		msg.addr = w->addr;
+		msg.flags = w->flags;
+		msg.len = w->len;
+		msg.buf = w->buf;
+		ret = i2c_transfer(w->adap, &msg, 1);
+		now = sched_clock();
+
+		spin_lock_irqsave(&isp_i2c_lock, flags);
+		if(ret != 1)
+			isp_i2c_errors++;
+		isp_i2c_applied++;
+		isp_i2c_latency_ns += now - w->queued;
+		if(now - w->queued > isp_i2c_max_latency_ns)
+			isp_i2c_max_latency_ns = now - w->queued;
+		spin_unlock_irqrestore(&isp_i2c_lock, flags);
+		if(ret != 1)
+			ISP_ERROR("%s: write 0x%02x to sensor 0x%02x failed (%d)\n",
+				  __func__, w->buf[0], w->addr, ret);
+	}
+	return depth;
+}
+
+/* queue one write, false when it has to go synchronously */
+static bool isp_i2c_queue_write(struct i2c_adapter *adap, struct i2c_msg *msg)
+{
+	struct isp_i2c_write *w = NULL;
+	unsigned long flags = 0;
+	int i = 0;
+
+	spin_lock_irqsave(&isp_i2c_lock, flags);
+	/* only the last queued write to the sensor may be replaced */
+	for(i = isp_i2c_depth - 1; i >= 0; i--){
+		if(isp_i2c_queue[i].adap == adap && isp_i2c_queue[i].addr == msg->addr)
+			break;
+	}
+	if(i >= 0 && isp_i2c_same_reg(&isp_i2c_queue[i], adap, msg)
+	   && !isp_i2c_is_fence(adap, msg)){
+		w = &isp_i2c_queue[i];
+		isp_i2c_coalesced++;
+	}else if(isp_i2c_depth < ISP_I2C_QUEUE_SIZE){
+		w = &isp_i2c_queue[isp_i2c_depth++];
+		if(isp_i2c_depth > isp_i2c_max_depth)
+			isp_i2c_max_depth = isp_i2c_depth;
+	}
+	if(w){
+		w->adap = adap;
+		w->addr = msg->addr;
+		w->flags = msg->flags;
+		w->len = msg->len;
+		memcpy(w->buf, msg->buf, msg->len);
+		w->queued = sched_clock();
+		isp_i2c_queued++;
+	}
+	spin_unlock_irqrestore(&isp_i2c_lock, flags);
+
+	if(w)
+		wake_up(&isp_i2c_wq);
+	return w != NULL;
+}
+
+int isp_i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
+{
+	int ret = 0;
+
+	if(isp_i2c_async && isp_i2c_worker && num == 1 && !(msgs[0].flags & I2C_M_RD)
+	   && msgs[0].len > 1 && msgs[0].len <= ISP_I2C_WRITE_MAX
+	   && isp_i2c_from_isp_thread()){
+		if(isp_i2c_queue_write(adap, &msgs[0]))
+			return num;
+	}
+
+	mutex_lock(&isp_i2c_mutex);
+	if(isp_i2c_flush_locked())
+		isp_i2c_sync_flushes++;
+	ret = i2c_transfer(adap, msgs, num);
+	mutex_unlock(&isp_i2c_mutex);
+	return ret;
+}
+
+static int isp_i2c_pending(void)
+{
+	return isp_i2c_depth || kthread_should_stop();
+}
+
+static int isp_i2c_thread(void *data)
+{
+	struct sched_param param = { .sched_priority = MAX_RT_PRIO - 2 };
+	unsigned int seq = 0;
+
+	sched_setscheduler(current, SCHED_FIFO, &param);
+	while(!kthread_should_stop()){
+		wait_event_interruptible(isp_i2c_wq, isp_i2c_pending());
+		if(kthread_should_stop())
+			break;
+		/* apply after the next isp interrupt, in the blanking */
+		seq = isp_irq_seq;
+		wait_event_interruptible_timeout(isp_i2c_wq,
+				isp_irq_seq != seq || kthread_should_stop(),
+				msecs_to_jiffies(isp_i2c_async_hold_ms));
+		mutex_lock(&isp_i2c_mutex);
+		isp_i2c_flush_locked();
+		mutex_unlock(&isp_i2c_mutex);
+	}
+	return 0;
+}
+
+/* the threads of the isp core are the only ones whose writes are queued */
+void isp_i2c_async_add_task(struct task_struct *task)
+{
+	unsigned long flags = 0;
+	int i = 0;
+
+	if(IS_ERR_OR_NULL(task))
+		return;
+	spin_lock_irqsave(&isp_i2c_table_lock, flags);
+	for(i = 0; i < ISP_I2C_TASK_NUMS; i++){
+		if(isp_i2c_tasks[i] == NULL){
+			isp_i2c_tasks[i] = task;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&isp_i2c_table_lock, flags);
+}
+
+void isp_i2c_async_del_task(struct task_struct *task)
+{
+	unsigned long flags = 0;
+	int i = 0;
+
+	spin_lock_irqsave(&isp_i2c_table_lock, flags);
+	for(i = 0; i < ISP_I2C_TASK_NUMS; i++){
+		if(isp_i2c_tasks[i] == task)
+			isp_i2c_tasks[i] = NULL;
+	}
+	spin_unlock_irqrestore(&isp_i2c_table_lock, flags);
+}
+
+static irqreturn_t isp_i2c_irq_handler(int irq, void *data)
+{
+	struct isp_i2c_irq *entry = data;
+
+	isp_irq_seq++;
+	if(isp_i2c_depth)
+		wake_up(&isp_i2c_wq);
+	return entry->handler(irq, entry->dev_id);
+}
+
+static irqreturn_t isp_i2c_irq_thread(int irq, void *data)
+{
+	struct isp_i2c_irq *entry = data;
+
+	return entry->thread_fn(irq, entry->dev_id);
+}
+
+/*
+ * The interrupts of the isp core are seen through a small wrapper, that
+ * is how the worker knows where the frame is.
+ */
+int isp_i2c_async_request_irq(unsigned int irq, irq_handler_t handler,
+			      irq_handler_t thread_fn, unsigned long irqflags,
+			      const char *devname, void *dev_id)
+{
+	struct isp_i2c_irq *entry = NULL;
+	unsigned long flags = 0;
+	int ret = 0;
+	int i = 0;
+
+	if(handler == NULL)
+		return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+
+	spin_lock_irqsave(&isp_i2c_table_lock, flags);
+	for(i = 0; i < ISP_I2C_IRQ_NUMS; i++){
+		if(isp_i2c_irqs[i].handler == NULL){
+			entry = &isp_i2c_irqs[i];
+			entry->irq = irq;
+			entry->handler = handler;
+			entry->thread_fn = thread_fn;
+			entry->dev_id = dev_id;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&isp_i2c_table_lock, flags);
+	if(entry == NULL)
+		return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+
+	ret = request_threaded_irq(irq, isp_i2c_irq_handler, thread_fn ? isp_i2c_irq_thread : NULL,
+				   irqflags, devname, entry);
+	if(ret)
+		entry->handler = NULL;
+	return ret;
+}
+
+void isp_i2c_async_free_irq(unsigned int irq, void *dev_id)
+{
+	struct isp_i2c_irq *entry = NULL;
+	unsigned long flags = 0;
+	int i = 0;
+
+	spin_lock_irqsave(&isp_i2c_table_lock, flags);
+	for(i = 0; i < ISP_I2C_IRQ_NUMS; i++){
+		if(isp_i2c_irqs[i].handler && isp_i2c_irqs[i].irq == irq
+		   && isp_i2c_irqs[i].dev_id == dev_id){
+			entry = &isp_i2c_irqs[i];
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&isp_i2c_table_lock, flags);
+	if(entry == NULL){
+		free_irq(irq, dev_id);
+		return;
+	}
+	/* the entry is in use until free_irq has waited for the handler */
+	free_irq(irq, entry);
+	spin_lock_irqsave(&isp_i2c_table_lock, flags);
+	entry->handler = NULL;
+	spin_unlock_irqrestore(&isp_i2c_table_lock, flags);
+}
+
+static int isp_i2c_show(struct seq_file *m, void *v)
+{
+	unsigned long flags = 0;
+
+	spin_lock_irqsave(&isp_i2c_lock, flags);
+	seq_printf(m, "async %s, depth %u, max depth %u\n", isp_i2c_async ? "on" : "off",
+		   isp_i2c_depth, isp_i2c_max_depth);
+	seq_printf(m, "queued %u, coalesced %u, applied %u, errors %u, sync flushes %u\n",
+		   isp_i2c_queued, isp_i2c_coalesced, isp_i2c_applied, isp_i2c_errors,
+		   isp_i2c_sync_flushes);
+	seq_printf(m, "write to apply latency: avg %llu us, max %llu us\n",
+		   isp_i2c_applied ? div_u64(div_u64(isp_i2c_latency_ns, isp_i2c_applied), 1000) : 0,
+		   div_u64(isp_i2c_max_latency_ns, 1000));
+	spin_unlock_irqrestore(&isp_i2c_lock, flags);
+	return 0;
+}
+
+static int isp_i2c_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, isp_i2c_show, PDE_DATA(inode), 1024);
+}
+
+static const struct file_operations isp_i2c_fops = {
+	.read = seq_read,
+	.open = isp_i2c_open,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+int isp_i2c_async_init(void)
+{
+	isp_i2c_worker = kthread_run(isp_i2c_thread, NULL, "isp-i2c");
+	if(IS_ERR(isp_i2c_worker)){
+		ISP_WARNING("Failed to start the isp i2c worker, writes stay synchronous\n");
+		isp_i2c_worker = NULL;
+		isp_i2c_async = 0;
+	}
+	if(isp_shim_proc && !proc_create_data("i2c", S_IRUGO, isp_shim_proc, &isp_i2c_fops, NULL))
+		ISP_WARNING("Failed to create the isp-shim i2c node\n");
+	return 0;
+}
+
+void isp_i2c_async_exit(void)
+{
+	if(isp_i2c_worker)
+		kthread_stop(isp_i2c_worker);
+	isp_i2c_worker = NULL;
+	mutex_lock(&isp_i2c_mutex);
+	isp_i2c_flush_locked();
+	mutex_unlock(&isp_i2c_mutex);
+}
@@ -10,18 +10,48 @@
 #include <linux/module.h>
 #include <linux/kernel.h>
 #include <linux/version.h>
+#include <tx-isp-debug.h>
 
 extern int tx_isp_init(void);
 extern void tx_isp_exit(void);
 
 static int __init tx_isp_module_init(void)
 {
-	return tx_isp_init();
+	int ret = 0;
+
+	ret = isp_shim_trace_init();
+	if(ret)
+		return ret;
+	ret = isp_alloc_init();
+	if(ret)
+		goto err_shim_trace;
+	ret = isp_i2c_async_init();
+	if(ret)
+		goto err_alloc;
+	/* the dma node goes away with the isp-shim directory */
+	ret = isp_dma_sync_init();
+	if(ret)
+		goto err_i2c_async;
+	ret = tx_isp_init();
+	if(ret)
+		goto err_i2c_async;
+	return 0;
+
+err_i2c_async:
+	isp_i2c_async_exit();
+err_alloc:
+	isp_alloc_exit();
+err_shim_trace:
+	isp_shim_trace_exit();
+	return ret;
 }
 
 static void __exit tx_isp_module_exit(void)
 {
 	tx_isp_exit();
+	isp_i2c_async_exit();
+	isp_alloc_exit();
+	isp_shim_trace_exit();
 }
 
 module_init(tx_isp_module_init);
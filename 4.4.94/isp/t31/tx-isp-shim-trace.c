@@ -0,0 +1,250 @@
+/*
+ * Call accounting of the private_* kernel interfaces.
+ *
+ * The isp core is a prebuilt library and these interfaces are the only
+ * kernel services it uses, so counting them is the only view we have of
+ * where its cpu time goes. Every record is attributed to the address that
+ * called the interface, which can be resolved with the firmware map.
+ *
+ * Enable with "shim_trace=1" or by writing it at runtime to
+ * /sys/module/<isp module>/parameters/shim_trace; any write to
+ * /proc/jz/isp-shim/trace clears the statistics. The directory is shared
+ * with the other reports of the kernel interfaces.
+ */
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/sched.h>
+#include <linux/percpu.h>
+#include <linux/slab.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <asm/div64.h>
+#include <jz_proc.h>
+#include <tx-isp-debug.h>
+
+int isp_shim_trace = 0;
+module_param_named(shim_trace, isp_shim_trace, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(shim_trace, "account the calls of isp core to the kernel");
+
+#define ISP_SHIM_HIST_NUMS	16	/* log2 buckets of us, the last one is open */
+#define ISP_SHIM_CALLERS	16	/* callers kept per interface */
+#define ISP_SHIM_LOCK_DEPTH	8	/* nested spinlocks tracked per cpu */
+
+struct isp_shim_caller {
+	void *addr;
+	unsigned int calls;
+	unsigned long long ns;
+};
+
+struct isp_shim_stat {
+	unsigned int calls;
+	unsigned long long bytes;
+	unsigned long long ns;
+	unsigned long long max_ns;
+	unsigned int hist[ISP_SHIM_HIST_NUMS];
+	struct isp_shim_caller callers[ISP_SHIM_CALLERS];
+	unsigned int others;		/* calls from callers that didn't fit */
+};
+
+struct isp_shim_held {
+	spinlock_t *lock;
+	void *caller;
+	unsigned long long start;
+};
+
+struct isp_shim_lock_stack {
+	struct isp_shim_held held[ISP_SHIM_LOCK_DEPTH];
+	int depth;
+};
+
+static const char *isp_shim_names[ISP_SHIM_CALL_NUMS] = {
+	[ISP_SHIM_I2C] = "i2c_transfer",
+	[ISP_SHIM_KMALLOC] = "kmalloc",
+	[ISP_SHIM_VMALLOC] = "vmalloc",
+	[ISP_SHIM_SPINLOCK] = "spinlock hold",
+	[ISP_SHIM_MUTEX] = "mutex wait",
+	[ISP_SHIM_COMPLETION] = "completion wait",
+	[ISP_SHIM_DMA_SYNC] = "dma sync",
+};
+
+static struct isp_shim_stat isp_shim_stats[ISP_SHIM_CALL_NUMS];
+static unsigned long long isp_shim_since;
+static DEFINE_RAW_SPINLOCK(isp_shim_stat_lock);
+static DEFINE_PER_CPU(struct isp_shim_lock_stack, isp_shim_locks);
+struct proc_dir_entry *isp_shim_proc;
+
+static inline unsigned int isp_shim_bucket(unsigned long long ns)
+{
+	unsigned int us = ns > 0xffffffffULL * 1000 ? 0xffffffff : div_u64(ns, 1000);
+	unsigned int bucket = fls(us);
+
+	return bucket < ISP_SHIM_HIST_NUMS ? bucket : ISP_SHIM_HIST_NUMS - 1;
+}
+
+static void isp_shim_record(enum isp_shim_call call, void *caller,
+			    unsigned long long ns, size_t bytes)
+{
+	struct isp_shim_stat *stat = &isp_shim_stats[call];
+	struct isp_shim_caller *c = NULL;
+	unsigned long flags = 0;
+	unsigned int slot = ((unsigned long)caller >> 2) % ISP_SHIM_CALLERS;
+	int i = 0;
+
+	raw_spin_lock_irqsave(&isp_shim_stat_lock, flags);
+	stat->calls++;
+	stat->bytes += bytes;
+	stat->ns += ns;
+	if(ns > stat->max_ns)
+		stat->max_ns = ns;
+	stat->hist[isp_shim_bucket(ns)]++;
+	for(i = 0; i < ISP_SHIM_CALLERS; i++){
+		c = &stat->callers[(slot + i) % ISP_SHIM_CALLERS];
+		if(c->addr == caller || c->addr == NULL)
+			break;
+	}
+	if(i < ISP_SHIM_CALLERS){
+		c->addr = caller;
+		c->calls++;
+		c->ns += ns;
+	}else
+		stat->others++;
+	raw_spin_unlock_irqrestore(&isp_shim_stat_lock, flags);
+}
+
+void isp_shim_trace_account(enum isp_shim_call call, void *caller,
+			    unsigned long long start, size_t bytes)
+{
+	isp_shim_record(call, caller, sched_clock() - start, bytes);
+}
+
+/* called with the lock taken and interrupts off */
+void isp_shim_trace_lock(spinlock_t *lock, void *caller)
+{
+	struct isp_shim_lock_stack *stack = this_cpu_ptr(&isp_shim_locks);
+	struct isp_shim_held *held = NULL;
+
+	if(stack->depth >= ISP_SHIM_LOCK_DEPTH)
+		return;
+	held = &stack->held[stack->depth++];
+	held->lock = lock;
+	held->caller = caller;
+	held->start = sched_clock();
+}
+
+/* called before the lock is released, interrupts are still off */
+void isp_shim_trace_unlock(spinlock_t *lock)
+{
+	struct isp_shim_lock_stack *stack = this_cpu_ptr(&isp_shim_locks);
+	struct isp_shim_held held;
+	int i = 0;
+
+	/* locks are mostly released in reverse order, look from the top */
+	for(i = stack->depth - 1; i >= 0; i--){
+		if(stack->held[i].lock == lock)
+			break;
+	}
+	if(i < 0)
+		return;
+	held = stack->held[i];
+	for(; i < stack->depth - 1; i++)
+		stack->held[i] = stack->held[i + 1];
+	stack->depth--;
+	isp_shim_record(ISP_SHIM_SPINLOCK, held.caller, sched_clock() - held.start, 0);
+}
+
+static int isp_shim_trace_show(struct seq_file *m, void *v)
+{
+	struct isp_shim_stat *stats = NULL;
+	struct isp_shim_stat *stat = NULL;
+	struct isp_shim_caller *c = NULL;
+	unsigned long long since = 0;
+	unsigned long flags = 0;
+	int i, j;
+
+	/* print from a copy, the stat lock keeps interrupts off */
+	stats = kmalloc(sizeof(isp_shim_stats), GFP_KERNEL);
+	if(!stats)
+		return -ENOMEM;
+	raw_spin_lock_irqsave(&isp_shim_stat_lock, flags);
+	memcpy(stats, isp_shim_stats, sizeof(isp_shim_stats));
+	since = isp_shim_since;
+	raw_spin_unlock_irqrestore(&isp_shim_stat_lock, flags);
+
+	seq_printf(m, "shim trace %s, %llu ms accounted\n", isp_shim_trace ? "on" : "off",
+		   div_u64(sched_clock() - since, 1000000));
+	for(i = 0; i < ISP_SHIM_CALL_NUMS; i++){
+		stat = &stats[i];
+		if(stat->calls == 0)
+			continue;
+		seq_printf(m, "\n%s: calls %u, bytes %llu, total %llu us, max %llu us\n",
+			   isp_shim_names[i], stat->calls, stat->bytes,
+			   div_u64(stat->ns, 1000), div_u64(stat->max_ns, 1000));
+		seq_printf(m, "  us %6s", "<1");
+		for(j = 1; j < ISP_SHIM_HIST_NUMS; j++)
+			seq_printf(m, " %6u", 1 << (j - 1));
+		seq_printf(m, "\n  n  %6u", stat->hist[0]);
+		for(j = 1; j < ISP_SHIM_HIST_NUMS; j++)
+			seq_printf(m, " %6u", stat->hist[j]);
+		seq_printf(m, "\n");
+		for(j = 0; j < ISP_SHIM_CALLERS; j++){
+			c = &stat->callers[j];
+			if(c->addr == NULL)
+				continue;
+			seq_printf(m, "  %pS: calls %u, total %llu us\n",
+				   c->addr, c->calls, div_u64(c->ns, 1000));
+		}
+		if(stat->others)
+			seq_printf(m, "  other callers: calls %u\n", stat->others);
+	}
+	kfree(stats);
+	return 0;
+}
+
+static int isp_shim_trace_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, isp_shim_trace_show, PDE_DATA(inode), 4096 * 4);
+}
+
+static ssize_t isp_shim_trace_write(struct file *file, const char __user *buffer,
+				    size_t count, loff_t *f_pos)
+{
+	unsigned long flags = 0;
+
+	raw_spin_lock_irqsave(&isp_shim_stat_lock, flags);
+	memset(isp_shim_stats, 0, sizeof(isp_shim_stats));
+	isp_shim_since = sched_clock();
+	raw_spin_unlock_irqrestore(&isp_shim_stat_lock, flags);
+	return count;
+}
+
+static const struct file_operations isp_shim_trace_fops = {
+	.read = seq_read,
+	.open = isp_shim_trace_open,
+	.llseek = seq_lseek,
+	.release = single_release,
+	.write = isp_shim_trace_write,
+};
+
+int isp_shim_trace_init(void)
+{
+	isp_shim_since = sched_clock();
+	isp_shim_proc = jz_proc_mkdir("isp-shim");
+	if(!isp_shim_proc){
+		ISP_WARNING("Failed to create the isp-shim proc directory\n");
+		return 0;
+	}
+	if(!proc_create_data("trace", S_IRUGO | S_IWUSR, isp_shim_proc, &isp_shim_trace_fops, NULL)){
+		ISP_WARNING("Failed to create the isp-shim trace node\n");
+		proc_remove(isp_shim_proc);
+		isp_shim_proc = NULL;
+	}
+	return 0;
+}
+
+void isp_shim_trace_exit(void)
+{
+	if(isp_shim_proc)
+		proc_remove(isp_shim_proc);
+	isp_shim_proc = NULL;
+}
@@ -198,6 +198,13 @@ int private_schedule_hrtimeout(ktime_t *ex, const enum hrtimer_mode mode);
 bool private_schedule_work(struct work_struct *work);
 void private_do_gettimeofday(struct timeval *tv);
 
+/* frame sync group interfaces, see tx-isp-fsync.c */
+int private_fsync_join(const char *name, int vinum, int master,
+		       int (*stream_on)(void *data), void *data);
+void private_fsync_leave(int vinum);
+int private_fsync_stream(int vinum);
+int private_fsync_stop(int vinum);
+
 /* isp driver interface */
 void private_get_isp_priv_mem(unsigned int *phyaddr, unsigned int *size);
 
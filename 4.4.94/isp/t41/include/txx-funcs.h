@@ -251,6 +251,13 @@ void private_do_gettimeofday(struct timeval *tv);
 void private_do_gettimeofday(struct timespec64 *ts);
 #endif
 
+/* frame sync group interfaces, see tx-isp-fsync.c */
+int private_fsync_join(const char *name, int vinum, int master,
+		       int (*stream_on)(void *data), void *data);
+void private_fsync_leave(int vinum);
+int private_fsync_stream(int vinum);
+int private_fsync_stop(int vinum);
+
 /* isp driver interface */
 void private_get_isp_priv_mem(unsigned int *phyaddr, unsigned int *size);
 
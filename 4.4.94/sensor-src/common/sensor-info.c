@@ -1,6 +1,8 @@
 #include <linux/proc_fs.h>
 #include <linux/slab.h>
+#include <linux/math64.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
 
 /* Per-sensor proc context for multi-sensor support */
 struct sensor_proc_ctx {
@@ -18,6 +20,9 @@ static ssize_t sensor_fps_max_read(struct file *file, char __user *buf, size_t c
 static ssize_t sensor_i2c_addr_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_width_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_height_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_stats_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_profile_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
+static ssize_t sensor_i2c_profile_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_rst_gpio_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_pwdn_gpio_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 static ssize_t sensor_boot_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
@@ -66,6 +71,17 @@ static const struct file_operations height_fops = {
 	.owner = THIS_MODULE,
 };
 
+static const struct file_operations i2c_stats_fops = {
+	.read = sensor_i2c_stats_read,
+	.owner = THIS_MODULE,
+};
+
+static const struct file_operations i2c_profile_fops = {
+	.read = sensor_i2c_profile_read,
+	.write = sensor_i2c_profile_write,
+	.owner = THIS_MODULE,
+};
+
 static const struct file_operations rst_gpio_fops = {
 	.read = sensor_rst_gpio_read,
 	.owner = THIS_MODULE,
@@ -142,6 +158,14 @@ void sensor_common_init(struct sensor_info *info) {
 	snprintf(path, sizeof(path), "%s/width", ctx->dir_path);
 	proc_create_data(path, 0444, NULL, &width_fops, ctx);
 
+	if (info->burst) {
+		snprintf(path, sizeof(path), "%s/i2c_stats", ctx->dir_path);
+		proc_create_data(path, 0444, NULL, &i2c_stats_fops, ctx);
+		snprintf(path, sizeof(path), "%s/i2c_profile", ctx->dir_path);
+		proc_create_data(path, 0644, NULL, &i2c_profile_fops, ctx);
+		sensor_profile_clear(info->burst);
+	}
+
 	snprintf(path, sizeof(path), "%s/rst_gpio", ctx->dir_path);
 	proc_create_data(path, 0444, NULL, &rst_gpio_fops, ctx);
 
@@ -260,6 +284,19 @@ static ssize_t sensor_height_read(struct file *file, char __user *buf, size_t co
 	return simple_read_from_buffer(buf, count, ppos, buffer, len);
 }
 
+static ssize_t sensor_i2c_stats_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+	struct sensor_burst *burst = ctx->info->burst;
+	char buffer[256];
+	int len = snprintf(buffer, sizeof(buffer),
+			   "last table: %u regs in %u transfers, %u us\ntotal: %u regs in %u transfers\n"
+			   "shadow: %u regs issued, %u suppressed, %u reads cached\n",
+			   burst->last_regs, burst->last_transfers, burst->last_us,
+			   burst->total_regs, burst->total_transfers,
+			   burst->shadow_issued, burst->shadow_suppressed, burst->shadow_hits);
+	return simple_read_from_buffer(buf, count, ppos, buffer, len);
+}
+
 static ssize_t sensor_rst_gpio_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
 	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
 	char buffer[32];
@@ -301,3 +338,55 @@ static ssize_t sensor_i2c_adapter_read(struct file *file, char __user *buf, size
 	int len = snprintf(buffer, sizeof(buffer), "%d\n", ctx->info->i2c_adapter);
 	return simple_read_from_buffer(buf, count, ppos, buffer, len);
 }
+
+/* frames are counted by the expo updates, the isp core sends one per frame */
+static ssize_t sensor_i2c_profile_read(struct file *file, char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+	struct sensor_burst *burst = ctx->info->burst;
+	struct sensor_op_stat *stat;
+	unsigned int writes = 0;
+	unsigned int frames = burst->ops[SENSOR_OP_EXPO].ops;
+	char *buffer;
+	ssize_t ret;
+	int len = 0;
+	int i, j;
+
+	buffer = kmalloc(2048, GFP_KERNEL);
+	if (!buffer)
+		return -ENOMEM;
+	len += scnprintf(buffer + len, 2048 - len, "%lld ms profiled\n",
+			 ktime_to_ms(ktime_sub(ktime_get(), burst->profile_since)));
+	len += scnprintf(buffer + len, 2048 - len, "%-6s %8s %8s %8s %10s %6s %7s %8s %8s\n",
+			 "op", "ops", "reads", "writes", "bytes", "errors", "retries", "avg us", "max us");
+	for (i = 0; i < SENSOR_OP_NUMS; i++) {
+		stat = &burst->ops[i];
+		writes += stat->writes;
+		len += scnprintf(buffer + len, 2048 - len, "%-6s %8u %8u %8u %10llu %6u %7u %8llu %8u\n",
+				 sensor_op_name(i), stat->ops, stat->reads, stat->writes, stat->bytes,
+				 stat->errors, stat->retries,
+				 stat->ops ? div_u64(stat->us, stat->ops) : 0, stat->max_us);
+	}
+	if (frames)
+		len += scnprintf(buffer + len, 2048 - len, "writes per frame: %u.%02u over %u frames\n",
+				 writes / frames, writes % frames * 100 / frames, frames);
+	len += scnprintf(buffer + len, 2048 - len, "\n%-6s %6s", "us", "<1");
+	for (j = 1; j < SENSOR_PROFILE_HIST; j++)
+		len += scnprintf(buffer + len, 2048 - len, " %6u", 1 << (j - 1));
+	for (i = 0; i < SENSOR_OP_NUMS; i++) {
+		len += scnprintf(buffer + len, 2048 - len, "\n%-6s", sensor_op_name(i));
+		for (j = 0; j < SENSOR_PROFILE_HIST; j++)
+			len += scnprintf(buffer + len, 2048 - len, " %6u", burst->ops[i].hist[j]);
+	}
+	len += scnprintf(buffer + len, 2048 - len, "\n");
+	ret = simple_read_from_buffer(buf, count, ppos, buffer, len);
+	kfree(buffer);
+	return ret;
+}
+
+/* any write starts the profile over */
+static ssize_t sensor_i2c_profile_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos) {
+	struct sensor_proc_ctx *ctx = PDE_DATA(file_inode(file));
+
+	sensor_profile_clear(ctx->info->burst);
+	return count;
+}
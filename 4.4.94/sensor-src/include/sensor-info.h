@@ -1,6 +1,8 @@
 #ifndef SENSOR_INFO_H
 #define SENSOR_INFO_H
 
+struct sensor_burst;
+
 struct sensor_info {
 	const char *name;
 	unsigned int chip_id;
@@ -16,6 +18,7 @@ struct sensor_info {
 	int mclk;             /* clock source (0=MCLK0, 1=MCLK1, 2=MCLK2) */
 	int video_interface;  /* 0=MIPI, 1=DVP */
 	int i2c_adapter;      /* I2C bus number */
+	struct sensor_burst *burst;  /* register table writes, may be NULL */
 	void *priv;           /* Private data for proc context */
 };
 
@@ -2375,6 +2375,9 @@ struct platform_device sensor_platform_device = {
 	.num_resources = 0,
 };
 
+/* group hold, launched by a second write to the same register */
+static const unsigned short sensor_fence_regs[] = { 0x3208 };
+
 static int sensor_probe(struct i2c_client *client,
 			 const struct i2c_device_id *id)
 {
@@ -2473,6 +2476,7 @@ static int sensor_probe(struct i2c_client *client,
 	tx_isp_set_subdevdata(sd, client);
 	tx_isp_set_subdev_hostdata(sd, sensor);
 	private_i2c_set_clientdata(client, sd);
+	private_i2c_set_fences(client, sensor_fence_regs, ARRAY_SIZE(sensor_fence_regs));
 
 	pr_debug("probe ok ------->%s\n", SENSOR_NAME);
 	return 0;
@@ -2494,6 +2498,7 @@ static int sensor_remove(struct i2c_client *client)
 
 	private_clk_disable(sensor->mclk);
 	private_clk_put(sensor->mclk);
+	private_i2c_set_fences(client, NULL, 0);
 	tx_isp_subdev_deinit(sd);
 	kfree(sensor);
 
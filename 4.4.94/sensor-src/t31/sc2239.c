@@ -844,6 +844,9 @@ struct platform_device sensor_platform_device = {
 	.num_resources = 0,
 };
 
+/* 0x3812 opens and closes the group hold */
+static const unsigned short sensor_fence_regs[] = { 0x3812 };
+
 static int sensor_probe(struct i2c_client *client, const struct i2c_device_id *id)
 {
 	struct tx_isp_subdev *sd;
@@ -902,6 +905,7 @@ static int sensor_probe(struct i2c_client *client, const struct i2c_device_id *i
 	tx_isp_set_subdevdata(sd, client);
 	tx_isp_set_subdev_hostdata(sd, sensor);
 	private_i2c_set_clientdata(client, sd);
+	private_i2c_set_fences(client, sensor_fence_regs, ARRAY_SIZE(sensor_fence_regs));
 
 	pr_debug("probe ok ------->%s\n", SENSOR_NAME);
 
@@ -928,6 +932,7 @@ static int sensor_remove(struct i2c_client *client)
 
 	private_clk_disable(sensor->mclk);
 	private_clk_put(sensor->mclk);
+	private_i2c_set_fences(client, NULL, 0);
 	tx_isp_subdev_deinit(sd);
 	kfree(sensor);
 
@@ -40,16 +40,10 @@
 #define SENSOR_OUTPUT_MIN_FPS 5
 #define SENSOR_VERSION "H20211222b"
 
-static int reset_gpio = GPIO_PC(27);
-static int pwdn_gpio = -1;
-
 static int sensor_gpio_func = DVP_PA_LOW_10BIT;
 module_param(sensor_gpio_func, int, S_IRUGO);
 MODULE_PARM_DESC(sensor_gpio_func, "Sensor GPIO function");
 
-static int data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
-static int sensor_max_fps = TX_SENSOR_MAX_FPS_30;
-
 static int shvflip = 0;
 module_param(shvflip, int, S_IRUGO);
 MODULE_PARM_DESC(shvflip, "Sensor HV Flip Enable interface");
@@ -101,13 +95,18 @@ struct again_lut sensor_again_lut[] = {
 	{0x1c, 0x0, 0xce, 0x3f, 0x3f, 444864},       //      110.515625
 };
 
-struct tx_isp_sensor_attribute sensor_attr;
+/* gc2053 and gc2053s1, see sensor_id */
+#define SENSOR_SLOTS 2
+
+/* the attribute of the sensor bound to each slot, NULL while it is free */
+static struct tx_isp_sensor_attribute *sensor_slot_attr[SENSOR_SLOTS];
 
-unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again)
+static unsigned int sensor_alloc_again_attr(struct tx_isp_sensor_attribute *attr,
+					    unsigned int isp_gain, unsigned int *sensor_again)
 {
 	struct again_lut *lut = sensor_again_lut;
 
-	while (lut->gain <= sensor_attr.max_again) {
+	while (lut->gain <= attr->max_again) {
 		if (isp_gain == 0) {
 			*sensor_again = lut[0].index;
 			return lut[0].gain;
@@ -115,7 +114,7 @@ unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsi
 			*sensor_again = (lut - 1)->index;
 			return (lut - 1)->gain;
 		} else {
-			if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
+			if ((lut->gain == attr->max_again) && (isp_gain >= lut->gain)) {
 				*sensor_again = lut->index;
 				return lut->gain;
 			}
@@ -127,6 +126,26 @@ unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsi
 	return isp_gain;
 }
 
+/*
+ * The isp calls the allocators without telling which sensor they are
+ * for, so every slot has its own entry point onto its own attribute.
+ */
+static unsigned int sensor_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again)
+{
+	return sensor_alloc_again_attr(sensor_slot_attr[0], isp_gain, sensor_again);
+}
+
+static unsigned int sensor_alloc_again_s1(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again)
+{
+	return sensor_alloc_again_attr(sensor_slot_attr[1], isp_gain, sensor_again);
+}
+
+static unsigned int (*const sensor_slot_alloc_again[SENSOR_SLOTS])(unsigned int, unsigned char, unsigned int *) = {
+	sensor_alloc_again,
+	sensor_alloc_again_s1,
+};
+
+/* no digital gain, the same for every slot */
 unsigned int sensor_alloc_dgain(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_dgain)
 {
 	return 0;
@@ -170,7 +189,7 @@ struct tx_isp_dvp_bus sensor_dvp = {
 	.dvp_hcomp_en = 0,
 };
 
-struct tx_isp_sensor_attribute sensor_attr = {
+static const struct tx_isp_sensor_attribute sensor_attr = {
 	.name = SENSOR_NAME,
 	.chip_id = 0x2053,
 	.cbus_type = SENSOR_BUS_TYPE,
@@ -1036,7 +1055,25 @@ static struct tx_isp_sensor_win_setting sensor_win_sizes[] = {
 	},
 };
 
-struct tx_isp_sensor_win_setting *wsize = &sensor_win_sizes[0];
+/*
+ * One of these per bound sensor; everything that used to be a global of
+ * the driver lives here, so a single module can drive every slot whose
+ * init tables are the same as gc2053's. sensor_attr above is only the
+ * template each instance starts from.
+ */
+struct sensor_instance {
+	struct tx_isp_sensor sensor;	/* first, see sd_to_instance() */
+	struct tx_isp_sensor_attribute attr;
+	struct tx_isp_sensor_win_setting *wsize;
+	struct platform_device pdev;
+	int data_interface;
+	int max_fps;
+	int reset_gpio;
+	int pwdn_gpio;
+	unsigned int slot;
+};
+
+#define sd_to_instance(sd) container_of(sd_to_sensor_device(sd), struct sensor_instance, sensor)
 
 /*
  * the part of driver was fixed.
@@ -1238,6 +1275,7 @@ static int sensor_get_black_pedestal(struct tx_isp_subdev *sd, int value)
 
 static int sensor_init(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 	int ret = 0;
 
@@ -1245,16 +1283,16 @@ static int sensor_init(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 		sensor->video.state = TX_ISP_MODULE_DEINIT;
 		return ISP_SUCCESS;
 	} else {
-		sensor->video.mbus.width = wsize->width;
-		sensor->video.mbus.height = wsize->height;
-		sensor->video.mbus.code = wsize->mbus_code;
+		sensor->video.mbus.width = inst->wsize->width;
+		sensor->video.mbus.height = inst->wsize->height;
+		sensor->video.mbus.code = inst->wsize->mbus_code;
 		sensor->video.mbus.field = TISP_FIELD_NONE;
-		sensor->video.mbus.colorspace = wsize->colorspace;
-		sensor->video.fps = wsize->fps;
+		sensor->video.mbus.colorspace = inst->wsize->colorspace;
+		sensor->video.fps = inst->wsize->fps;
 		sensor->video.state = TX_ISP_MODULE_DEINIT;
 
 		ret = tx_isp_call_subdev_notify(sd, TX_ISP_EVENT_SYNC_SENSOR_ATTR, &sensor->video);
-		sensor->priv = wsize;
+		sensor->priv = inst->wsize;
 	}
 
 	return 0;
@@ -1262,37 +1300,38 @@ static int sensor_init(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 
 static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 	int ret = 0;
 
 	if (init->enable) {
 		if (sensor->video.state == TX_ISP_MODULE_DEINIT) {
-			ret = sensor_write_array(sd, wsize->regs);
+			ret = sensor_write_array(sd, inst->wsize->regs);
 			if (ret)
 				return ret;
 			sensor->video.state = TX_ISP_MODULE_INIT;
 		}
 		if (sensor->video.state == TX_ISP_MODULE_INIT) {
-			if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
+			if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 				ret = sensor_write_array(sd, sensor_stream_on_dvp);
-			} else if (data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
+			} else if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
 				ret = sensor_write_array(sd, sensor_stream_on_mipi);
 			} else {
 				ISP_ERROR("Don't support this Sensor Data interface\n");
 			}
 			sensor->video.state = TX_ISP_MODULE_RUNNING;
-			pr_debug("%s stream on\n", SENSOR_NAME);
+			pr_debug("%s stream on\n", inst->attr.name);
 		}
 	} else {
-		if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
+		if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 			ret = sensor_write_array(sd, sensor_stream_off_dvp);
-		} else if (data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
+		} else if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
 			ret = sensor_write_array(sd, sensor_stream_off_mipi);
 		} else {
 			ISP_ERROR("Don't support this Sensor Data interface\n");
 		}
 		sensor->video.state = TX_ISP_MODULE_INIT;
-		pr_debug("%s stream off\n", SENSOR_NAME);
+		pr_debug("%s stream off\n", inst->attr.name);
 	}
 
 	return ret;
@@ -1300,6 +1339,7 @@ static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init
 
 static int sensor_set_fps(struct tx_isp_subdev *sd, int fps)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 	unsigned int wpclk = 0;
 	unsigned short vts = 0;
@@ -1309,19 +1349,19 @@ static int sensor_set_fps(struct tx_isp_subdev *sd, int fps)
 	unsigned int newformat = 0; //the format is 24.8
 	int ret = 0;
 
-	if ((data_interface == TX_SENSOR_DATA_INTERFACE_DVP) && (sensor_max_fps == TX_SENSOR_MAX_FPS_30)) {
+	if ((inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) && (inst->max_fps == TX_SENSOR_MAX_FPS_30)) {
 		max_fps = SENSOR_OUTPUT_MAX_FPS;
 		wpclk = SENSOR_SUPPORT_30FPS_DVP_SCLK;
-	} else if ((data_interface == TX_SENSOR_DATA_INTERFACE_DVP) && (sensor_max_fps == TX_SENSOR_MAX_FPS_15)) {
+	} else if ((inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) && (inst->max_fps == TX_SENSOR_MAX_FPS_15)) {
 		max_fps = TX_SENSOR_MAX_FPS_15;
 		wpclk = SENSOR_SUPPORT_15FPS_DVP_SCLK;
-	} else if ((data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (sensor_max_fps == TX_SENSOR_MAX_FPS_30)) {
+	} else if ((inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (inst->max_fps == TX_SENSOR_MAX_FPS_30)) {
 		max_fps = SENSOR_OUTPUT_MAX_FPS;
 		wpclk = SENSOR_SUPPORT_30FPS_MIPI_SCLK;
-	} else if ((data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (sensor_max_fps == TX_SENSOR_MAX_FPS_25)) {
+	} else if ((inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (inst->max_fps == TX_SENSOR_MAX_FPS_25)) {
 		max_fps = TX_SENSOR_MAX_FPS_25;
 		wpclk = SENSOR_SUPPORT_25FPS_MIPI_SCLK;
-	} else if ((data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (sensor_max_fps == TX_SENSOR_MAX_FPS_15)) {
+	} else if ((inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) && (inst->max_fps == TX_SENSOR_MAX_FPS_15)) {
 		max_fps = TX_SENSOR_MAX_FPS_15;
 		wpclk = SENSOR_SUPPORT_15FPS_MIPI_SCLK;
 	} else {
@@ -1382,16 +1422,17 @@ static int sensor_set_vflip(struct tx_isp_subdev *sd, int enable)
 
 static int sensor_set_mode(struct tx_isp_subdev *sd, int value)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 	int ret = ISP_SUCCESS;
 
-	if (wsize) {
-		sensor->video.mbus.width = wsize->width;
-		sensor->video.mbus.height = wsize->height;
-		sensor->video.mbus.code = wsize->mbus_code;
+	if (inst->wsize) {
+		sensor->video.mbus.width = inst->wsize->width;
+		sensor->video.mbus.height = inst->wsize->height;
+		sensor->video.mbus.code = inst->wsize->mbus_code;
 		sensor->video.mbus.field = TISP_FIELD_NONE;
-		sensor->video.mbus.colorspace = wsize->colorspace;
-		sensor->video.fps = wsize->fps;
+		sensor->video.mbus.colorspace = inst->wsize->colorspace;
+		sensor->video.fps = inst->wsize->fps;
 		ret = tx_isp_call_subdev_notify(sd, TX_ISP_EVENT_SYNC_SENSOR_ATTR, &sensor->video);
 	}
 
@@ -1400,6 +1441,7 @@ static int sensor_set_mode(struct tx_isp_subdev *sd, int value)
 
 static int sensor_attr_check(struct tx_isp_subdev *sd)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 	struct tx_isp_sensor_register_info *info = &sensor->info;
 	unsigned long rate;
@@ -1407,75 +1449,75 @@ static int sensor_attr_check(struct tx_isp_subdev *sd)
 
 	switch (info->default_boot) {
 		case 0:
-			wsize = &sensor_win_sizes[0];
-			sensor_attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
-			sensor_max_fps = TX_SENSOR_MAX_FPS_25;
+			inst->wsize = &sensor_win_sizes[0];
+			inst->attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
+			inst->max_fps = TX_SENSOR_MAX_FPS_25;
 			ret = set_sensor_gpio_function(sensor_gpio_func);
 			if (ret < 0)
 				goto err_set_sensor_gpio;
-			sensor_attr.dvp.gpio = sensor_gpio_func;
-			memcpy((void*)(&(sensor_attr.dvp)),(void*)(&sensor_dvp),sizeof(sensor_dvp));
-			sensor_attr.max_integration_time_native = 0x546 - 8;
-			sensor_attr.integration_time_limit = 0x546 - 8;
-			sensor_attr.total_width = 0x44c * 2;
-			sensor_attr.total_height = 0x546;
-			sensor_attr.max_integration_time = 0x546 - 8;
-			sensor_attr.one_line_expr_in_us = 29;
+			inst->attr.dvp.gpio = sensor_gpio_func;
+			memcpy((void*)(&(inst->attr.dvp)),(void*)(&sensor_dvp),sizeof(sensor_dvp));
+			inst->attr.max_integration_time_native = 0x546 - 8;
+			inst->attr.integration_time_limit = 0x546 - 8;
+			inst->attr.total_width = 0x44c * 2;
+			inst->attr.total_height = 0x546;
+			inst->attr.max_integration_time = 0x546 - 8;
+			inst->attr.one_line_expr_in_us = 29;
 			break;
 		case 1:
-			wsize = &sensor_win_sizes[1];
-			sensor_attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
-			sensor_max_fps = TX_SENSOR_MAX_FPS_15;
+			inst->wsize = &sensor_win_sizes[1];
+			inst->attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
+			inst->max_fps = TX_SENSOR_MAX_FPS_15;
 			ret = set_sensor_gpio_function(sensor_gpio_func);
 			if (ret < 0)
 				goto err_set_sensor_gpio;
-			sensor_attr.dvp.gpio = sensor_gpio_func;
-			memcpy((void*)(&(sensor_attr.dvp)),(void*)(&sensor_dvp),sizeof(sensor_dvp));
-			sensor_attr.max_integration_time_native = 0x465 - 8;
-			sensor_attr.integration_time_limit = 0x465 - 8;
-			sensor_attr.total_width = 0x44c * 2;
-			sensor_attr.total_height = 0x465;
-			sensor_attr.max_integration_time = 0x465 - 8;
-			sensor_attr.one_line_expr_in_us = 59;
+			inst->attr.dvp.gpio = sensor_gpio_func;
+			memcpy((void*)(&(inst->attr.dvp)),(void*)(&sensor_dvp),sizeof(sensor_dvp));
+			inst->attr.max_integration_time_native = 0x465 - 8;
+			inst->attr.integration_time_limit = 0x465 - 8;
+			inst->attr.total_width = 0x44c * 2;
+			inst->attr.total_height = 0x465;
+			inst->attr.max_integration_time = 0x465 - 8;
+			inst->attr.one_line_expr_in_us = 59;
 			break;
 		case 2:
-			wsize = &sensor_win_sizes[2];
-			sensor_attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
-			sensor_max_fps = TX_SENSOR_MAX_FPS_30;
-			memcpy((void*)(&(sensor_attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
-			sensor_attr.mipi.clk = 400;
-			sensor_attr.max_integration_time_native = 0x58a - 8;
-			sensor_attr.integration_time_limit = 0x58a - 8;
-			sensor_attr.total_width = 0x44c * 2;
-			sensor_attr.total_height = 0x58a;
-			sensor_attr.max_integration_time = 0x58a - 8;
-			sensor_attr.one_line_expr_in_us = 28;
+			inst->wsize = &sensor_win_sizes[2];
+			inst->attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
+			inst->max_fps = TX_SENSOR_MAX_FPS_30;
+			memcpy((void*)(&(inst->attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
+			inst->attr.mipi.clk = 400;
+			inst->attr.max_integration_time_native = 0x58a - 8;
+			inst->attr.integration_time_limit = 0x58a - 8;
+			inst->attr.total_width = 0x44c * 2;
+			inst->attr.total_height = 0x58a;
+			inst->attr.max_integration_time = 0x58a - 8;
+			inst->attr.one_line_expr_in_us = 28;
 			break;
 		case 3:
-			wsize = &sensor_win_sizes[3];
-			sensor_attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
-			sensor_max_fps = TX_SENSOR_MAX_FPS_25;
-			memcpy((void*)(&(sensor_attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
-			sensor_attr.mipi.clk = 400;
-			sensor_attr.max_integration_time_native = 0x51c - 8;
-			sensor_attr.integration_time_limit = 0x51c - 8;
-			sensor_attr.total_width = 0x44c * 2;
-			sensor_attr.total_height = 0x51c;
-			sensor_attr.max_integration_time = 0x51c - 8;
-			sensor_attr.one_line_expr_in_us = 31;
+			inst->wsize = &sensor_win_sizes[3];
+			inst->attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
+			inst->max_fps = TX_SENSOR_MAX_FPS_25;
+			memcpy((void*)(&(inst->attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
+			inst->attr.mipi.clk = 400;
+			inst->attr.max_integration_time_native = 0x51c - 8;
+			inst->attr.integration_time_limit = 0x51c - 8;
+			inst->attr.total_width = 0x44c * 2;
+			inst->attr.total_height = 0x51c;
+			inst->attr.max_integration_time = 0x51c - 8;
+			inst->attr.one_line_expr_in_us = 31;
 			break;
 		case 4:
-			wsize = &sensor_win_sizes[4];
-			sensor_attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
-			sensor_max_fps = TX_SENSOR_MAX_FPS_15;
-			memcpy((void*)(&(sensor_attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
-			sensor_attr.mipi.clk = 195;
-			sensor_attr.max_integration_time_native = 0x49d - 8;
-			sensor_attr.integration_time_limit = 0x49d - 8;
-			sensor_attr.total_width = 0x44c * 2;
-			sensor_attr.total_height = 0x49d;
-			sensor_attr.max_integration_time = 0x49d - 8;
-			sensor_attr.one_line_expr_in_us = 57;
+			inst->wsize = &sensor_win_sizes[4];
+			inst->attr.data_type = TX_SENSOR_DATA_TYPE_LINEAR;
+			inst->max_fps = TX_SENSOR_MAX_FPS_15;
+			memcpy((void*)(&(inst->attr.mipi)),(void*)(&sensor_mipi),sizeof(sensor_mipi));
+			inst->attr.mipi.clk = 195;
+			inst->attr.max_integration_time_native = 0x49d - 8;
+			inst->attr.integration_time_limit = 0x49d - 8;
+			inst->attr.total_width = 0x44c * 2;
+			inst->attr.total_height = 0x49d;
+			inst->attr.max_integration_time = 0x49d - 8;
+			inst->attr.one_line_expr_in_us = 57;
 			break;
 		default:
 			ISP_ERROR("this init boot is not supported yet!!!\n");
@@ -1483,18 +1525,18 @@ static int sensor_attr_check(struct tx_isp_subdev *sd)
 
 	switch (info->video_interface) {
 		case TISP_SENSOR_VI_MIPI_CSI0:
-			sensor_attr.dbus_type = TX_SENSOR_DATA_INTERFACE_MIPI;
-			data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
-			sensor_attr.mipi.index = 0;
+			inst->attr.dbus_type = TX_SENSOR_DATA_INTERFACE_MIPI;
+			inst->data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
+			inst->attr.mipi.index = 0;
 			break;
 		case TISP_SENSOR_VI_MIPI_CSI1:
-			sensor_attr.dbus_type = TX_SENSOR_DATA_INTERFACE_MIPI;
-			data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
-			sensor_attr.mipi.index = 1;
+			inst->attr.dbus_type = TX_SENSOR_DATA_INTERFACE_MIPI;
+			inst->data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
+			inst->attr.mipi.index = 1;
 			break;
 		case TISP_SENSOR_VI_DVP:
-			sensor_attr.dbus_type = TX_SENSOR_DATA_INTERFACE_DVP;
-			data_interface = TX_SENSOR_DATA_INTERFACE_DVP;
+			inst->attr.dbus_type = TX_SENSOR_DATA_INTERFACE_DVP;
+			inst->data_interface = TX_SENSOR_DATA_INTERFACE_DVP;
 			break;
 		default:
 			ISP_ERROR("this data interface is not supported yet!!!\n");
@@ -1525,8 +1567,8 @@ static int sensor_attr_check(struct tx_isp_subdev *sd)
 	private_clk_set_rate(sensor->mclk, 24000000);
 	private_clk_prepare_enable(sensor->mclk);
 
-	reset_gpio = info->rst_gpio;
-	pwdn_gpio = info->pwdn_gpio;
+	inst->reset_gpio = info->rst_gpio;
+	inst->pwdn_gpio = info->pwdn_gpio;
 
 	return 0;
 
@@ -1537,48 +1579,49 @@ err_get_mclk:
 
 static int sensor_g_chip_ident(struct tx_isp_subdev *sd, struct tx_isp_chip_ident *chip)
 {
+	struct sensor_instance *inst = sd_to_instance(sd);
 	struct i2c_client *client = tx_isp_get_subdevdata(sd);
 	unsigned int ident = 0;
 	int ret = ISP_SUCCESS;
 
 	sensor_attr_check(sd);
-	if (reset_gpio != -1) {
-		ret = private_gpio_request(reset_gpio,"sensor_reset");
+	if (inst->reset_gpio != -1) {
+		ret = private_gpio_request(inst->reset_gpio,"sensor_reset");
 		if (!ret) {
-			private_gpio_direction_output(reset_gpio, 1);
+			private_gpio_direction_output(inst->reset_gpio, 1);
 			private_msleep(20);
-			private_gpio_direction_output(reset_gpio, 0);
+			private_gpio_direction_output(inst->reset_gpio, 0);
 			private_msleep(20);
-			private_gpio_direction_output(reset_gpio, 1);
+			private_gpio_direction_output(inst->reset_gpio, 1);
 			private_msleep(10);
 		} else {
-			ISP_ERROR("gpio request fail %d\n",reset_gpio);
+			ISP_ERROR("gpio request fail %d\n",inst->reset_gpio);
 		}
 	}
-	if (pwdn_gpio != -1) {
-		ret = private_gpio_request(pwdn_gpio,"sensor_pwdn");
+	if (inst->pwdn_gpio != -1) {
+		ret = private_gpio_request(inst->pwdn_gpio,"sensor_pwdn");
 		if (!ret) {
-			private_gpio_direction_output(pwdn_gpio, 1);
+			private_gpio_direction_output(inst->pwdn_gpio, 1);
 			private_msleep(10);
-			private_gpio_direction_output(pwdn_gpio, 0);
+			private_gpio_direction_output(inst->pwdn_gpio, 0);
 			private_msleep(10);
-			private_gpio_direction_output(pwdn_gpio, 1);
+			private_gpio_direction_output(inst->pwdn_gpio, 1);
 			private_msleep(10);
 		} else {
-			ISP_ERROR("gpio request fail %d\n",pwdn_gpio);
+			ISP_ERROR("gpio request fail %d\n",inst->pwdn_gpio);
 		}
 	}
 	ret = sensor_detect(sd, &ident);
 	if (ret) {
 		ISP_ERROR("chip found @ 0x%x (%s) is not an %s chip.\n",
-			  client->addr, client->adapter->name, SENSOR_NAME);
+			  client->addr, client->adapter->name, inst->attr.name);
 		return ret;
 	}
 	ISP_WARNING("%s chip found @ 0x%02x (%s)\n",
-		    SENSOR_NAME, client->addr, client->adapter->name);
+		    inst->attr.name, client->addr, client->adapter->name);
 	ISP_WARNING("sensor driver version %s\n", SENSOR_VERSION);
 	if (chip) {
-		memcpy(chip->name, SENSOR_NAME, sizeof(SENSOR_NAME));
+		strlcpy(chip->name, inst->attr.name, sizeof(chip->name));
 		chip->ident = ident;
 		chip->revision = SENSOR_VERSION;
 	}
@@ -1588,6 +1631,7 @@ static int sensor_g_chip_ident(struct tx_isp_subdev *sd, struct tx_isp_chip_iden
 
 static int sensor_sensor_ops_ioctl(struct tx_isp_subdev *sd, unsigned int cmd, void *arg)
 {
+	struct sensor_instance *inst;
 	long ret = 0;
 	struct tx_isp_sensor_value *sensor_val = arg;
 
@@ -1595,6 +1639,7 @@ static int sensor_sensor_ops_ioctl(struct tx_isp_subdev *sd, unsigned int cmd, v
 		ISP_ERROR("[%d]The pointer is invalid!\n", __LINE__);
 		return -EINVAL;
 	}
+	inst = sd_to_instance(sd);
 	switch(cmd) {
 		case TX_ISP_EVENT_SENSOR_EXPO:
 			if (arg)
@@ -1621,18 +1666,18 @@ static int sensor_sensor_ops_ioctl(struct tx_isp_subdev *sd, unsigned int cmd, v
 				ret = sensor_set_mode(sd, sensor_val->value);
 			break;
 		case TX_ISP_EVENT_SENSOR_PREPARE_CHANGE:
-			if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
+			if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 				ret = sensor_write_array(sd, sensor_stream_off_dvp);
-			} else if (data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
+			} else if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
 				ret = sensor_write_array(sd, sensor_stream_off_mipi);
 			} else {
 				ISP_ERROR("Don't support this Sensor Data interface\n");
 			}
 			break;
 		case TX_ISP_EVENT_SENSOR_FINISH_CHANGE:
-			if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
+			if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 				ret = sensor_write_array(sd, sensor_stream_on_dvp);
-			} else if (data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
+			} else if (inst->data_interface == TX_SENSOR_DATA_INTERFACE_MIPI) {
 				ret = sensor_write_array(sd, sensor_stream_on_mipi);
 			} else {
 				ISP_ERROR("Don't support this Sensor Data interface\n");
@@ -1711,51 +1756,63 @@ static struct tx_isp_subdev_ops sensor_ops = {
 	.sensor = &sensor_sensor_ops,
 };
 
-/* It's the sensor device */
 static u64 tx_isp_module_dma_mask = ~(u64)0;
-struct platform_device sensor_platform_device = {
-	.name = SENSOR_NAME,
-	.id = -1,
-	.dev = {
-		.dma_mask = &tx_isp_module_dma_mask,
-		.coherent_dma_mask = 0xffffffff,
-		.platform_data = NULL,
-	},
-	.num_resources = 0,
-};
 
 static int sensor_probe(struct i2c_client *client, const struct i2c_device_id *id)
 {
+	struct sensor_instance *inst;
 	struct tx_isp_subdev *sd;
 	struct tx_isp_video_in *video;
 	struct tx_isp_sensor *sensor;
+	unsigned long slot = id->driver_data;
 
-	sensor = (struct tx_isp_sensor *)kzalloc(sizeof(*sensor), GFP_KERNEL);
-	if (!sensor) {
+	if (sensor_slot_attr[slot]) {
+		ISP_ERROR("%s is bound already\n", id->name);
+		return -EBUSY;
+	}
+	inst = kzalloc(sizeof(*inst), GFP_KERNEL);
+	if (!inst) {
 		ISP_ERROR("Failed to allocate sensor subdev.\n");
 		return -ENOMEM;
 	}
-	memset(sensor, 0 ,sizeof(*sensor));
-	sensor_attr.expo_fs = 1;
+	inst->attr = sensor_attr;
+	inst->attr.name = id->name;
+	inst->attr.expo_fs = 1;
+	inst->attr.sensor_ctrl.alloc_again = sensor_slot_alloc_again[slot];
+	inst->slot = slot;
+	inst->wsize = &sensor_win_sizes[0];
+	inst->data_interface = TX_SENSOR_DATA_INTERFACE_MIPI;
+	inst->max_fps = TX_SENSOR_MAX_FPS_30;
+	inst->reset_gpio = -1;
+	inst->pwdn_gpio = -1;
+
+	/* It's the sensor device, one per slot so each gets its own isp module */
+	inst->pdev.name = id->name;
+	inst->pdev.id = -1;
+	inst->pdev.dev.dma_mask = &tx_isp_module_dma_mask;
+	inst->pdev.dev.coherent_dma_mask = 0xffffffff;
+
+	sensor = &inst->sensor;
 	sd = &sensor->sd;
 	video = &sensor->video;
 	sensor->video.shvflip = shvflip;
-	sensor->video.attr = &sensor_attr;
+	sensor->video.attr = &inst->attr;
 	sensor->dev = &client->dev;
-	sensor->video.vi_max_width = wsize->width;
-	sensor->video.vi_max_height = wsize->height;
-	sensor->video.mbus.width = wsize->width;
-	sensor->video.mbus.height = wsize->height;
-	sensor->video.mbus.code = wsize->mbus_code;
+	sensor->video.vi_max_width = inst->wsize->width;
+	sensor->video.vi_max_height = inst->wsize->height;
+	sensor->video.mbus.width = inst->wsize->width;
+	sensor->video.mbus.height = inst->wsize->height;
+	sensor->video.mbus.code = inst->wsize->mbus_code;
 	sensor->video.mbus.field = TISP_FIELD_NONE;
-	sensor->video.mbus.colorspace = wsize->colorspace;
-	sensor->video.fps = wsize->fps;
-	tx_isp_subdev_init(&sensor_platform_device, sd, &sensor_ops);
+	sensor->video.mbus.colorspace = inst->wsize->colorspace;
+	sensor->video.fps = inst->wsize->fps;
+	sensor_slot_attr[slot] = &inst->attr;
+	tx_isp_subdev_init(&inst->pdev, sd, &sensor_ops);
 	tx_isp_set_subdevdata(sd, client);
 	tx_isp_set_subdev_hostdata(sd, sensor);
 	private_i2c_set_clientdata(client, sd);
 
-	pr_debug("probe ok ------->%s\n", SENSOR_NAME);
+	pr_debug("probe ok ------->%s\n", id->name);
 
 	return 0;
 }
@@ -1764,22 +1821,30 @@ static int sensor_remove(struct i2c_client *client)
 {
 	struct tx_isp_subdev *sd = private_i2c_get_clientdata(client);
 	struct tx_isp_sensor *sensor = tx_isp_get_subdev_hostdata(sd);
+	struct sensor_instance *inst = sd_to_instance(sd);
 
-	if (reset_gpio != -1)
-		private_gpio_free(reset_gpio);
-	if (pwdn_gpio != -1)
-		private_gpio_free(pwdn_gpio);
+	if (inst->reset_gpio != -1)
+		private_gpio_free(inst->reset_gpio);
+	if (inst->pwdn_gpio != -1)
+		private_gpio_free(inst->pwdn_gpio);
 
 	private_clk_disable_unprepare(sensor->mclk);
 	tx_isp_subdev_deinit(sd);
+	sensor_slot_attr[inst->slot] = NULL;
 
-	kfree(sensor);
+	kfree(inst);
 
 	return 0;
 }
 
+/*
+ * The slots of a multi sensor board served by this driver, driver_data is
+ * the slot. gc2053s2 and gc2053s3 have init tables of their own and keep
+ * their drivers.
+ */
 static const struct i2c_device_id sensor_id[] = {
 	{ SENSOR_NAME, 0 },
+	{ SENSOR_NAME "s1", 1 },
 	{ }
 };
 MODULE_DEVICE_TABLE(i2c, sensor_id);
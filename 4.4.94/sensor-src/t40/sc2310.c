@@ -35,6 +35,11 @@
 #define SENSOR_OUTPUT_MAX_FPS 30
 #define SENSOR_OUTPUT_MIN_FPS 5
 #define SENSOR_VERSION "H20181031a"
+#define SENSOR_VINUM 0
+
+#define SENSOR_FSYNC_NONE 0
+#define SENSOR_FSYNC_MASTER 1
+#define SENSOR_FSYNC_SLAVE 2
 
 static int reset_gpio = GPIO_PC(28);
 module_param(reset_gpio, int, S_IRUGO);
@@ -60,6 +65,10 @@ static int sensor_max_fps = TX_SENSOR_MAX_FPS_25;
 module_param(sensor_max_fps, int, S_IRUGO);
 MODULE_PARM_DESC(sensor_max_fps, "Sensor Max Fps set interface");
 
+static int fsync_role = SENSOR_FSYNC_NONE;
+module_param(fsync_role, int, S_IRUGO);
+MODULE_PARM_DESC(fsync_role, "Frame sync group role, 0 none, 1 master, 2 slave");
+
 struct regval_list {
 	uint16_t reg_num;
 	unsigned char value;
@@ -790,6 +799,25 @@ static struct regval_list sensor_stream_off_mipi[] = {
 	{SENSOR_REG_END, 0x00},
 };
 
+/*
+ * The init table leaves the sensor streaming in external trigger mode.
+ * In a frame sync group the stream waits for the group, and the master
+ * drops the trigger mode to drive the FSYNC pin for the slaves.
+ */
+static struct regval_list sensor_fsync_master[] = {
+	{0x0100, 0x00},
+	{0x3222, 0x00},
+	{0x300a, 0x24},
+	{0x3230, 0x00},//fsync pulse width
+	{0x3231, 0x10},
+	{SENSOR_REG_END, 0x00},
+};
+
+static struct regval_list sensor_fsync_slave[] = {
+	{0x0100, 0x00},
+	{SENSOR_REG_END, 0x00},
+};
+
 int sensor_read(struct tx_isp_subdev *sd, uint16_t reg,	unsigned char *value)
 {
 	struct i2c_client *client = tx_isp_get_subdevdata(sd);
@@ -872,6 +900,22 @@ static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals
 	return 0;
 }
 
+static int sensor_fsync_stream_on(void *data)
+{
+	struct tx_isp_subdev *sd = data;
+	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
+	int ret;
+
+	if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP)
+		ret = sensor_write_array(sd, sensor_stream_on_dvp);
+	else
+		ret = sensor_write_array(sd, sensor_stream_on_mipi);
+	if (!ret)
+		sensor->video.state = TX_ISP_MODULE_RUNNING;
+
+	return ret;
+}
+
 static int sensor_reset(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 {
 	return 0;
@@ -1022,16 +1066,27 @@ static int sensor_init(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
 {
 	int ret = 0;
+	int fsync_ret = 0;
     struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 
 	if (init->enable) {
 		if (sensor->video.state == TX_ISP_MODULE_DEINIT) {
 			ret = sensor_write_array(sd, wsize->regs);
+			if (ret)
+				return ret;
+			if (fsync_role == SENSOR_FSYNC_MASTER)
+				ret = sensor_write_array(sd, sensor_fsync_master);
+			else if (fsync_role == SENSOR_FSYNC_SLAVE)
+				ret = sensor_write_array(sd, sensor_fsync_slave);
 			if (ret)
 				return ret;
 			sensor->video.state = TX_ISP_MODULE_INIT;
 		}
-		if (sensor->video.state == TX_ISP_MODULE_INIT) {
+		if (fsync_role) {
+			/* started by the group, maybe later together with the others */
+			if (sensor->video.state == TX_ISP_MODULE_INIT)
+				ret = private_fsync_stream(SENSOR_VINUM);
+		} else if (sensor->video.state == TX_ISP_MODULE_INIT) {
 			if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 			sensor->video.state = TX_ISP_MODULE_RUNNING;
 				ret = sensor_write_array(sd, sensor_stream_on_dvp);
@@ -1048,6 +1103,12 @@ static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init
 
 	}
 	else {
+		if (fsync_role) {
+			/* a start of the group that failed for us is reported here */
+			fsync_ret = private_fsync_stop(SENSOR_VINUM);
+			if (sensor->video.state == TX_ISP_MODULE_RUNNING)
+				sensor->video.state = TX_ISP_MODULE_INIT;
+		}
 		if (data_interface == TX_SENSOR_DATA_INTERFACE_DVP) {
 			ret = sensor_write_array(sd, sensor_stream_off_dvp);
 		sensor->video.state = TX_ISP_MODULE_DEINIT;
@@ -1059,6 +1120,8 @@ static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init
 		sensor->video.state = TX_ISP_MODULE_DEINIT;
 		}
 		ISP_WARNING("%s stream off\n", SENSOR_NAME);
+		if (!ret)
+			ret = fsync_ret;
 	}
 
 	return ret;
@@ -1419,6 +1482,16 @@ static int sensor_probe(struct i2c_client *client, const struct i2c_device_id *i
 	tx_isp_set_subdev_hostdata(sd, sensor);
 	private_i2c_set_clientdata(client, sd);
 
+	if (fsync_role) {
+		sensor_attr.sensor_fsync_mode = TX_SENSOR_FSYNC_MSLAVE_MODE;
+		if (private_fsync_join(SENSOR_NAME, SENSOR_VINUM, fsync_role == SENSOR_FSYNC_MASTER,
+				       sensor_fsync_stream_on, sd)) {
+			ISP_ERROR("%s streams on its own\n", SENSOR_NAME);
+			sensor_attr.sensor_fsync_mode = TX_SENSOR_FSYNC_SLAVE_MODE;
+			fsync_role = SENSOR_FSYNC_NONE;
+		}
+	}
+
 	pr_debug("probe ok ------->%s\n", SENSOR_NAME);
 
 	return 0;
@@ -1429,6 +1502,8 @@ static int sensor_remove(struct i2c_client *client)
 	struct tx_isp_subdev *sd = private_i2c_get_clientdata(client);
 	struct tx_isp_sensor *sensor = tx_isp_get_subdev_hostdata(sd);
 
+	if (fsync_role)
+		private_fsync_leave(SENSOR_VINUM);
 	if (reset_gpio != -1)
 		private_gpio_free(reset_gpio);
 	if (pwdn_gpio != -1)
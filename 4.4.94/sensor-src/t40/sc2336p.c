@@ -20,6 +20,7 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <txx-funcs.h>
+#include <sensor-core.h>
 
 #define SENSOR_NAME "sc2336p"
 // ============================================================================
@@ -559,21 +560,37 @@ static int sensor_read_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 }
 #endif
 
+static struct regval_list sensor_group_hold_begin[] = {
+	{0x3812, 0x00},
+	{SENSOR_REG_END, 0x00},
+};
+
+static struct regval_list sensor_group_hold_end[] = {
+	{0x3812, 0x30},
+	{SENSOR_REG_END, 0x00},
+};
+
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 2,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+	.barriers = { 0x0103, 0x0100 },	/* reset, stream on */
+	.barrier_nums = 2,
+	.hold_begin = (struct sensor_regval *)sensor_group_hold_begin,
+	.hold_end = (struct sensor_regval *)sensor_group_hold_end,
+};
+
 static int sensor_write_array(struct tx_isp_subdev *sd, struct regval_list *vals)
 {
-	int ret;
-	while (vals->reg_num != SENSOR_REG_END) {
-		if (vals->reg_num == SENSOR_REG_DELAY) {
-			private_msleep(vals->value);
-		} else {
-			ret = sensor_write(sd, vals->reg_num, vals->value);
-			if (ret < 0)
-				return ret;
-		}
-		vals++;
-	}
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	return sensor_burst_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
+}
 
-	return 0;
+static int sensor_write_group(struct tx_isp_subdev *sd, struct regval_list *vals)
+{
+	return sensor_group_write_array(tx_isp_get_subdevdata(sd), &sensor_burst,
+					(struct sensor_regval *)vals);
 }
 
 static int sensor_reset(struct tx_isp_subdev *sd, struct tx_isp_initarg *init)
@@ -616,13 +633,16 @@ static int sensor_set_expo(struct tx_isp_subdev *sd, int value)
 	int ret = 0;
 	int it = (value & 0xffff);
 	int again = (value & 0xffff0000) >> 16;
+	struct regval_list vals[] = {
+		{0x3e00, (unsigned char)((it >> 12) & 0xf)},
+		{0x3e01, (unsigned char)((it >> 4) & 0xff)},
+		{0x3e02, (unsigned char)((it & 0x0f) << 4)},
+		{0x3e07, (unsigned char)(again & 0xff)},
+		{0x3e09, (unsigned char)(((again >> 8) & 0xff))},
+		{SENSOR_REG_END, 0x00},
+	};
 
-	ret += sensor_write(sd, 0x3e00, (unsigned char)((it >> 12) & 0xf));
-	ret += sensor_write(sd, 0x3e01, (unsigned char)((it >> 4) & 0xff));
-	ret += sensor_write(sd, 0x3e02, (unsigned char)((it & 0x0f) << 4));
-	ret = sensor_write(sd, 0x3e07, (unsigned char)(again & 0xff));
-	ret += sensor_write(sd, 0x3e09, (unsigned char)(((again >> 8) & 0xff)));
-
+	ret = sensor_write_group(sd, vals);
 	if (ret < 0)
 		return ret;
 
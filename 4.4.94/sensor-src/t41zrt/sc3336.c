@@ -16,6 +16,8 @@
 #include <tx-isp-common.h>
 #include <sensor-common.h>
 #include <sensor-info.h>
+#include <sensor-core.h>
+#include <fast_start_common.h>
 #include <txx-funcs.h>
 
 /* 定义SENSOR_WITHOUT_INIT时表示boot阶段已进行sensor初始化，下sensor初始化配置，可节省初始化sensor时间。*/
@@ -550,6 +552,32 @@ static struct tx_isp_sensor_win_setting sensor_win_sizes[] = {
 };
 struct tx_isp_sensor_win_setting *wsize = &sensor_win_sizes[0];
 
+#ifdef SENSOR_WITHOUT_INIT
+/* the boot stage setup is only adopted when the chip id and this signature match wsize */
+static struct sensor_burst sensor_burst = {
+	.reg_bytes = 2,
+	.reg_end = SENSOR_REG_END,
+	.reg_delay = SENSOR_REG_DELAY,
+};
+
+static const struct sensor_regval sensor_handoff_id[] = {
+	{0x3107, SENSOR_CHIP_ID_H},
+	{0x3108, SENSOR_CHIP_ID_L},
+	{SENSOR_REG_END, 0x00},
+};
+
+/* setting id, pll and stream on; vts is left out, the boot stage may have changed the fps */
+static const uint16_t sensor_handoff_sig[] = {
+	0x301f, 0x36e9, 0x37f9, 0x0100,
+};
+
+static struct sensor_handoff sensor_handoff = {
+	.id = sensor_handoff_id,
+	.sig = sensor_handoff_sig,
+	.sig_nums = ARRAY_SIZE(sensor_handoff_sig),
+};
+#endif
+
 /*
  * the part of driver was fixed.
  */
@@ -773,17 +801,39 @@ static int sensor_init(struct tx_isp_subdev *sd, struct tx_isp_initarg *init) {
 	return 0;
 }
 
+#ifdef SENSOR_WITHOUT_INIT
+/* write the init table unless the sensor set up by the boot stage already runs it */
+static int sensor_handoff_init(struct tx_isp_subdev *sd) {
+	struct i2c_client *client = tx_isp_get_subdevdata(sd);
+
+	BUILD_BUG_ON(sizeof(struct regval_list) != sizeof(struct sensor_regval));
+	if (!sensor_handoff_check(client, &sensor_burst, &sensor_handoff,
+				  (const struct sensor_regval *)wsize->regs)) {
+		ISP_WARNING("%s: boot setup doesn't match %dx%d, writing the init table\n",
+			    SENSOR_NAME, wsize->width, wsize->height);
+		return sensor_write_array(sd, wsize->regs);
+	}
+	DEBUG_TTFF("sensor handoff");
+	ISP_WARNING("%s: adopted from boot, %u regs and %u ms skipped, about %u us saved (check %u us)\n",
+		    SENSOR_NAME, sensor_handoff.skipped_regs, sensor_handoff.skipped_ms,
+		    sensor_handoff.saved_us, sensor_handoff.check_us);
+	return 0;
+}
+#endif
+
 static int sensor_s_stream(struct tx_isp_subdev *sd, struct tx_isp_initarg *init) {
 	int ret = 0;
 	struct tx_isp_sensor *sensor = sd_to_sensor_device(sd);
 
 	if (init->enable) {
 		if (sensor->video.state == TX_ISP_MODULE_DEINIT) {
-#ifndef SENSOR_WITHOUT_INIT
+#ifdef SENSOR_WITHOUT_INIT
+			ret = sensor_handoff_init(sd);
+#else
 			ret = sensor_write_array(sd, wsize->regs);
-			if (ret)
 #endif
-			return ret;
+			if (ret)
+				return ret;
 			sensor->video.state = TX_ISP_MODULE_INIT;
 		}
 		if (sensor->video.state == TX_ISP_MODULE_INIT) {
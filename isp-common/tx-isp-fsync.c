@@ -0,0 +1,551 @@
+/*
+ * Frame sync groups of multi sensor rigs.
+ *
+ * Every sensor driver turns its stream on by itself whenever the isp gets
+ * to it, so the sensors of a stereo or dual lens rig run at the same rate
+ * but in whatever phase they happened to start in. A driver that is part
+ * of such a rig joins the group with private_fsync_join(), as the master
+ * that drives the FSYNC line or as a slave in external trigger mode, and
+ * leaves turning the stream on to private_fsync_stream(). The streams are
+ * held back until every member asked for one, or for "fsync_hold_ms", and
+ * are then turned on in one go, the slaves first so they are armed for the
+ * first pulse of the master. A member that comes back while the others
+ * are running is started right away, the master pulse keeps it in phase.
+ * A stream that fails to start for another member, or after the hold ran
+ * out, fails the next private_fsync_stream() or private_fsync_stop() of
+ * its own member, so the driver sees it on its next s_stream.
+ *
+ * The skew is measured on the interrupts of the vic of every sensor,
+ * "fsync_vic_irq" gives them in vinum order and /proc/jz/isp-fsync/group
+ * lists the isp interrupts seen so far to find them. The vic interrupts
+ * more than once per frame, so the skew of a slave is the distance of each
+ * of its interrupts to the closest one of the master; that is the frame
+ * skew as long as the sensors are less than half a period apart. Any
+ * write to the node clears the statistics.
+ *
+ * Built into the T40 and T41 isp modules, their Kbuild lists this file.
+ */
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/version.h>
+#include <linux/sched.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
+#include <linux/sched/clock.h>
+#endif
+#include <linux/interrupt.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <linux/math64.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <jz_proc.h>
+#include <txx-funcs.h>
+
+#define ISP_FSYNC_MEMBERS	4	/* one sensor per vic input */
+#define ISP_FSYNC_IRQ_NUMS	8
+#define ISP_FSYNC_HIST_NUMS	12	/* log2 buckets of us, the last one is open */
+
+static int isp_fsync_hold_ms = 1000;
+module_param_named(fsync_hold_ms, isp_fsync_hold_ms, int, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(fsync_hold_ms, "longest wait for the rest of the group before streaming");
+
+static int isp_fsync_vic_irq[ISP_FSYNC_MEMBERS] = {-1, -1, -1, -1};
+static int isp_fsync_vic_irq_nums;
+module_param_array_named(fsync_vic_irq, isp_fsync_vic_irq, int, &isp_fsync_vic_irq_nums, S_IRUGO);
+MODULE_PARM_DESC(fsync_vic_irq, "vic interrupt of each vinum, to measure the skew");
+
+struct isp_fsync_member {
+	const char *name;		/* NULL when the slot is free */
+	int master;
+	int (*stream_on)(void *data);
+	void *data;
+	bool armed;			/* asked to stream, not started yet */
+	bool running;
+	int error;			/* stream on failed, not reported yet */
+	/* frame clock, from the vic interrupt */
+	unsigned long long last;
+	unsigned long long period;
+	unsigned int events;
+	/* distance to the master, slaves only */
+	long long skew;
+	long long skew_min;
+	long long skew_max;
+	unsigned long long skew_abs;
+	unsigned int skews;
+	unsigned int hist[ISP_FSYNC_HIST_NUMS];
+};
+
+struct isp_fsync_irq {
+	unsigned int irq;
+	irq_handler_t handler;
+	irq_handler_t thread_fn;
+	void *dev_id;
+	const char *devname;
+	int vinum;
+	unsigned int count;
+};
+
+static struct isp_fsync_member isp_fsync_members[ISP_FSYNC_MEMBERS];
+static struct isp_fsync_irq isp_fsync_irqs[ISP_FSYNC_IRQ_NUMS];
+static unsigned long long isp_fsync_spread;	/* ns between the first and last stream on */
+static unsigned int isp_fsync_starts;
+/* the frame clock is written from the interrupts, membership under both */
+static DEFINE_RAW_SPINLOCK(isp_fsync_lock);
+static DEFINE_MUTEX(isp_fsync_mutex);
+static struct proc_dir_entry *isp_fsync_proc;
+
+static void isp_fsync_hold_timeout(struct work_struct *work);
+static DECLARE_DELAYED_WORK(isp_fsync_hold_work, isp_fsync_hold_timeout);
+
+static inline unsigned int isp_fsync_bucket(unsigned long long ns)
+{
+	unsigned int us = ns > 0xffffffffULL * 1000 ? 0xffffffff : div_u64(ns, 1000);
+	unsigned int bucket = fls(us);
+
+	return bucket < ISP_FSYNC_HIST_NUMS ? bucket : ISP_FSYNC_HIST_NUMS - 1;
+}
+
+static struct isp_fsync_member *isp_fsync_master(void)
+{
+	int i = 0;
+
+	for(i = 0; i < ISP_FSYNC_MEMBERS; i++){
+		if(isp_fsync_members[i].name && isp_fsync_members[i].master)
+			return &isp_fsync_members[i];
+	}
+	return NULL;
+}
+
+static void isp_fsync_clear(struct isp_fsync_member *member)
+{
+	member->last = 0;
+	member->period = 0;
+	member->events = 0;
+	member->skew = 0;
+	member->skew_min = 0;
+	member->skew_max = 0;
+	member->skew_abs = 0;
+	member->skews = 0;
+	memset(member->hist, 0, sizeof(member->hist));
+}
+
+/* called with isp_fsync_lock held */
+static void isp_fsync_frame(int vinum, unsigned long long now)
+{
+	struct isp_fsync_member *member = &isp_fsync_members[vinum];
+	struct isp_fsync_member *master = NULL;
+	long long period = 0;
+	long long skew = 0;
+
+	if(member->name == NULL || !member->running)
+		return;
+	if(member->last)
+		member->period = now - member->last;
+	member->last = now;
+	member->events++;
+	if(member->master)
+		return;
+
+	/* nothing to compare with until the master runs */
+	master = isp_fsync_master();
+	if(master == NULL || !master->running || master->period == 0)
+		return;
+	period = master->period;
+	skew = now - master->last;
+	if(skew < 0 || skew > 2 * period)
+		return;
+	if(2 * skew > period)
+		skew -= period;
+
+	if(member->skews == 0 || skew < member->skew_min)
+		member->skew_min = skew;
+	if(member->skews == 0 || skew > member->skew_max)
+		member->skew_max = skew;
+	member->skew = skew;
+	member->skew_abs += skew < 0 ? -skew : skew;
+	member->skews++;
+	member->hist[isp_fsync_bucket(skew < 0 ? -skew : skew)]++;
+}
+
+/*
+ * Start every held stream, called with isp_fsync_mutex held. Returns the
+ * error of the stream of vinum, the others keep theirs for their driver.
+ */
+static int isp_fsync_start_locked(int vinum)
+{
+	struct isp_fsync_member *member = NULL;
+	unsigned long long first = 0;
+	unsigned long long now = 0;
+	unsigned long flags = 0;
+	int started = 0;
+	int master = 0;
+	int ret = 0;
+	int err = 0;
+	int i = 0;
+
+	/* slaves first, they have to wait for the first pulse of the master */
+	for(master = 0; master < 2; master++){
+		for(i = 0; i < ISP_FSYNC_MEMBERS; i++){
+			member = &isp_fsync_members[i];
+			if(member->name == NULL || !member->armed || member->master != master)
+				continue;
+			err = member->stream_on(member->data);
+			now = sched_clock();
+			raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+			member->armed = false;
+			member->running = err == 0;
+			isp_fsync_clear(member);
+			raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+			if(err){
+				ISP_ERROR("%s: stream on failed, %d\n", member->name, err);
+				if(i == vinum)
+					ret = err;
+				else
+					member->error = err;
+				continue;
+			}
+			if(started++ == 0)
+				first = now;
+		}
+	}
+	if(started > 1){
+		isp_fsync_spread = now - first;
+		isp_fsync_starts++;
+		ISP_WARNING("fsync: %d sensors streaming, stream on spread %llu us\n",
+			    started, div_u64(isp_fsync_spread, 1000));
+	}
+	return ret;
+}
+
+static void isp_fsync_hold_timeout(struct work_struct *work)
+{
+	mutex_lock(&isp_fsync_mutex);
+	ISP_WARNING("fsync: the group is incomplete after %d ms, streaming without the rest\n",
+		    isp_fsync_hold_ms);
+	isp_fsync_start_locked(-1);
+	mutex_unlock(&isp_fsync_mutex);
+}
+
+int private_fsync_join(const char *name, int vinum, int master,
+		       int (*stream_on)(void *data), void *data)
+{
+	struct isp_fsync_member *member = NULL;
+	unsigned long flags = 0;
+	int ret = 0;
+
+	if(vinum < 0 || vinum >= ISP_FSYNC_MEMBERS || name == NULL || stream_on == NULL)
+		return -EINVAL;
+
+	mutex_lock(&isp_fsync_mutex);
+	member = &isp_fsync_members[vinum];
+	if(member->name){
+		ISP_ERROR("vinum %d is taken by %s\n", vinum, member->name);
+		ret = -EBUSY;
+	}else if(master && isp_fsync_master()){
+		ISP_ERROR("%s is already the master of the group\n", isp_fsync_master()->name);
+		ret = -EBUSY;
+	}else{
+		raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+		memset(member, 0, sizeof(*member));
+		member->name = name;
+		member->master = !!master;
+		member->stream_on = stream_on;
+		member->data = data;
+		raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+		ISP_WARNING("fsync: %s joins as the %s of vinum %d\n",
+			    name, master ? "master" : "slave", vinum);
+	}
+	mutex_unlock(&isp_fsync_mutex);
+	return ret;
+}
+EXPORT_SYMBOL(private_fsync_join);
+
+void private_fsync_leave(int vinum)
+{
+	unsigned long flags = 0;
+
+	if(vinum < 0 || vinum >= ISP_FSYNC_MEMBERS)
+		return;
+	mutex_lock(&isp_fsync_mutex);
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	memset(&isp_fsync_members[vinum], 0, sizeof(isp_fsync_members[vinum]));
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	mutex_unlock(&isp_fsync_mutex);
+}
+EXPORT_SYMBOL(private_fsync_leave);
+
+/*
+ * Ask for the stream of a member to be turned on. Returns 0 when it was
+ * started or is held for the rest of the group, the error of stream_on
+ * otherwise. A failed start the member was not told about yet is
+ * returned instead, the next call tries again.
+ */
+int private_fsync_stream(int vinum)
+{
+	struct isp_fsync_member *member = NULL;
+	bool running = false;
+	bool waiting = false;
+	int ret = 0;
+	int i = 0;
+
+	if(vinum < 0 || vinum >= ISP_FSYNC_MEMBERS)
+		return -EINVAL;
+
+	mutex_lock(&isp_fsync_mutex);
+	if(isp_fsync_members[vinum].name == NULL){
+		ret = -ENODEV;
+		goto unlock;
+	}
+	if(isp_fsync_members[vinum].error){
+		ret = isp_fsync_members[vinum].error;
+		isp_fsync_members[vinum].error = 0;
+		goto unlock;
+	}
+	isp_fsync_members[vinum].armed = true;
+	for(i = 0; i < ISP_FSYNC_MEMBERS; i++){
+		member = &isp_fsync_members[i];
+		if(member->name == NULL)
+			continue;
+		if(member->running)
+			running = true;
+		else if(!member->armed)
+			waiting = true;
+	}
+	if(running || !waiting){
+		cancel_delayed_work(&isp_fsync_hold_work);
+		ret = isp_fsync_start_locked(vinum);
+	}else{
+		schedule_delayed_work(&isp_fsync_hold_work, msecs_to_jiffies(isp_fsync_hold_ms));
+	}
+unlock:
+	mutex_unlock(&isp_fsync_mutex);
+	return ret;
+}
+EXPORT_SYMBOL(private_fsync_stream);
+
+/*
+ * The stream of a member was turned off. Returns a failed start the member
+ * was not told about yet, 0 otherwise.
+ */
+int private_fsync_stop(int vinum)
+{
+	unsigned long flags = 0;
+	int ret = 0;
+
+	if(vinum < 0 || vinum >= ISP_FSYNC_MEMBERS)
+		return -EINVAL;
+	mutex_lock(&isp_fsync_mutex);
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	isp_fsync_members[vinum].armed = false;
+	isp_fsync_members[vinum].running = false;
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	ret = isp_fsync_members[vinum].error;
+	isp_fsync_members[vinum].error = 0;
+	mutex_unlock(&isp_fsync_mutex);
+	return ret;
+}
+EXPORT_SYMBOL(private_fsync_stop);
+
+static irqreturn_t isp_fsync_irq_handler(int irq, void *data)
+{
+	struct isp_fsync_irq *entry = data;
+	unsigned long flags = 0;
+
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	entry->count++;
+	if(entry->vinum >= 0)
+		isp_fsync_frame(entry->vinum, sched_clock());
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	return entry->handler(irq, entry->dev_id);
+}
+
+static irqreturn_t isp_fsync_irq_thread(int irq, void *data)
+{
+	struct isp_fsync_irq *entry = data;
+
+	return entry->thread_fn(irq, entry->dev_id);
+}
+
+/*
+ * The interrupts of the isp core are seen through a small wrapper, that
+ * is where the frame clock of every vic comes from.
+ */
+int isp_fsync_request_irq(unsigned int irq, irq_handler_t handler,
+			  irq_handler_t thread_fn, unsigned long irqflags,
+			  const char *devname, void *dev_id)
+{
+	struct isp_fsync_irq *entry = NULL;
+	unsigned long flags = 0;
+	int ret = 0;
+	int i = 0;
+
+	if(handler == NULL)
+		return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	for(i = 0; i < ISP_FSYNC_IRQ_NUMS; i++){
+		if(isp_fsync_irqs[i].handler == NULL){
+			entry = &isp_fsync_irqs[i];
+			entry->irq = irq;
+			entry->handler = handler;
+			entry->thread_fn = thread_fn;
+			entry->dev_id = dev_id;
+			entry->devname = devname;
+			entry->count = 0;
+			break;
+		}
+	}
+	if(entry){
+		entry->vinum = -1;
+		for(i = 0; i < isp_fsync_vic_irq_nums; i++){
+			if(isp_fsync_vic_irq[i] == (int)irq)
+				entry->vinum = i;
+		}
+	}
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	if(entry == NULL)
+		return request_threaded_irq(irq, handler, thread_fn, irqflags, devname, dev_id);
+
+	ret = request_threaded_irq(irq, isp_fsync_irq_handler, thread_fn ? isp_fsync_irq_thread : NULL,
+				   irqflags, devname, entry);
+	if(ret)
+		entry->handler = NULL;
+	return ret;
+}
+
+void isp_fsync_free_irq(unsigned int irq, void *dev_id)
+{
+	struct isp_fsync_irq *entry = NULL;
+	unsigned long flags = 0;
+	int i = 0;
+
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	for(i = 0; i < ISP_FSYNC_IRQ_NUMS; i++){
+		if(isp_fsync_irqs[i].handler && isp_fsync_irqs[i].irq == irq
+		   && isp_fsync_irqs[i].dev_id == dev_id){
+			entry = &isp_fsync_irqs[i];
+			break;
+		}
+	}
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	if(entry == NULL){
+		free_irq(irq, dev_id);
+		return;
+	}
+	/* the entry is in use until free_irq has waited for the handler */
+	free_irq(irq, entry);
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	entry->handler = NULL;
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+}
+
+static int isp_fsync_show(struct seq_file *m, void *v)
+{
+	struct isp_fsync_member *member = NULL;
+	struct isp_fsync_irq *entry = NULL;
+	unsigned long flags = 0;
+	int i, j;
+
+	mutex_lock(&isp_fsync_mutex);
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	seq_printf(m, "hold %d ms, %u group starts, last stream on spread %llu us\n",
+		   isp_fsync_hold_ms, isp_fsync_starts, div_u64(isp_fsync_spread, 1000));
+	for(i = 0; i < ISP_FSYNC_MEMBERS; i++){
+		member = &isp_fsync_members[i];
+		if(member->name == NULL)
+			continue;
+		seq_printf(m, "\nvinum %d %s: %s, %s, %u interrupts, period %llu us\n",
+			   i, member->name, member->master ? "master" : "slave",
+			   member->running ? "running" : member->armed ? "held" :
+			   member->error ? "failed" : "stopped",
+			   member->events, div_u64(member->period, 1000));
+		if(member->master || member->skews == 0)
+			continue;
+		seq_printf(m, "  skew us: last %lld, min %lld, max %lld, avg abs %llu\n",
+			   div_s64(member->skew, 1000), div_s64(member->skew_min, 1000),
+			   div_s64(member->skew_max, 1000),
+			   div_u64(div_u64(member->skew_abs, member->skews), 1000));
+		seq_printf(m, "  us %6s", "<1");
+		for(j = 1; j < ISP_FSYNC_HIST_NUMS; j++)
+			seq_printf(m, " %6u", 1 << (j - 1));
+		seq_printf(m, "\n  n  %6u", member->hist[0]);
+		for(j = 1; j < ISP_FSYNC_HIST_NUMS; j++)
+			seq_printf(m, " %6u", member->hist[j]);
+		seq_printf(m, "\n");
+	}
+	seq_printf(m, "\ninterrupts:\n");
+	for(i = 0; i < ISP_FSYNC_IRQ_NUMS; i++){
+		entry = &isp_fsync_irqs[i];
+		if(entry->handler == NULL)
+			continue;
+		seq_printf(m, "  irq %u %s: %u", entry->irq, entry->devname, entry->count);
+		if(entry->vinum >= 0)
+			seq_printf(m, ", vic of vinum %d", entry->vinum);
+		seq_printf(m, "\n");
+	}
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	mutex_unlock(&isp_fsync_mutex);
+	return 0;
+}
+
+static int isp_fsync_open(struct inode *inode, struct file *file)
+{
+	return single_open_size(file, isp_fsync_show, NULL, 4096);
+}
+
+static ssize_t isp_fsync_write(struct file *file, const char __user *buffer,
+			       size_t count, loff_t *f_pos)
+{
+	unsigned long flags = 0;
+	int i = 0;
+
+	raw_spin_lock_irqsave(&isp_fsync_lock, flags);
+	for(i = 0; i < ISP_FSYNC_MEMBERS; i++)
+		isp_fsync_clear(&isp_fsync_members[i]);
+	for(i = 0; i < ISP_FSYNC_IRQ_NUMS; i++)
+		isp_fsync_irqs[i].count = 0;
+	raw_spin_unlock_irqrestore(&isp_fsync_lock, flags);
+	return count;
+}
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 6, 0)
+static const struct proc_ops isp_fsync_fops = {
+	.proc_read = seq_read,
+	.proc_open = isp_fsync_open,
+	.proc_lseek = seq_lseek,
+	.proc_release = single_release,
+	.proc_write = isp_fsync_write,
+};
+#else
+static const struct file_operations isp_fsync_fops = {
+	.read = seq_read,
+	.open = isp_fsync_open,
+	.llseek = seq_lseek,
+	.release = single_release,
+	.write = isp_fsync_write,
+};
+#endif
+
+int isp_fsync_init(void)
+{
+	isp_fsync_proc = jz_proc_mkdir("isp-fsync");
+	if(!isp_fsync_proc){
+		ISP_WARNING("Failed to create the isp-fsync proc directory\n");
+		return 0;
+	}
+	if(!proc_create_data("group", S_IRUGO | S_IWUSR, isp_fsync_proc, &isp_fsync_fops, NULL)){
+		ISP_WARNING("Failed to create the isp-fsync group node\n");
+		proc_remove(isp_fsync_proc);
+		isp_fsync_proc = NULL;
+	}
+	return 0;
+}
+
+void isp_fsync_exit(void)
+{
+	cancel_delayed_work_sync(&isp_fsync_hold_work);
+	if(isp_fsync_proc)
+		proc_remove(isp_fsync_proc);
+	isp_fsync_proc = NULL;
+}
@@ -0,0 +1,229 @@
+#!/bin/sh
+#
+# Pack the regval_list tables of a sensor driver for
+# sensor_burst_write_packed(), see sensor-core.h for the format.
+#
+#   pack_regvals.sh driver.c > driver-packed.h
+#
+# Every "struct regval_list name[] = {...}" of the driver becomes a
+# "name_packed[]" byte array, tables built on the stack inside functions
+# are left alone. The register width is taken from the
+# SENSOR_REG_END define of the driver, 0xff for 8 bit addresses.
+
+[ $# -eq 1 ] || { echo "usage: $0 driver.c" >&2; exit 1; }
+
+awk -v src="$(basename "$1")" '
+function num(s,    i, c, v) {
+	s = tolower(s)
+	if (s ~ /^0x/) {
+		v = 0
+		for (i = 3; i <= length(s); i++) {
+			c = index("0123456789abcdef", substr(s, i, 1))
+			if (c == 0)
+				break
+			v = v * 16 + c - 1
+		}
+		return v
+	}
+	return s + 0
+}
+
+function emit(b) {
+	line = line sprintf("0x%02x, ", b)
+	if (++nbytes % 12 == 0) {
+		sub(/ $/, "", line)
+		print "\t" line
+		line = ""
+	}
+}
+
+function flush(    i) {
+	if (runlen == 0)
+		return
+	emit(runlen - 1)
+	for (i = 0; i < runlen; i++)
+		emit(vals[i])
+	cur = runstart + runlen
+	runlen = 0
+}
+
+function setaddr(reg,    d) {
+	d = reg - cur
+	if (cur >= 0 && d == 0)
+		return
+	if (cur >= 0 && d > 0 && d <= 64) {
+		emit(64 + d - 1)
+		return
+	}
+	emit(128)
+	if (regbytes == 2)
+		emit(int(reg / 256))
+	emit(reg % 256)
+}
+
+BEGIN {
+	regbytes = 2
+	print "/* Generated by tools/pack_regvals.sh from " src ", do not edit */"
+}
+
+{
+	sub(/\r$/, "")
+}
+
+/^#define[ \t]+[A-Za-z0-9_]*REG_END[ \t]/ {
+	if (regend != "" && num(regend) != num($3))
+		fail($2 " is defined as both " regend " and " $3)
+	endname[$2] = 1
+	regend = $3
+	regbytes = num(regend) > 255 ? 2 : 1
+}
+
+/^#define[ \t]+[A-Za-z0-9_]*REG_DELAY[ \t]/ {
+	if (regdelay != "" && num(regdelay) != num($3))
+		fail($2 " is defined as both " regdelay " and " $3)
+	delayname[$2] = 1
+	regdelay = $3
+}
+
+/^(static[ \t]+)?struct[ \t]+regval_list[ \t]+[A-Za-z0-9_]+[ \t]*\[\][^;]*=[ \t]*\{/ {
+	name = $0
+	sub(/^.*regval_list[ \t]+/, "", name)
+	sub(/[ \t]*\[.*$/, "", name)
+	intable = 1
+	ended = 0
+	cur = -1
+	runlen = 0
+	nbytes = 0
+	line = ""
+	print ""
+	print "static const unsigned char " name "_packed[] __maybe_unused = {"
+	next
+}
+
+# the text of a line without its comments, a "/*" left open carries over
+function uncomment(s,    out, i, j, k) {
+	out = ""
+	if (incomment) {
+		j = index(s, "*/")
+		if (j == 0)
+			return ""
+		s = substr(s, j + 2)
+		incomment = 0
+	}
+	while (s != "") {
+		i = index(s, "/*")
+		k = index(s, "//")
+		if (k && (i == 0 || k < i))
+			return out substr(s, 1, k - 1)
+		if (i == 0)
+			return out s
+		out = out substr(s, 1, i - 1) " "
+		s = substr(s, i + 2)
+		j = index(s, "*/")
+		if (j == 0) {
+			incomment = 1
+			return out
+		}
+		s = substr(s, j + 2)
+	}
+	return out
+}
+
+function fail(msg) {
+	printf("%s:%d: %s%s\n", FILENAME, FNR, intable ? name ": " : "", msg) > "/dev/stderr"
+	failed = 1
+}
+
+function isnum(s) {
+	return s ~ /^(0[xX][0-9a-fA-F]+|[0-9]+)$/
+}
+
+function entry(e,    n, f, reg, val) {
+	sub(/,[ \t]*$/, "", e)
+	n = split(e, f, /,/)
+	gsub(/^[ \t]+|[ \t]+$/, "", f[1])
+	gsub(/^[ \t]+|[ \t]+$/, "", f[2])
+	if (n != 2) {
+		fail("entry {" e "} is not {reg, value}")
+		return
+	}
+	if (ended)
+		return
+	if (f[1] in endname || (regend != "" && isnum(f[1]) && num(f[1]) == num(regend))) {
+		flush()
+		ended = 1
+		return
+	}
+	if (!isnum(f[2])) {
+		fail("value \"" f[2] "\" is not a number")
+		return
+	}
+	val = num(f[2])
+	if (val > 255) {
+		fail("value " f[2] " does not fit a byte")
+		return
+	}
+	if (f[1] in delayname || (regdelay != "" && isnum(f[1]) && num(f[1]) == num(regdelay))) {
+		flush()
+		emit(129)
+		emit(val)
+		return
+	}
+	if (!isnum(f[1])) {
+		fail("register \"" f[1] "\" is not a number")
+		return
+	}
+	reg = num(f[1])
+	if (reg >= (regbytes == 2 ? 65536 : 256)) {
+		fail("register " f[1] " is wider than " regbytes " byte(s)")
+		return
+	}
+	if (runlen > 0 && reg == runstart + runlen && runlen < 64) {
+		vals[runlen++] = val
+		return
+	}
+	flush()
+	setaddr(reg)
+	cur = reg
+	runstart = reg
+	vals[0] = val
+	runlen = 1
+}
+
+intable && !incomment && /^[ \t]*#/ {
+	fail("preprocessor line inside the table")
+	next
+}
+
+intable {
+	t = uncomment($0)
+	while (match(t, /\{[^{}]*\}/)) {
+		if (substr(t, 1, RSTART - 1) !~ /^[ \t,]*$/)
+			fail("cannot parse \"" substr(t, 1, RSTART - 1) "\"")
+		entry(substr(t, RSTART + 1, RLENGTH - 2))
+		t = substr(t, RSTART + RLENGTH)
+	}
+	if (t ~ /^[ \t,]*$/)
+		next
+	if (t !~ /^[ \t,]*\}[ \t]*;[ \t]*$/) {
+		fail("cannot parse \"" t "\"")
+		next
+	}
+	if (!ended)
+		fail("no SENSOR_REG_END")
+	flush()
+	emit(255)
+	if (line != "") {
+		sub(/ $/, "", line)
+		print "\t" line
+	}
+	print "};"
+	intable = 0
+}
+
+END {
+	if (intable)
+		fail("table is not closed")
+	exit failed
+}
+' "$1"
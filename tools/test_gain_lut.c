@@ -0,0 +1,191 @@
+/*
+ * Host check of sensor_gain_lut_find(), see test_gain_lut.sh.
+ *
+ * Built once per converted driver. gain_lut.h is generated from the tree
+ * and holds sensor_gain_lut_find(), the driver's LUT, its max gains and
+ * its sensor_alloc_again*(). The walks below are the ones the drivers had
+ * before, copied as they were; both must hand out the same register
+ * value and the same gain for every gain tried.
+ */
+#include <stdio.h>
+#include <stddef.h>
+#include <limits.h>
+
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+#define BUILD_BUG_ON_ZERO(e)	((int)(sizeof(struct { int:(-!!(e)); })))
+
+struct sensor_attr {
+	unsigned int max_again;
+	unsigned int max_again_short;
+};
+
+#include "gain_lut.h"
+
+#if defined(DRV_gc2053)
+static unsigned int walk_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
+	struct again_lut *lut = sensor_again_lut;
+	while (lut->gain <= sensor_attr.max_again) {
+		if (isp_gain == 0) {
+			*sensor_again = lut[0].index;
+			return lut[0].gain;
+		} else if (isp_gain < lut->gain) {
+			*sensor_again = (lut - 1)->index;
+			return (lut - 1)->gain;
+		} else {
+			if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
+				*sensor_again = lut->index;
+				return lut->gain;
+			}
+		}
+		lut++;
+	}
+	return isp_gain;
+}
+#elif defined(DRV_gc2093)
+static unsigned int walk_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
+	struct again_lut *lut = sensor_again_lut;
+	while (lut->gain <= sensor_attr.max_again) {
+		if (isp_gain == 0) {
+			*sensor_again = 0;
+			return lut[0].gain;
+		} else if (isp_gain < lut->gain) {
+			*sensor_again = (lut - 1)->index;
+			return (lut - 1)->gain;
+		} else {
+			if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
+				*sensor_again = lut->index;
+				return lut->gain;
+			}
+		}
+		lut++;
+	}
+	return 0;
+}
+
+#define HAS_SHORT
+static unsigned int walk_alloc_again_short(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again) {
+	struct again_lut *lut = sensor_again_lut;
+	while (lut->gain <= sensor_attr.max_again_short) {
+		if (isp_gain == 0) {
+			*sensor_again = 0;
+			return 0;
+		} else if (isp_gain < lut->gain) {
+			*sensor_again = (lut - 1)->gain;
+			return (lut - 1)->gain;
+		} else {
+			if ((lut->gain == sensor_attr.max_again_short) && (isp_gain >= lut->gain)) {
+				*sensor_again = lut->index;
+				return lut->gain;
+			}
+		}
+		lut++;
+	}
+	return isp_gain;
+}
+#elif defined(DRV_sc2336)
+static unsigned int walk_alloc_again(unsigned int isp_gain, unsigned char shift, unsigned int *sensor_again)
+{
+    struct again_lut *lut = sensor_again_lut;
+    while (lut->gain <= sensor_attr.max_again) {
+        if (isp_gain == 0) {
+            *sensor_again = lut[0].value;
+            return 0;
+        } else if (isp_gain < lut->gain) {
+            *sensor_again = (lut - 1)->value;
+            return (lut - 1)->gain;
+        } else {
+            if ((lut->gain == sensor_attr.max_again) && (isp_gain >= lut->gain)) {
+                *sensor_again = lut->value;
+                return lut->gain;
+            }
+        }
+
+        lut++;
+    }
+    return isp_gain;
+}
+#else
+#error "no walk for this driver"
+#endif
+
+typedef unsigned int (*alloc_fn)(unsigned int, unsigned char, unsigned int *);
+
+static const char *drv;
+static int checks;
+static int failures;
+
+static void check_gain(const char *what, alloc_fn walk, alloc_fn find, unsigned int isp_gain)
+{
+	unsigned int walk_again = 0xdeadbeef, find_again = 0xdeadbeef;
+	unsigned int walk_ret, find_ret;
+
+	walk_ret = walk(isp_gain, 0, &walk_again);
+	find_ret = find(isp_gain, 0, &find_again);
+	checks++;
+	if (walk_ret != find_ret || walk_again != find_again) {
+		failures++;
+		printf("%s %s(%u): walk %u/0x%x, search %u/0x%x\n", drv, what, isp_gain,
+		       walk_ret, walk_again, find_ret, find_again);
+	}
+}
+
+/*
+ * The walk stops at the first entry above max_gain or at the one equal to
+ * it, so the table must hold one of those or the walk reads past its end.
+ */
+static int check_table(const char *what, unsigned int max_gain)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(sensor_again_lut); i++) {
+		if (i && sensor_again_lut[i].gain < sensor_again_lut[i - 1].gain
+		    && sensor_again_lut[i].gain <= max_gain) {
+			printf("%s %s: entry %u is not ascending\n", drv, what, i);
+			return -1;
+		}
+		if (sensor_again_lut[i].gain >= max_gain)
+			return 0;
+	}
+	printf("%s %s: no entry reaches max gain %u\n", drv, what, max_gain);
+	return -1;
+}
+
+static void check_alloc(const char *what, alloc_fn walk, alloc_fn find, unsigned int max_gain)
+{
+	unsigned int nums = ARRAY_SIZE(sensor_again_lut);
+	unsigned int g, next;
+	unsigned int i;
+
+	if (check_table(what, max_gain)) {
+		failures++;
+		return;
+	}
+	check_gain(what, walk, find, 0);
+	check_gain(what, walk, find, 1);
+	check_gain(what, walk, find, max_gain - 1);
+	check_gain(what, walk, find, max_gain);
+	check_gain(what, walk, find, max_gain + 1);
+	check_gain(what, walk, find, UINT_MAX);
+	for (i = 0; i < nums; i++) {
+		g = sensor_again_lut[i].gain;
+		next = i + 1 < nums ? sensor_again_lut[i + 1].gain : g;
+		if (g)
+			check_gain(what, walk, find, g - 1);
+		check_gain(what, walk, find, g);
+		check_gain(what, walk, find, g + 1);
+		if (next > g)
+			check_gain(what, walk, find, g + (next - g) / 2);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	drv = argc > 1 ? argv[1] : "driver";
+	check_alloc("again", walk_alloc_again, sensor_alloc_again, sensor_attr.max_again);
+#ifdef HAS_SHORT
+	check_alloc("again_short", walk_alloc_again_short, sensor_alloc_again_short,
+		    sensor_attr.max_again_short);
+#endif
+	printf("%s: %d gains checked, %d mismatches\n", drv, checks, failures);
+	return failures ? 1 : 0;
+}
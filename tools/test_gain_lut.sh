@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# Check the gain LUT lookups of the drivers converted to
+# sensor_gain_lut_find() against the linear walks they replaced, on the
+# host. See test_gain_lut.c.
+#
+#   tools/test_gain_lut.sh
+#
+# HOSTCC picks the compiler, cc by default.
+
+set -e
+
+top=$(cd "$(dirname "$0")/.." && pwd)
+src=$top/3.10.14/sensor-src
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# the first ".name = value," of the driver's sensor_attr
+attr() {
+	awk -v key="$1" '
+		$1 == "." key || $1 == "." key "=" {
+			v = $0
+			sub(/^[^=]*=[ \t]*/, "", v)
+			sub(/[ \t]*,.*$/, "", v)
+			print v
+			exit
+		}' "$2"
+}
+
+for drv in t31/gc2053 t31/gc2093 t31/sc2336; do
+	c=$src/$drv.c
+	{
+		echo "/* Generated by tools/test_gain_lut.sh from $drv.c */"
+		echo "#define DRV_$(basename $drv)"
+		awk '/^static inline unsigned int sensor_gain_at\(/, /^}/
+		     /^static unsigned int sensor_gain_upper\(/, /^}/
+		     /^int sensor_gain_lut_find\(/, /^}/' $src/common/sensor-core.c
+		awk '/^#define SENSOR_GAIN_LUT_FIND\(/, /[^\\]$/' $src/include/sensor-core.h
+		awk '/^struct again_lut \{/, /^\};/
+		     /^struct again_lut sensor_again_lut\[\] = \{/, /^\};/' $c
+		echo "struct sensor_attr sensor_attr = {"
+		echo "	.max_again = $(attr max_again $c),"
+		max_short=$(attr max_again_short $c)
+		[ -z "$max_short" ] || echo "	.max_again_short = $max_short,"
+		echo "};"
+		awk '/^unsigned int sensor_alloc_again(_short)?\(/, /^}/' $c
+	} > "$tmp/gain_lut.h"
+	${HOSTCC:-cc} -Wall -O1 -I"$tmp" -o "$tmp/test_gain_lut" "$top/tools/test_gain_lut.c"
+	"$tmp/test_gain_lut" $drv
+done
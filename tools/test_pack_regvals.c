@@ -0,0 +1,148 @@
+/*
+ * Host check of tools/pack_regvals.sh, see test_pack_regvals.sh.
+ *
+ * Built once per driver. pack_tables.h is generated from the driver and
+ * holds its regval_list tables, compiled here as the driver compiles
+ * them, next to the packed arrays made from them. Every packed stream is
+ * decoded the way sensor_burst_write_packed() walks it and must give the
+ * writes and delays of its source table, in order, up to SENSOR_REG_END.
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#define __maybe_unused __attribute__((unused))
+
+#define PACKED_RUN	0x00
+#define PACKED_SKIP	0x40
+#define PACKED_ADDR	0x80
+#define PACKED_DELAY	0x81
+#define PACKED_END	0xff
+#define PACKED_LEN_MASK	0x3f
+
+struct pack_table {
+	const char *name;
+	const void *src;
+	unsigned int nums;
+	const unsigned char *packed;
+	unsigned int packed_size;
+};
+
+struct pack_op {
+	unsigned int reg;	/* PACK_OP_DELAY for a delay */
+	unsigned int value;
+};
+
+#define PACK_OP_DELAY	0x10000
+#define PACK_OPS_MAX	4096
+
+#include "pack_tables.h"
+
+static const char *drv;
+static int failures;
+
+static void report(const struct pack_table *t, const char *fmt, ...)
+{
+	va_list ap;
+
+	printf("%s %s: ", drv, t->name);
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	printf("\n");
+	failures++;
+}
+
+/* the writes and delays of a packed stream, -1 when it is malformed */
+static int decode(const struct pack_table *t, struct pack_op *ops)
+{
+	const unsigned char *p = t->packed;
+	const unsigned char *end = t->packed + t->packed_size;
+	unsigned int reg = 0;
+	int have_reg = 0;
+	int nums = 0;
+	int n;
+
+	while (p < end && *p != PACKED_END) {
+		if (nums >= PACK_OPS_MAX)
+			return -1;
+		if (*p == PACKED_ADDR) {
+			if (p + 1 + REG_BYTES > end)
+				return -1;
+			reg = REG_BYTES == 2 ? (p[1] << 8) | p[2] : p[1];
+			have_reg = 1;
+			p += 1 + REG_BYTES;
+		} else if (*p == PACKED_DELAY) {
+			if (p + 2 > end)
+				return -1;
+			ops[nums].reg = PACK_OP_DELAY;
+			ops[nums++].value = p[1];
+			p += 2;
+		} else if (*p & PACKED_ADDR) {
+			return -1;
+		} else if (*p & PACKED_SKIP) {
+			if (!have_reg)
+				return -1;
+			reg += (*p++ & PACKED_LEN_MASK) + 1;
+		} else {
+			if (!have_reg)
+				return -1;
+			n = (*p++ & PACKED_LEN_MASK) + 1;
+			if (p + n > end || nums + n > PACK_OPS_MAX)
+				return -1;
+			while (n--) {
+				ops[nums].reg = reg++;
+				ops[nums++].value = *p++;
+			}
+		}
+	}
+	/* the end marker is the last byte */
+	if (p + 1 != end)
+		return -1;
+	return nums;
+}
+
+static void check_table(const struct pack_table *t)
+{
+	static struct pack_op ops[PACK_OPS_MAX];
+	const struct regval_list *src = t->src;
+	unsigned int reg, value;
+	unsigned int i;
+	int nums, j = 0;
+
+	nums = decode(t, ops);
+	if (nums < 0) {
+		report(t, "malformed packed stream");
+		return;
+	}
+	for (i = 0; i < t->nums && src[i].reg_num != REG_END; i++) {
+		reg = src[i].reg_num == REG_DELAY ? PACK_OP_DELAY : src[i].reg_num;
+		value = src[i].value;
+		if (j >= nums) {
+			report(t, "entry %u missing from the packed stream", i);
+			return;
+		}
+		if (ops[j].reg != reg || ops[j].value != value) {
+			report(t, "entry %u {0x%x, 0x%x} packed as write %d {0x%x, 0x%x}",
+			       i, src[i].reg_num, value, j, ops[j].reg, ops[j].value);
+			return;
+		}
+		j++;
+	}
+	if (i == t->nums)
+		report(t, "no end marker in %u entries", i);
+	else if (j != nums)
+		report(t, "%u packed writes past the %u source entries", nums - j, j);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int i;
+
+	drv = argc > 1 ? argv[1] : "driver";
+	for (i = 0; i < sizeof(pack_tables) / sizeof(pack_tables[0]); i++)
+		check_table(&pack_tables[i]);
+	printf("%s: %u tables checked, %d mismatches\n", drv,
+	       (unsigned int)(sizeof(pack_tables) / sizeof(pack_tables[0])), failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+#!/bin/sh
+#
+# Check tools/pack_regvals.sh on the host: pack the tables of a driver,
+# decode the packed streams again and compare them with the source
+# tables as the C compiler sees them. See test_pack_regvals.c.
+#
+#   tools/test_pack_regvals.sh [driver.c ...]
+#
+# Without arguments every driver that includes its -packed.h is checked.
+# HOSTCC picks the compiler, cc by default.
+
+set -e
+
+top=$(cd "$(dirname "$0")/.." && pwd)
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+if [ $# -eq 0 ]; then
+	for c in "$top"/*/sensor-src/*/*.c; do
+		m=$(basename "$c" .c)
+		! grep -q "<$m-packed.h>" "$c" || set -- "$@" "$c"
+	done
+fi
+
+for c in "$@"; do
+	sh "$top/tools/pack_regvals.sh" "$c" > "$tmp/packed.h"
+	{
+		echo "/* Generated by tools/test_pack_regvals.sh from $c */"
+		tr -d '\r' < "$c" | awk '/^struct regval_list[ \t]*(\{|$)/, /^\};/'
+		tr -d '\r' < "$c" | awk '
+			/^#define[ \t]+[A-Za-z0-9_]*REG_(END|DELAY)[ \t]/ {
+				print
+				if ($2 ~ /REG_END$/)
+					end = $3
+				else
+					delay = $3
+			}
+			/^(static[ \t]+)?struct[ \t]+regval_list[ \t]+[A-Za-z0-9_]+[ \t]*\[\][^;]*=[ \t]*\{/, /^[ \t]*\}[ \t]*;/
+			END {
+				# a table without delays still needs a value no entry has
+				printf("#define REG_END %s\n#define REG_DELAY %s\n", end, delay != "" ? delay : "0x10000")
+				printf("#define REG_BYTES (REG_END > 0xff ? 2 : 1)\n")
+			}'
+		cat "$tmp/packed.h"
+		echo "static const struct pack_table pack_tables[] = {"
+		sed -n 's/^static const unsigned char \([A-Za-z0-9_]*\)_packed\[\].*/\1/p' "$tmp/packed.h" |
+		while read t; do
+			echo "	{ \"$t\", $t, sizeof($t) / sizeof($t[0]), ${t}_packed, sizeof(${t}_packed) },"
+		done
+		echo "};"
+	} > "$tmp/pack_tables.h"
+	${HOSTCC:-cc} -Wall -Wno-unused-variable -O1 -I"$tmp" -o "$tmp/test_pack_regvals" \
+		"$top/tools/test_pack_regvals.c"
+	"$tmp/test_pack_regvals" "${c#$top/}"
+done